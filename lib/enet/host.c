@@ -68,6 +68,27 @@ enet_host_create (const ENetAddress * address, size_t peerCount, size_t channelL
     if (address != NULL && enet_socket_get_address (host -> socket, & host -> address) < 0)   
       host -> address = * address;
 
+    /* Without batches datagrams are sent and received one by one */
+    if (enet_socket_batch_supported ())
+    {
+       host -> receiveBatch = (ENetSocketBatch *) enet_malloc (sizeof (ENetSocketBatch));
+       host -> sendBatch = (ENetSocketBatch *) enet_malloc (sizeof (ENetSocketBatch));
+       if (host -> receiveBatch == NULL || host -> sendBatch == NULL)
+       {
+          enet_free (host -> receiveBatch);
+          enet_free (host -> sendBatch);
+          host -> receiveBatch = NULL;
+          host -> sendBatch = NULL;
+       }
+       else
+       {
+          host -> receiveBatch -> count = 0;
+          host -> receiveBatch -> current = 0;
+          host -> sendBatch -> count = 0;
+          host -> sendBatch -> current = 0;
+       }
+    }
+
     if (! channelLimit || channelLimit > ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT)
       channelLimit = ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT;
     else
@@ -157,6 +178,8 @@ enet_host_destroy (ENetHost * host)
     if (host -> compressor.context != NULL && host -> compressor.destroy)
       (* host -> compressor.destroy) (host -> compressor.context);
 
+    enet_free (host -> receiveBatch);
+    enet_free (host -> sendBatch);
     enet_free (host -> peers);
     enet_free (host);
 }
@@ -346,6 +346,22 @@ typedef struct _ENetCompressor
    void (ENET_CALLBACK * destroy) (void * context);
 } ENetCompressor;
 
+enum
+{
+   ENET_SOCKET_BATCH_SIZE = 16
+};
+
+/** A batch of datagrams sent or received with a single system call, see
+    enet_socket_send_batch() and enet_socket_receive_batch(). */
+typedef struct _ENetSocketBatch
+{
+   size_t      count;                                 /**< number of datagrams in the batch */
+   size_t      current;                               /**< next received datagram to be handled */
+   ENetAddress addresses [ENET_SOCKET_BATCH_SIZE];    /**< address of each datagram */
+   size_t      lengths [ENET_SOCKET_BATCH_SIZE];      /**< length of each datagram */
+   enet_uint8  data [ENET_SOCKET_BATCH_SIZE][ENET_PROTOCOL_MAXIMUM_MTU];
+} ENetSocketBatch;
+
 /** Callback that computes the checksum of the data held in buffers[0:bufferCount-1] */
 typedef enet_uint32 (ENET_CALLBACK * ENetChecksumCallback) (const ENetBuffer * buffers, size_t bufferCount);
 
@@ -406,6 +422,8 @@ typedef struct _ENetHost
    size_t               duplicatePeers;              /**< optional number of allowed peers from duplicate IPs, defaults to ENET_PROTOCOL_MAXIMUM_PEER_ID */
    size_t               maximumPacketSize;           /**< the maximum allowable packet size that may be sent or received on a peer */
    size_t               maximumWaitingData;          /**< the maximum aggregate amount of buffer space a peer may use waiting for packets to be delivered */
+   ENetSocketBatch *    receiveBatch;                /**< datagrams received but not yet handled, NULL if batched socket I/O is not supported */
+   ENetSocketBatch *    sendBatch;                   /**< datagrams waiting to be sent, NULL if batched socket I/O is not supported */
 } ENetHost;
 
 /**
@@ -516,6 +534,9 @@ ENET_API int        enet_socket_get_option (ENetSocket, ENetSocketOption, int *)
 ENET_API int        enet_socket_shutdown (ENetSocket, ENetSocketShutdown);
 ENET_API void       enet_socket_destroy (ENetSocket);
 ENET_API int        enet_socketset_select (ENetSocket, ENetSocketSet *, ENetSocketSet *, enet_uint32);
+ENET_API int        enet_socket_batch_supported (void);
+ENET_API int        enet_socket_send_batch (ENetSocket, const ENetSocketBatch *);
+ENET_API int        enet_socket_receive_batch (ENetSocket, ENetSocketBatch *);
 
 /** @} */
 
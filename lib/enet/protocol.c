@@ -1202,13 +1202,13 @@ commandError:
 }
  
 static int
-enet_protocol_receive_incoming_commands (ENetHost * host, ENetEvent * event)
+enet_protocol_receive_datagram (ENetHost * host)
 {
-    int packets;
+    ENetSocketBatch * batch = host -> receiveBatch;
+    int receivedLength;
 
-    for (packets = 0; packets < 256; ++ packets)
+    if (batch == NULL)
     {
-       int receivedLength;
        ENetBuffer buffer;
 
        buffer.data = host -> packetData [0];
@@ -1218,6 +1218,37 @@ enet_protocol_receive_incoming_commands (ENetHost * host, ENetEvent * event)
                                              & host -> receivedAddress,
                                              & buffer,
                                              1);
+       if (receivedLength > 0)
+         host -> receivedData = host -> packetData [0];
+
+       return receivedLength;
+    }
+
+    /* Datagrams left in the batch when an event was returned are handled
+       before the socket is read again */
+    if (batch -> current >= batch -> count)
+    {
+       receivedLength = enet_socket_receive_batch (host -> socket, batch);
+       if (receivedLength <= 0)
+         return receivedLength;
+    }
+
+    host -> receivedAddress = batch -> addresses [batch -> current];
+    host -> receivedData = batch -> data [batch -> current];
+    receivedLength = (int) batch -> lengths [batch -> current];
+    ++ batch -> current;
+
+    return receivedLength;
+}
+
+static int
+enet_protocol_receive_incoming_commands (ENetHost * host, ENetEvent * event)
+{
+    int packets;
+
+    for (packets = 0; packets < 256; ++ packets)
+    {
+       int receivedLength = enet_protocol_receive_datagram (host);
 
        if (receivedLength < 0)
          return -1;
@@ -1225,7 +1256,6 @@ enet_protocol_receive_incoming_commands (ENetHost * host, ENetEvent * event)
        if (receivedLength == 0)
          return 0;
 
-       host -> receivedData = host -> packetData [0];
        host -> receivedDataLength = receivedLength;
       
        host -> totalReceivedData += receivedLength;
@@ -1598,7 +1628,62 @@ enet_protocol_send_reliable_outgoing_commands (ENetHost * host, ENetPeer * peer)
 }
 
 static int
-enet_protocol_send_outgoing_commands (ENetHost * host, ENetEvent * event, int checkForTimeouts)
+enet_protocol_flush_send_batch (ENetHost * host)
+{
+    ENetSocketBatch * batch = host -> sendBatch;
+    int sentLength;
+
+    if (batch == NULL || batch -> count == 0)
+      return 0;
+
+    sentLength = enet_socket_send_batch (host -> socket, batch);
+    batch -> count = 0;
+
+    if (sentLength < 0)
+      return -1;
+
+    host -> totalSentData += sentLength;
+    return 0;
+}
+
+static int
+enet_protocol_send_datagram (ENetHost * host, ENetPeer * peer)
+{
+    ENetSocketBatch * batch = host -> sendBatch;
+    enet_uint8 * data;
+    size_t i;
+
+    if (batch == NULL)
+    {
+       int sentLength = enet_socket_send (host -> socket, & peer -> address, host -> buffers, host -> bufferCount);
+       if (sentLength < 0)
+         return -1;
+
+       host -> totalSentData += sentLength;
+       return 0;
+    }
+
+    /* The buffers point to data which is reused for the next peer or freed
+       after this, so the datagram is copied */
+    if (batch -> count == ENET_SOCKET_BATCH_SIZE && enet_protocol_flush_send_batch (host) < 0)
+      return -1;
+
+    data = batch -> data [batch -> count];
+    batch -> lengths [batch -> count] = 0;
+    for (i = 0; i < host -> bufferCount; ++ i)
+    {
+       memcpy (data, host -> buffers [i].data, host -> buffers [i].dataLength);
+       data += host -> buffers [i].dataLength;
+       batch -> lengths [batch -> count] += host -> buffers [i].dataLength;
+    }
+    batch -> addresses [batch -> count] = peer -> address;
+    ++ batch -> count;
+
+    return 0;
+}
+
+static int
+enet_protocol_queue_outgoing_commands (ENetHost * host, ENetEvent * event, int checkForTimeouts)
 {
     enet_uint8 headerData [sizeof (ENetProtocolHeader) + sizeof (enet_uint32)];
     ENetProtocolHeader * header = (ENetProtocolHeader *) headerData;
@@ -1732,20 +1817,33 @@ enet_protocol_send_outgoing_commands (ENetHost * host, ENetEvent * event, int ch
 
         currentPeer -> lastSendTime = host -> serviceTime;
 
-        sentLength = enet_socket_send (host -> socket, & currentPeer -> address, host -> buffers, host -> bufferCount);
+        sentLength = enet_protocol_send_datagram (host, currentPeer);
 
         enet_protocol_remove_sent_unreliable_commands (currentPeer);
 
         if (sentLength < 0)
           return -1;
 
-        host -> totalSentData += sentLength;
         host -> totalSentPackets ++;
     }
    
     return 0;
 }
 
+/** Sends the queued commands of all peers. With batched socket I/O the
+    datagrams of all peers are collected first and then sent together.
+*/
+static int
+enet_protocol_send_outgoing_commands (ENetHost * host, ENetEvent * event, int checkForTimeouts)
+{
+    int result = enet_protocol_queue_outgoing_commands (host, event, checkForTimeouts);
+
+    if (enet_protocol_flush_send_batch (host) < 0)
+      return -1;
+
+    return result;
+}
+
 /** Sends any queued packets on the host specified to its designated peers.
 
     @param host   host to flush
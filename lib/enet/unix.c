@@ -4,6 +4,10 @@
 */
 #ifndef _WIN32
 
+#ifdef HAS_MMSG
+#define _GNU_SOURCE
+#endif
+
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
@@ -481,6 +485,59 @@ enet_socket_destroy (ENetSocket socket)
       close (socket);
 }
 
+static socklen_t
+enet_address_to_sockaddr (const ENetAddress * address, struct sockaddr_storage * sin)
+{
+    memset (sin, 0, sizeof (struct sockaddr_storage));
+
+    if (isIPv6Socket() == 1)
+    {
+        struct sockaddr_in6 * v6 = (struct sockaddr_in6 *) sin;
+        v6 -> sin6_family = AF_INET6;
+        v6 -> sin6_port = ENET_HOST_TO_NET_16 (address -> port);
+        memcpy (v6 -> sin6_addr.s6_addr, & address -> host.p0, 16);
+        v6 -> sin6_scope_id = address -> host.p4;
+
+        return sizeof (struct sockaddr_in6);
+    }
+    else
+    {
+        struct sockaddr_in * v4 = (struct sockaddr_in *) sin;
+        v4 -> sin_family = AF_INET;
+        v4 -> sin_port = ENET_HOST_TO_NET_16 (address -> port);
+        v4 -> sin_addr.s_addr = address -> host.p0;
+
+        return sizeof (struct sockaddr_in);
+    }
+}
+
+static int
+enet_address_from_sockaddr (ENetAddress * address, const struct sockaddr_storage * sin)
+{
+    switch (sin -> ss_family)
+    {
+    case AF_INET:
+        // Should not happen if dual stack is working
+        if (isIPv6Socket() == 1)
+            return -1;
+        const struct sockaddr_in * v4 = (const struct sockaddr_in *) sin;
+        address -> host.p0 = (enet_uint32) v4 -> sin_addr.s_addr;
+        address -> port = ENET_NET_TO_HOST_16 (v4->sin_port);
+        break;
+    case AF_INET6:
+        if (isIPv6Socket() != 1)
+        return -1;
+        const struct sockaddr_in6 * v6 = (const struct sockaddr_in6 *) sin;
+        memcpy (& address -> host.p0, v6 -> sin6_addr.s6_addr, 16);
+        address -> host.p4 = v6 -> sin6_scope_id;
+        address -> port = ENET_NET_TO_HOST_16 (v6 -> sin6_port);
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
+
 int
 enet_socket_send (ENetSocket socket,
                   const ENetAddress * address,
@@ -489,34 +546,14 @@ enet_socket_send (ENetSocket socket,
 {
     struct msghdr msgHdr;
     struct sockaddr_storage sin;
-    memset (& sin, 0, sizeof (sin));
     int sentLength;
 
     memset (& msgHdr, 0, sizeof (struct msghdr));
 
     if (address != NULL)
     {
-        if (isIPv6Socket() == 1)
-        {
-            struct sockaddr_in6 * v6 = (struct sockaddr_in6 *) & sin;
-            v6 -> sin6_family = AF_INET6;
-            v6 -> sin6_port = ENET_HOST_TO_NET_16 (address -> port);
-            memcpy (v6 -> sin6_addr.s6_addr, & address -> host.p0, 16);
-            v6 -> sin6_scope_id = address -> host.p4;
-
-            msgHdr.msg_name = & sin;
-            msgHdr.msg_namelen = sizeof (struct sockaddr_in6);
-        }
-        else
-        {
-            struct sockaddr_in * v4 = (struct sockaddr_in *) & sin;
-            v4 -> sin_family = AF_INET;
-            v4 -> sin_port = ENET_HOST_TO_NET_16 (address -> port);
-            v4 -> sin_addr.s_addr = address -> host.p0;
-
-            msgHdr.msg_name = & sin;
-            msgHdr.msg_namelen = sizeof (struct sockaddr_in);
-        }
+        msgHdr.msg_name = & sin;
+        msgHdr.msg_namelen = enet_address_to_sockaddr (address, & sin);
     }
 
     msgHdr.msg_iov = (struct iovec *) buffers;
@@ -572,32 +609,134 @@ enet_socket_receive (ENetSocket socket,
       return -1;
 #endif
 
-    if (address != NULL)
+    if (address != NULL && enet_address_from_sockaddr (address, & sin) < 0)
+      return -1;
+
+    return recvLength;
+}
+
+int
+enet_socket_batch_supported (void)
+{
+#ifdef HAS_MMSG
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/** Sends all datagrams of the batch with as few system calls as possible.
+    Like with enet_socket_send, a datagram which can't be sent is dropped,
+    and the datagrams after it are still sent.
+    @returns the number of bytes sent, or -1 if any datagram failed with an error
+*/
+int
+enet_socket_send_batch (ENetSocket socket, const ENetSocketBatch * batch)
+{
+#ifdef HAS_MMSG
+    struct mmsghdr msgHdrs [ENET_SOCKET_BATCH_SIZE];
+    struct iovec iovecs [ENET_SOCKET_BATCH_SIZE];
+    struct sockaddr_storage sins [ENET_SOCKET_BATCH_SIZE];
+    size_t i, sent = 0;
+    int sentLength = 0, error = 0;
+
+    memset (msgHdrs, 0, sizeof (struct mmsghdr) * batch -> count);
+    for (i = 0; i < batch -> count; ++ i)
     {
-        switch (sin.ss_family)
+        iovecs [i].iov_base = (void *) batch -> data [i];
+        iovecs [i].iov_len = batch -> lengths [i];
+        msgHdrs [i].msg_hdr.msg_name = & sins [i];
+        msgHdrs [i].msg_hdr.msg_namelen = enet_address_to_sockaddr (& batch -> addresses [i], & sins [i]);
+        msgHdrs [i].msg_hdr.msg_iov = & iovecs [i];
+        msgHdrs [i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (sent < batch -> count)
+    {
+        int result = sendmmsg (socket, & msgHdrs [sent], batch -> count - sent, MSG_NOSIGNAL);
+        if (result == -1)
         {
-        case AF_INET:
-            // Should not happen if dual stack is working
-            if (isIPv6Socket() == 1)
-                return -1;
-            struct sockaddr_in * v4 = (struct sockaddr_in *) & sin;
-            address -> host.p0 = (enet_uint32) v4 -> sin_addr.s_addr;
-            address -> port = ENET_NET_TO_HOST_16 (v4->sin_port);
-            break;
-        case AF_INET6:
-            if (isIPv6Socket() != 1)
-            return -1;
-            struct sockaddr_in6 * v6 = (struct sockaddr_in6 *) & sin;
-            memcpy (& address -> host.p0, v6 -> sin6_addr.s6_addr, 16);
-            address -> host.p4 = v6 -> sin6_scope_id;
-            address -> port = ENET_NET_TO_HOST_16 (v6 -> sin6_port);
-            break;
-        default:
-            return -1;
+           if (errno == EINTR)
+             continue;
+
+           /* Only the first datagram failed, skip it */
+           if (errno != EWOULDBLOCK)
+             error = 1;
+           ++ sent;
+           continue;
         }
+
+        for (i = sent; i < sent + result; ++ i)
+          sentLength += (int) msgHdrs [i].msg_len;
+        sent += result;
     }
 
-    return recvLength;
+    return error ? -1 : sentLength;
+#else
+    return -1;
+#endif
+}
+
+/** Receives as many datagrams as are available and fit into the batch with
+    a single system call, the batch is reset before. Invalid datagrams are
+    dropped, the valid ones after them are kept.
+    @returns the number of datagrams received, 0 if there was none, or -1 on error
+*/
+int
+enet_socket_receive_batch (ENetSocket socket, ENetSocketBatch * batch)
+{
+#ifdef HAS_MMSG
+    struct mmsghdr msgHdrs [ENET_SOCKET_BATCH_SIZE];
+    struct iovec iovecs [ENET_SOCKET_BATCH_SIZE];
+    struct sockaddr_storage sins [ENET_SOCKET_BATCH_SIZE];
+    int i, recvCount, validCount = 0;
+
+    batch -> count = 0;
+    batch -> current = 0;
+
+    memset (msgHdrs, 0, sizeof (msgHdrs));
+    for (i = 0; i < ENET_SOCKET_BATCH_SIZE; ++ i)
+    {
+        iovecs [i].iov_base = batch -> data [i];
+        iovecs [i].iov_len = sizeof (batch -> data [i]);
+        msgHdrs [i].msg_hdr.msg_name = & sins [i];
+        msgHdrs [i].msg_hdr.msg_namelen = sizeof (sins [i]);
+        msgHdrs [i].msg_hdr.msg_iov = & iovecs [i];
+        msgHdrs [i].msg_hdr.msg_iovlen = 1;
+    }
+
+    recvCount = recvmmsg (socket, msgHdrs, ENET_SOCKET_BATCH_SIZE, MSG_NOSIGNAL, NULL);
+
+    if (recvCount == -1)
+    {
+       if (errno == EWOULDBLOCK)
+         return 0;
+
+       return -1;
+    }
+
+    /* enet_socket_receive returns an error for an invalid datagram, here
+       it is dropped and the following datagrams are moved in its place */
+    for (i = 0; i < recvCount; ++ i)
+    {
+        if ((msgHdrs [i].msg_hdr.msg_flags & MSG_TRUNC) ||
+            enet_address_from_sockaddr (& batch -> addresses [validCount], & sins [i]) < 0)
+          continue;
+
+        if (validCount != i)
+          memcpy (batch -> data [validCount], batch -> data [i], msgHdrs [i].msg_len);
+        batch -> lengths [validCount] = msgHdrs [i].msg_len;
+        ++ validCount;
+    }
+
+    if (validCount == 0)
+      return -1;
+
+    batch -> count = validCount;
+    return validCount;
+#else
+    return -1;
+#endif
 }
 
 int
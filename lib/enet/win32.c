@@ -481,6 +481,24 @@ enet_socket_receive (ENetSocket socket,
     return (int) recvLength;
 }
 
+int
+enet_socket_batch_supported (void)
+{
+    return 0;
+}
+
+int
+enet_socket_send_batch (ENetSocket socket, const ENetSocketBatch * batch)
+{
+    return -1;
+}
+
+int
+enet_socket_receive_batch (ENetSocket socket, ENetSocketBatch * batch)
+{
+    return -1;
+}
+
 int
 enet_socketset_select (ENetSocket maxSocket, ENetSocketSet * readSet, ENetSocketSet * writeSet, enet_uint32 timeout)
 {
@@ -29,6 +29,7 @@
 #include <matrix4.h>
 #include <quaternion.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstdlib>
@@ -50,11 +51,20 @@ struct LocRotScale
     // ------------------------------------------------------------------------
     inline core::matrix4 toMatrix() const
     {
-        core::matrix4 lm, sm, rm;
-        lm.setTranslation(m_loc);
-        sm.setScale(m_scale);
-        m_rot.getMatrix(rm);
-        return lm * rm * sm;
+        // Same as translation * rotation * scale matrix, without the two
+        // matrix multiplications
+        core::matrix4 m(core::matrix4::EM4CONST_NOTHING);
+        m_rot.getMatrix(m, m_loc);
+        m[0] *= m_scale.X;
+        m[1] *= m_scale.X;
+        m[2] *= m_scale.X;
+        m[4] *= m_scale.Y;
+        m[5] *= m_scale.Y;
+        m[6] *= m_scale.Y;
+        m[8] *= m_scale.Z;
+        m[9] *= m_scale.Z;
+        m[10] *= m_scale.Z;
+        return m;
     }
     // ------------------------------------------------------------------------
     void read(irr::io::IReadFile* spm)
@@ -85,6 +95,24 @@ struct Armature
     std::vector<std::pair<int, std::vector<LocRotScale> > >
         m_frame_pose_matrices;
 
+    /** Interpolated matrices of the second frame when blending two frames,
+     *  kept to avoid allocations in getPose. */
+    std::vector<LocRotScale> m_blend_matrices;
+
+    /** The arguments and result of the last getPose call. Kart models share
+     *  their armature, and karts of the same type often use the same frame
+     *  (e.g. when driving straight), so the pose can be reused. */
+    float m_cached_frame, m_cached_frame_interpolating, m_cached_rate;
+
+    std::vector<core::matrix4> m_cached_pose;
+
+    // ------------------------------------------------------------------------
+    Armature()
+    {
+        m_joint_used = 0;
+        m_cached_frame = m_cached_frame_interpolating = m_cached_rate = -1.0f;
+    }
+
     // ------------------------------------------------------------------------
     void read(irr::io::IReadFile* spm)
     {
@@ -147,11 +175,21 @@ struct Armature
     void getPose(float frame, core::matrix4* dest,
                  float frame_interpolating = -1.0f, float rate = -1.0f)
     {
+        if (m_cached_pose.size() == m_joint_used &&
+            m_cached_frame == frame &&
+            m_cached_frame_interpolating == frame_interpolating &&
+            m_cached_rate == rate)
+        {
+            std::copy(m_cached_pose.begin(), m_cached_pose.end(), dest);
+            return;
+        }
         getInterpolatedMatrices(frame);
         if (frame_interpolating != -1.0f && rate != -1.0f)
         {
-            auto copied = m_interpolated_matrices;
+            m_blend_matrices.swap(m_interpolated_matrices);
+            m_interpolated_matrices.resize(m_blend_matrices.size());
             getInterpolatedMatrices(frame_interpolating);
+            const std::vector<LocRotScale>& copied = m_blend_matrices;
             for (unsigned i = 0; i < m_interpolated_matrices.size(); i++)
             {
                 m_interpolated_matrices[i].m_loc =
@@ -174,6 +212,10 @@ struct Armature
             dest[i] = getWorldMatrix(m_interpolated_matrices, i) *
                 m_joint_matrices[i];
         }
+        m_cached_pose.assign(dest, dest + m_joint_used);
+        m_cached_frame = frame;
+        m_cached_frame_interpolating = frame_interpolating;
+        m_cached_rate = rate;
     }
     // ------------------------------------------------------------------------
     void getPose(core::matrix4* dest, float frame)
@@ -204,26 +246,22 @@ struct Armature
             }
             return;
         }
-        int frame_1 = -1;
-        int frame_2 = -1;
-        float interpolation = 0.0f;
-        for (unsigned i = 0; i < m_frame_pose_matrices.size(); i++)
-        {
-            assert(i + 1 < m_frame_pose_matrices.size());
-            if (frame >= float(m_frame_pose_matrices[i].first) &&
-                frame < float(m_frame_pose_matrices[i + 1].first))
+        // Binary search for the first key frame after frame, the frame
+        // indices are sorted
+        auto next = std::upper_bound(m_frame_pose_matrices.begin(),
+            m_frame_pose_matrices.end(), frame,
+            [](float f, const std::pair<int, std::vector<LocRotScale> >& p)
             {
-                frame_1 = i;
-                frame_2 = i + 1;
-                interpolation =
-                    (frame - float(m_frame_pose_matrices[i].first)) /
-                    float(m_frame_pose_matrices[i + 1].first -
-                    m_frame_pose_matrices[i].first);
-                break;
-            }
-        }
-        assert(frame_1 != -1);
-        assert(frame_2 != -1);
+                return f < float(p.first);
+            });
+        assert(next != m_frame_pose_matrices.begin() &&
+            next != m_frame_pose_matrices.end());
+        const int frame_2 = int(next - m_frame_pose_matrices.begin());
+        const int frame_1 = frame_2 - 1;
+        const float interpolation =
+            (frame - float(m_frame_pose_matrices[frame_1].first)) /
+            float(m_frame_pose_matrices[frame_2].first -
+            m_frame_pose_matrices[frame_1].first);
         for (unsigned i = 0; i < m_interpolated_matrices.size(); i++)
         {
             LocRotScale interpolated;
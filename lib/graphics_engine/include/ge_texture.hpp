@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 #include <ITexture.h>
 #include <IImage.h>
 #include <IReadFile.h>
@@ -29,6 +30,8 @@ irr::video::IImage* getResizedImage(irr::io::IReadFile* file,
                    const irr::core::dimension2d<irr::u32>* target_size = NULL);
 irr::video::ITexture* createTexture(const std::string& path,
     std::function<void(irr::video::IImage*)> image_mani = nullptr);
+void prefetchImages(const std::vector<std::string>& paths);
+void clearPrefetchedImages();
 };   // GE
 
 #endif
@@ -5,15 +5,152 @@
 #include "ge_texture.hpp"
 
 #include <IFileSystem.h>
+#include <IImageLoader.h>
 #include <IVideoDriver.h>
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
 namespace GE
 {
 using namespace irr;
+namespace
+{
+/** Images decoded by prefetchImages which were not used by a texture yet,
+ *  indexed by their path. */
+std::map<std::string, video::IImage*> g_prefetched_images;
+std::mutex g_prefetched_images_mutex;
+
+// ----------------------------------------------------------------------------
+/** Returns the prefetched image for a path (and removes it from the list of
+ *  prefetched images), or NULL if it was not prefetched. */
+video::IImage* takePrefetchedImage(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(g_prefetched_images_mutex);
+    auto it = g_prefetched_images.find(path);
+    if (it == g_prefetched_images.end())
+        return NULL;
+    video::IImage* image = it->second;
+    g_prefetched_images.erase(it);
+    return image;
+}   // takePrefetchedImage
+
+// ----------------------------------------------------------------------------
+video::IImage* resizeImage(video::IImage* image,
+                           const core::dimension2du& max_size,
+                           core::dimension2d<u32>* orig_size,
+                           const core::dimension2d<u32>* target_size)
+{
+    if (orig_size)
+        *orig_size = image->getDimension();
+
+    core::dimension2du img_size = image->getDimension();
+    core::dimension2du tex_size;
+    if (target_size)
+        tex_size = *target_size;
+    else
+        tex_size = getResizingTarget(img_size, max_size);
+
+    if (image->getColorFormat() != video::ECF_A8R8G8B8 ||
+        tex_size != img_size)
+    {
+        video::IImage* new_texture = getDriver()->createImage(
+            video::ECF_A8R8G8B8, tex_size);
+        if (tex_size != img_size)
+            image->copyToScaling(new_texture);
+        else
+            image->copyTo(new_texture);
+        image->drop();
+        return new_texture;
+    }
+
+    return image;
+}   // resizeImage
+
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Decodes the images with the given (full) paths in parallel, so that
+ *  textures created from them later don't need to decode them in the calling
+ *  thread. This blocks until all images are decoded. Images which are not
+ *  used by a texture are kept until clearPrefetchedImages is called.
+ *  \param paths Full paths of the images.
+ */
+void prefetchImages(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> todo;
+    {
+        std::lock_guard<std::mutex> lock(g_prefetched_images_mutex);
+        for (const std::string& path : paths)
+        {
+            if (g_prefetched_images.find(path) == g_prefetched_images.end() &&
+                std::find(todo.begin(), todo.end(), path) == todo.end())
+                todo.push_back(path);
+        }
+    }
+    if (todo.empty())
+        return;
+
+    std::vector<video::IImage*> images(todo.size(), NULL);
+    std::atomic<unsigned> next(0);
+    auto decode = [&todo, &images, &next]()
+    {
+        unsigned i;
+        while ((i = next.fetch_add(1)) < todo.size())
+        {
+            video::IImageLoader* loader =
+                getDriver()->getImageLoaderForFile(todo[i].c_str());
+            if (loader == NULL)
+                continue;
+            io::IReadFile* file = io::createReadFile(todo[i].c_str());
+            if (file == NULL)
+                continue;
+            images[i] = loader->loadImage(file);
+            file->drop();
+        }
+    };
+    unsigned thread_count = std::min((unsigned)todo.size(),
+        std::max(std::thread::hardware_concurrency(), 1u));
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < thread_count; i++)
+        threads.emplace_back(decode);
+    decode();
+    for (std::thread& t : threads)
+        t.join();
+
+    std::lock_guard<std::mutex> lock(g_prefetched_images_mutex);
+    for (unsigned i = 0; i < todo.size(); i++)
+    {
+        if (!images[i])
+            continue;
+        auto ret = g_prefetched_images.insert(std::make_pair(todo[i],
+            images[i]));
+        if (!ret.second)
+            images[i]->drop();
+    }
+}   // prefetchImages
+
+// ----------------------------------------------------------------------------
+/** Frees all prefetched images which were not used by a texture. */
+void clearPrefetchedImages()
+{
+    std::lock_guard<std::mutex> lock(g_prefetched_images_mutex);
+    for (auto& p : g_prefetched_images)
+        p.second->drop();
+    g_prefetched_images.clear();
+}   // clearPrefetchedImages
+
+// ----------------------------------------------------------------------------
 video::IImage* getResizedImage(const std::string& path,
                                const core::dimension2du& max_size,
                                core::dimension2d<u32>* orig_size)
 {
+    video::IImage* prefetched = takePrefetchedImage(path);
+    if (prefetched)
+        return resizeImage(prefetched, max_size, orig_size, NULL);
     io::IReadFile* file =
         getDriver()->getFileSystem()->createAndOpenFile(path.c_str());
     if (file == NULL)
@@ -44,6 +181,9 @@ video::IImage* getResizedImageFullPath(const io::path& fullpath,
                                        core::dimension2d<u32>* orig_size,
                                      const core::dimension2d<u32>* target_size)
 {
+    video::IImage* prefetched = takePrefetchedImage(fullpath.c_str());
+    if (prefetched)
+        return resizeImage(prefetched, max_size, orig_size, target_size);
     io::IReadFile* file = io::createReadFile(fullpath);
     if (file == NULL)
         return NULL;
@@ -62,30 +202,7 @@ video::IImage* getResizedImage(irr::io::IReadFile* file,
     video::IImage* image = getDriver()->createImageFromFile(file);
     if (image == NULL)
         return NULL;
-    if (orig_size)
-        *orig_size = image->getDimension();
-
-    core::dimension2du img_size = image->getDimension();
-    core::dimension2du tex_size;
-    if (target_size)
-        tex_size = *target_size;
-    else
-        tex_size = getResizingTarget(img_size, max_size);
-
-    if (image->getColorFormat() != video::ECF_A8R8G8B8 ||
-        tex_size != img_size)
-    {
-        video::IImage* new_texture = getDriver()->createImage(
-            video::ECF_A8R8G8B8, tex_size);
-        if (tex_size != img_size)
-            image->copyToScaling(new_texture);
-        else
-            image->copyTo(new_texture);
-        image->drop();
-        return new_texture;
-    }
-
-    return image;
+    return resizeImage(image, max_size, orig_size, target_size);
 }   // getResizedImage
 
 // ----------------------------------------------------------------------------
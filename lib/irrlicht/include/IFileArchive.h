@@ -45,6 +45,9 @@ enum E_FILE_ARCHIVE_TYPE
 	//! A wad Archive, Quake2, Halflife
 	EFAT_WAD     = MAKE_IRR_ID('W','A','D', 0),
 
+	//! A SuperTuxKart asset pack
+	EFAT_STKPACK = MAKE_IRR_ID('S','T','K','P'),
+
     //! An Android asset file archive
     EFAT_ANDROID_ASSET = MAKE_IRR_ID('A','S','S','E'),
 
@@ -54,7 +54,7 @@ namespace scene
 				Parent(0), SceneManager(mgr), TriangleSelector(0), ID(id),
 				AutomaticCullingState(EAC_BOX), DebugDataVisible(EDS_OFF),
 				IsVisible(true), IsDebugObject(false),
-				NeedsUpdateAbsTrans(true), UpdatedAbsTrans(false)
+				NeedsUpdateAbsTrans(true), UpdatedAbsTrans(false), IsStatic(false)
 		{
 			if (parent)
 				parent->addChild(this);
@@ -113,6 +113,15 @@ namespace scene
 		{
 			if (IsVisible)
 			{
+				// skip static subtrees whose transformation did not change,
+				// see setStatic()
+				if (IsStatic && !NeedsUpdateAbsTrans && Animators.empty() &&
+					!(Parent && Parent->UpdatedAbsTrans))
+				{
+					UpdatedAbsTrans = false;
+					return;
+				}
+
 				// animate this node with all animators
 
 				ISceneNodeAnimatorList::Iterator ait = Animators.begin();
@@ -304,6 +313,13 @@ namespace scene
 				child->remove(); // remove from old parent
 				Children.push_back(child);
 				child->Parent = this;
+
+				// a static node can only have static children
+				if (!child->IsStatic)
+					clearStatic();
+				// make sure the new child is animated once
+				else if (IsStatic)
+					NeedsUpdateAbsTrans = true;
 			}
 		}
 
@@ -364,6 +380,7 @@ namespace scene
 			{
 				Animators.push_back(animator);
 				animator->grab();
+				clearStatic();
 			}
 		}
 
@@ -484,6 +501,7 @@ namespace scene
 				return;
 			RelativeScale = scale;
 			NeedsUpdateAbsTrans = true;
+			updateStaticParents();
 		}
 
 
@@ -507,6 +525,7 @@ namespace scene
 				return;
 			RelativeRotation = rotation;
 			NeedsUpdateAbsTrans = true;
+			updateStaticParents();
 		}
 
 
@@ -529,6 +548,7 @@ namespace scene
 				return;
 			RelativeTranslation = newpos;
 			NeedsUpdateAbsTrans = true;
+			updateStaticParents();
 		}
 
 
@@ -787,15 +807,53 @@ namespace scene
 		/** \return The node's scene manager. */
 		virtual ISceneManager* getSceneManager(void) const { return SceneManager; }
 
+		//! Marks this node as static.
+		/** OnAnimate skips a static node and all its children while no
+		transformation in this subtree changed. A node is only static if
+		it has no animators and all its children are static, so the flag
+		is not set otherwise, and it is cleared on this node and its parents
+		when a non static child or an animator is added later. */
+		void setStatic(bool val)
+		{
+			IsStatic = val && Animators.empty();
+			for (u32 i = 0; IsStatic && i < Children.size(); ++i)
+				IsStatic = Children[i]->IsStatic;
+			if (!IsStatic)
+				clearStatic();
+			NeedsUpdateAbsTrans = true;
+		}
+		bool isStatic() const { return IsStatic; }
+
 		//! STK addition to optimize updateAbsolutePosition, only do that if changed transformation.
 		bool getNeedsUpdateAbsTrans() const { return NeedsUpdateAbsTrans; }
 		bool getUpdatedAbsTrans() const { return UpdatedAbsTrans; }
-		void setNeedsUpdateAbsTrans(bool val) { NeedsUpdateAbsTrans = val; }
+		void setNeedsUpdateAbsTrans(bool val)
+		{
+			NeedsUpdateAbsTrans = val;
+			if (val)
+				updateStaticParents();
+		}
 		void setUpdatedAbsTrans(bool val) { UpdatedAbsTrans = val; }
 		virtual void resetFirstRenderInfo(std::shared_ptr<GE::GERenderInfo> ri) {}
 
 	protected:
 
+		//! Clears the static flag of this node and of its static parents.
+		void clearStatic()
+		{
+			IsStatic = false;
+			for (ISceneNode* p = Parent; p && p->IsStatic; p = p->Parent)
+				p->IsStatic = false;
+		}
+
+		//! Makes sure OnAnimate does not skip this node because of a static
+		//! parent after its transformation was changed.
+		void updateStaticParents()
+		{
+			for (ISceneNode* p = Parent; p && p->IsStatic; p = p->Parent)
+				p->NeedsUpdateAbsTrans = true;
+		}
+
 		//! A clone function for the ISceneNode members.
 		/** This method can be used by clone() implementations of
 		derived classes
@@ -816,6 +874,7 @@ namespace scene
 			IsDebugObject = toCopyFrom->IsDebugObject;
 			NeedsUpdateAbsTrans = true;
 			UpdatedAbsTrans = false;
+			IsStatic = toCopyFrom->IsStatic;
 
 			if (newManager)
 				SceneManager = newManager;
@@ -897,6 +956,9 @@ namespace scene
 		bool IsDebugObject;
 
 		bool NeedsUpdateAbsTrans, UpdatedAbsTrans;
+
+		//! Is the node and its subtree static, see setStatic()
+		bool IsStatic;
 	};
 
 
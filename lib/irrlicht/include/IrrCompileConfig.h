@@ -406,6 +406,11 @@ defined. */
 #ifdef NO__IRR_COMPILE_WITH_WAD_ARCHIVE_LOADER_
 #undef __IRR_COMPILE_WITH_WAD_ARCHIVE_LOADER_
 #endif
+//! Define __IRR_COMPILE_WITH_STKPACK_ARCHIVE_LOADER_ if you want to open SuperTuxKart asset packs
+#define __IRR_COMPILE_WITH_STKPACK_ARCHIVE_LOADER_
+#ifdef NO__IRR_COMPILE_WITH_STKPACK_ARCHIVE_LOADER_
+#undef __IRR_COMPILE_WITH_STKPACK_ARCHIVE_LOADER_
+#endif
 
 //! Set FPU settings
 /** Irrlicht should use approximate float and integer fpu techniques
@@ -10,6 +10,7 @@
 #include "CZipReader.h"
 #include "CMountPointReader.h"
 #include "CTarReader.h"
+#include "CSTKPackReader.h"
 #include "CFileList.h"
 #include "CXMLReader.h"
 #include "CXMLWriter.h"
@@ -70,6 +71,10 @@ CFileSystem::CFileSystem()
 	ArchiveLoader.push_back(new CArchiveLoaderZIP(this));
 #endif
 
+#ifdef __IRR_COMPILE_WITH_STKPACK_ARCHIVE_LOADER_
+	ArchiveLoader.push_back(new CArchiveLoaderSTKPack(this));
+#endif
+
 }
 
 
@@ -0,0 +1,353 @@
+// Copyright (C) 2026 SuperTuxKart-Team
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CSTKPackReader.h"
+
+#ifdef __IRR_COMPILE_WITH_STKPACK_ARCHIVE_LOADER_
+
+#include "CMemoryFile.h"
+#include "os.h"
+#include "coreutil.h"
+
+#include <string.h>
+
+#if !defined(_IRR_WINDOWS_API_) && !defined(__SWITCH__)
+#define STKPACK_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace irr
+{
+namespace io
+{
+
+namespace
+{
+	const c8 STKPACK_MAGIC[8] = { 'S', 'T', 'K', 'P', 'A', 'C', 'K', '1' };
+	const u32 STKPACK_VERSION = 1;
+
+	inline u32 readU32(const u8* p)
+	{
+		return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) |
+			((u32)p[3] << 24);
+	}
+
+	inline u16 readU16(const u8* p)
+	{
+		return (u16)(p[0] | (p[1] << 8));
+	}
+}
+
+//! The content of a pack. It is shared by the pack and all files opened from
+//! it, so a file can outlive the archive it came from (IReferenceCounted is
+//! not thread safe, so files do not grab the archive itself).
+struct SSTKPackData
+{
+	const u8* Memory;
+	u32 Size;
+	bool Mapped;
+
+	SSTKPackData() : Memory(0), Size(0), Mapped(false) {}
+
+	~SSTKPackData()
+	{
+#ifdef STKPACK_USE_MMAP
+		if (Mapped)
+		{
+			munmap((void*)Memory, Size);
+			return;
+		}
+#endif
+		delete [] Memory;
+	}
+
+	//! Maps the file if possible, otherwise reads all of it into memory.
+	bool load(IReadFile* file)
+	{
+		const long size = file->getSize();
+		if (size <= 0)
+			return false;
+		Size = (u32)size;
+
+#ifdef STKPACK_USE_MMAP
+		int fd = open(file->getFileName().c_str(), O_RDONLY);
+		if (fd != -1)
+		{
+			struct stat st;
+			if (fstat(fd, &st) == 0 && st.st_size == size)
+			{
+				void* memory = mmap(NULL, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (memory != MAP_FAILED)
+				{
+					// Ask the kernel to start reading the pack in large
+					// sequential chunks, most of its files will be loaded
+					madvise(memory, Size, MADV_WILLNEED);
+					Memory = (const u8*)memory;
+					Mapped = true;
+				}
+			}
+			close(fd);
+			if (Mapped)
+				return true;
+		}
+#endif
+
+		// Not a plain file (e.g. inside an apk) or it can't be mapped
+		u8* memory = new u8[Size];
+		file->seek(0);
+		if (file->read(memory, Size) != (s32)Size)
+		{
+			delete [] memory;
+			return false;
+		}
+		Memory = memory;
+		return true;
+	}
+};
+
+
+//! A file of a pack, it reads directly from the shared pack memory.
+class CSTKPackReadFile : public CMemoryFile
+{
+public:
+	CSTKPackReadFile(const std::shared_ptr<SSTKPackData>& data, u32 offset,
+		u32 size, const io::path& fileName)
+	: CMemoryFile((void*)(data->Memory + offset), size, fileName, false),
+		Data(data)
+	{
+		#ifdef _DEBUG
+		setDebugName("CSTKPackReadFile");
+		#endif
+	}
+
+private:
+	std::shared_ptr<SSTKPackData> Data;
+};
+
+
+//! Constructor
+CArchiveLoaderSTKPack::CArchiveLoaderSTKPack(io::IFileSystem* fs)
+: FileSystem(fs)
+{
+	#ifdef _DEBUG
+	setDebugName("CArchiveLoaderSTKPack");
+	#endif
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CArchiveLoaderSTKPack::isALoadableFileFormat(const io::path& filename) const
+{
+	return core::hasFileExtension(filename, "stkpack");
+}
+
+//! Check to see if the loader can create archives of this type.
+bool CArchiveLoaderSTKPack::isALoadableFileFormat(E_FILE_ARCHIVE_TYPE fileType) const
+{
+	return fileType == EFAT_STKPACK;
+}
+
+//! Creates an archive from the filename
+/** \param file File handle to check.
+\return Pointer to newly created archive, or 0 upon error. */
+IFileArchive* CArchiveLoaderSTKPack::createArchive(const io::path& filename, bool ignoreCase, bool ignorePaths) const
+{
+	IFileArchive *archive = 0;
+	io::IReadFile* file = FileSystem->createAndOpenFile(filename);
+
+	if (file)
+	{
+		archive = createArchive(file, ignoreCase, ignorePaths);
+		file->drop();
+	}
+
+	return archive;
+}
+
+
+//! creates/loads an archive from the file.
+//! \return Pointer to the created archive. Returns 0 if loading failed.
+IFileArchive* CArchiveLoaderSTKPack::createArchive(io::IReadFile* file, bool ignoreCase, bool ignorePaths) const
+{
+	if (!file)
+		return 0;
+
+	file->seek(0);
+	CSTKPackReader* archive = new CSTKPackReader(file, ignoreCase, ignorePaths,
+		FileSystem->getWorkingDirectory());
+	if (!archive->isValid())
+	{
+		archive->drop();
+		return 0;
+	}
+	return archive;
+}
+
+//! Check if the file might be loaded by this class
+/** Check might look into the file.
+\param file File handle to check.
+\return True if file seems to be loadable. */
+bool CArchiveLoaderSTKPack::isALoadableFileFormat(io::IReadFile* file) const
+{
+	c8 magic[8];
+	file->seek(0);
+	if (file->read(magic, sizeof(magic)) != (s32)sizeof(magic))
+		return false;
+	return memcmp(magic, STKPACK_MAGIC, sizeof(magic)) == 0;
+}
+
+/*
+	STK asset pack
+*/
+CSTKPackReader::CSTKPackReader(IReadFile* file, bool ignoreCase, bool ignorePaths,
+	const io::path& workingDirectory)
+ : CFileList((file ? file->getFileName() : io::path("")), ignoreCase, ignorePaths)
+{
+	#ifdef _DEBUG
+	setDebugName("CSTKPackReader");
+	#endif
+
+	BaseDir = Path;
+	const s32 last_slash = BaseDir.findLast('/');
+	BaseDir = last_slash == -1 ? io::path("") :
+		BaseDir.subString(0, last_slash + 1);
+
+	io::path cwd = workingDirectory;
+	cwd.replace('\\', '/');
+	if (cwd.size() > 0 && cwd.lastChar() != '/')
+		cwd.append('/');
+	if (cwd.size() > 1 && BaseDir.size() > cwd.size() &&
+		BaseDir.equalsn(cwd, cwd.size()))
+		RelativeBaseDir = BaseDir.subString(cwd.size(), BaseDir.size() - cwd.size());
+
+	if (file)
+	{
+		Data = std::make_shared<SSTKPackData>();
+		if (!Data->load(file) || !populateFileList())
+		{
+			os::Printer::log("Invalid STK asset pack", Path, ELL_ERROR);
+			Data.reset();
+			Files.clear();
+			return;
+		}
+		sort();
+	}
+}
+
+
+CSTKPackReader::~CSTKPackReader()
+{
+}
+
+const IFileList* CSTKPackReader::getFileList() const
+{
+	return this;
+}
+
+
+bool CSTKPackReader::populateFileList()
+{
+	Files.clear();
+
+	const u8* memory = Data->Memory;
+	const u32 size = Data->Size;
+	if (size < sizeof(SSTKPackHeader) ||
+		memcmp(memory, STKPACK_MAGIC, sizeof(STKPACK_MAGIC)) != 0)
+		return false;
+
+	const u8* header = memory + sizeof(STKPACK_MAGIC);
+	const u32 version = readU32(header);
+	const u32 file_count = readU32(header + 4);
+	const u32 index_size = readU32(header + 8);
+	if (version != STKPACK_VERSION ||
+		index_size > size - sizeof(SSTKPackHeader))
+		return false;
+
+	const u8* p = memory + sizeof(SSTKPackHeader);
+	const u8* index_end = p + index_size;
+	Files.reallocate(file_count);
+	for (u32 i = 0; i < file_count; i++)
+	{
+		if (index_end - p < 10)
+			return false;
+		const u32 offset = readU32(p);
+		const u32 file_size = readU32(p + 4);
+		const u16 name_length = readU16(p + 8);
+		p += 10;
+		if ((u32)(index_end - p) < name_length || offset > size ||
+			file_size > size - offset)
+			return false;
+
+		const io::path name((const c8*)p, name_length);
+		p += name_length;
+		addItem(name, offset, file_size, false);
+	}
+	return true;
+}
+
+//! searches for a file below the given directory
+s32 CSTKPackReader::findFileInDir(const io::path& filename, const io::path& dir,
+	bool isDirectory) const
+{
+	if (dir.size() == 0 || filename.size() <= dir.size() ||
+		!filename.equalsn(dir, dir.size()))
+		return -1;
+	return CFileList::findFile(filename.subString(dir.size(),
+		filename.size() - dir.size()), isDirectory);
+}
+
+//! searches for a file, also by its full path
+s32 CSTKPackReader::findFile(const io::path& name, bool isDirectory) const
+{
+	io::path filename = name;
+	filename.replace('\\', '/');
+
+	s32 index = findFileInDir(filename, BaseDir, isDirectory);
+	if (index != -1)
+		return index;
+
+	if (RelativeBaseDir.size() > 0)
+	{
+		if (filename.equalsn("./", 2))
+		{
+			index = findFileInDir(filename.subString(2, filename.size() - 2),
+				RelativeBaseDir, isDirectory);
+		}
+		else
+			index = findFileInDir(filename, RelativeBaseDir, isDirectory);
+		if (index != -1)
+			return index;
+	}
+	return CFileList::findFile(filename, isDirectory);
+}
+
+//! opens a file by file name
+IReadFile* CSTKPackReader::createAndOpenFile(const io::path& filename)
+{
+	const s32 index = findFile(filename, false);
+
+	if (index != -1)
+		return createAndOpenFile(index);
+
+	return 0;
+}
+
+//! opens a file by index
+IReadFile* CSTKPackReader::createAndOpenFile(u32 index)
+{
+	if (index >= Files.size() || !Data)
+		return 0;
+
+	const SFileListEntry &entry = Files[index];
+	return new CSTKPackReadFile(Data, entry.Offset, entry.Size,
+		BaseDir + entry.FullName);
+}
+
+} // end namespace io
+} // end namespace irr
+
+#endif // __IRR_COMPILE_WITH_STKPACK_ARCHIVE_LOADER_
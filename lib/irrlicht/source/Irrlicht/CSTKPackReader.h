@@ -0,0 +1,138 @@
+// Copyright (C) 2026 SuperTuxKart-Team
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_STK_PACK_READER_H_INCLUDED__
+#define __C_STK_PACK_READER_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef __IRR_COMPILE_WITH_STKPACK_ARCHIVE_LOADER_
+
+#include "IReferenceCounted.h"
+#include "IReadFile.h"
+#include "irrArray.h"
+#include "irrString.h"
+#include "IFileSystem.h"
+#include "CFileList.h"
+
+#include <memory>
+
+namespace irr
+{
+namespace io
+{
+
+// byte-align structures
+#include "irrpack.h"
+
+	//! Header of a SuperTuxKart asset pack (.stkpack). It is followed by
+	//! FileCount index entries (u32 offset, u32 size, u16 name length and
+	//! the name relative to the packed directory), and then by the
+	//! uncompressed file data, each file aligned to DataAlignment bytes.
+	//! All values are little endian.
+	struct SSTKPackHeader
+	{
+		c8 Magic[8];
+		u32 Version;
+		u32 FileCount;
+		u32 IndexSize;
+		u32 DataAlignment;
+	} PACK_STRUCT;
+
+// Default alignment
+#include "irrunpack.h"
+
+	//! The content of a pack file, memory mapped if possible.
+	struct SSTKPackData;
+
+	//! Archiveloader capable of loading SuperTuxKart asset packs
+	class CArchiveLoaderSTKPack : public IArchiveLoader
+	{
+	public:
+
+		//! Constructor
+		CArchiveLoaderSTKPack(io::IFileSystem* fs);
+
+		//! returns true if the file maybe is able to be loaded by this class
+		//! based on the file extension (e.g. ".stkpack")
+		virtual bool isALoadableFileFormat(const io::path& filename) const;
+
+		//! Check if the file might be loaded by this class
+		/** Check might look into the file.
+		\param file File handle to check.
+		\return True if file seems to be loadable. */
+		virtual bool isALoadableFileFormat(io::IReadFile* file) const;
+
+		//! Check to see if the loader can create archives of this type.
+		/** Check based on the archive type.
+		\param fileType The archive type to check.
+		\return True if the archile loader supports this type, false if not */
+		virtual bool isALoadableFileFormat(E_FILE_ARCHIVE_TYPE fileType) const;
+
+		//! Creates an archive from the filename
+		/** \param file File handle to check.
+		\return Pointer to newly created archive, or 0 upon error. */
+		virtual IFileArchive* createArchive(const io::path& filename, bool ignoreCase, bool ignorePaths) const;
+
+		//! creates/loads an archive from the file.
+		//! \return Pointer to the created archive. Returns 0 if loading failed.
+		virtual io::IFileArchive* createArchive(io::IReadFile* file, bool ignoreCase, bool ignorePaths) const;
+
+	private:
+		io::IFileSystem* FileSystem;
+	};
+
+
+	//! An asset pack of a kart or track directory. Files can be opened by
+	//! their name relative to the packed directory, or by their full or
+	//! working directory relative path (the pack must be stored in the
+	//! directory it contains).
+	class CSTKPackReader : public virtual IFileArchive, virtual CFileList
+	{
+	public:
+
+		CSTKPackReader(IReadFile* file, bool ignoreCase, bool ignorePaths,
+			const io::path& workingDirectory);
+
+		virtual ~CSTKPackReader();
+
+		//! returns true if the pack was loaded without errors
+		bool isValid() const { return Data != 0; }
+
+		//! opens a file by file name
+		virtual IReadFile* createAndOpenFile(const io::path& filename);
+
+		//! opens a file by index
+		virtual IReadFile* createAndOpenFile(u32 index);
+
+		//! returns the list of files
+		virtual const IFileList* getFileList() const;
+
+		//! searches for a file, also by its full path
+		virtual s32 findFile(const io::path& filename, bool isFolder) const;
+
+		//! get the class Type
+		virtual E_FILE_ARCHIVE_TYPE getType() const { return EFAT_STKPACK; }
+
+	private:
+
+		bool populateFileList();
+
+		s32 findFileInDir(const io::path& filename, const io::path& dir,
+			bool isFolder) const;
+
+		//! directory of the pack file, with a trailing slash
+		io::path BaseDir;
+
+		//! the same directory relative to the working directory, if possible
+		io::path RelativeBaseDir;
+
+		std::shared_ptr<SSTKPackData> Data;
+	};
+
+} // end namespace io
+} // end namespace irr
+
+#endif // __IRR_COMPILE_WITH_STKPACK_ARCHIVE_LOADER_
+#endif // __C_STK_PACK_READER_H_INCLUDED__
@@ -16,6 +16,30 @@ namespace irr
 namespace scene
 {
 
+namespace
+{
+	//! Returns the index of the first key with a frame >= the given frame
+	//! (keys are sorted by frame), or -1 if there is none.
+	template<class T>
+	s32 findKeyIndex(const core::array<T> &keys, f32 frame)
+	{
+		u32 first = 0;
+		u32 count = keys.size();
+		while (count > 0)
+		{
+			const u32 step = count / 2;
+			if (keys[first + step].frame < frame)
+			{
+				first += step + 1;
+				count -= step + 1;
+			}
+			else
+				count = step;
+		}
+		return first < keys.size() ? (s32)first : -1;
+	}
+}
+
 
 //! constructor
 CSkinnedMesh::CSkinnedMesh()
@@ -290,18 +314,12 @@ void CSkinnedMesh::getFrameData(f32 frame, SJoint *joint,
 				}
 			}
 
-			//The hint test failed, do a full scan...
+			//The hint test failed, do a binary search...
 			if (foundPositionIndex==-1)
 			{
-				for (u32 i=0; i<PositionKeys.size(); ++i)
-				{
-					if (PositionKeys[i].frame >= frame) //Keys should to be sorted by frame
-					{
-						foundPositionIndex=i;
-						positionHint=i;
-						break;
-					}
-				}
+				foundPositionIndex=findKeyIndex(PositionKeys, frame);
+				if (foundPositionIndex!=-1)
+					positionHint=foundPositionIndex;
 			}
 
 			//Do interpolation...
@@ -348,18 +366,12 @@ void CSkinnedMesh::getFrameData(f32 frame, SJoint *joint,
 			}
 
 
-			//The hint test failed, do a full scan...
+			//The hint test failed, do a binary search...
 			if (foundScaleIndex==-1)
 			{
-				for (u32 i=0; i<ScaleKeys.size(); ++i)
-				{
-					if (ScaleKeys[i].frame >= frame) //Keys should to be sorted by frame
-					{
-						foundScaleIndex=i;
-						scaleHint=i;
-						break;
-					}
-				}
+				foundScaleIndex=findKeyIndex(ScaleKeys, frame);
+				if (foundScaleIndex!=-1)
+					scaleHint=foundScaleIndex;
 			}
 
 			//Do interpolation...
@@ -406,18 +418,12 @@ void CSkinnedMesh::getFrameData(f32 frame, SJoint *joint,
 			}
 
 
-			//The hint test failed, do a full scan...
+			//The hint test failed, do a binary search...
 			if (foundRotationIndex==-1)
 			{
-				for (u32 i=0; i<RotationKeys.size(); ++i)
-				{
-					if (RotationKeys[i].frame >= frame) //Keys should be sorted by frame
-					{
-						foundRotationIndex=i;
-						rotationHint=i;
-						break;
-					}
-				}
+				foundRotationIndex=findKeyIndex(RotationKeys, frame);
+				if (foundRotationIndex!=-1)
+					rotationHint=foundRotationIndex;
 			}
 
 			//Do interpolation...
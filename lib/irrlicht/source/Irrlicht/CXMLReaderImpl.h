@@ -32,7 +32,7 @@ public:
 	//! Constructor
 	CXMLReaderImpl(IFileReadCallBack* callback, bool deleteCallBack = true)
 		: IgnoreWhitespaceText(true), TextData(0), P(0), TextBegin(0), TextSize(0), CurrentNodeType(EXN_NONE),
-		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII), IsEmptyElement(false)
+		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII), CurrentName(EmptyString.c_str()), IsEmptyElement(false)
 	{
 		if (!callback)
 			return;
@@ -99,7 +99,7 @@ public:
 		if ((u32)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Name.c_str();
+		return Attributes[idx].Name;
 	}
 
 
@@ -109,7 +109,7 @@ public:
 		if ((unsigned int)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Value.c_str();
+		return Attributes[idx].Value;
 	}
 
 
@@ -120,7 +120,7 @@ public:
 		if (!attr)
 			return 0;
 
-		return attr->Value.c_str();
+		return attr->Value;
 	}
 
 
@@ -131,7 +131,7 @@ public:
 		if (!attr)
 			return EmptyString.c_str();
 
-		return attr->Value.c_str();
+		return attr->Value;
 	}
 
 
@@ -143,8 +143,7 @@ public:
 		if (!attr)
 			return 0;
 
-		core::stringc c(attr->Value.c_str());
-		return core::strtol10(c.c_str());
+		return toInt(attr->Value);
 	}
 
 
@@ -155,8 +154,7 @@ public:
 		if (!attrvalue)
 			return 0;
 
-		core::stringc c(attrvalue);
-		return core::strtol10(c.c_str());
+		return toInt(attrvalue);
 	}
 
 
@@ -167,8 +165,7 @@ public:
 		if (!attr)
 			return 0;
 
-		core::stringc c = attr->Value.c_str();
-		return core::fast_atof(c.c_str());
+		return toFloat(attr->Value);
 	}
 
 
@@ -179,22 +176,21 @@ public:
 		if (!attrvalue)
 			return 0;
 
-		core::stringc c = attrvalue;
-		return core::fast_atof(c.c_str());
+		return toFloat(attrvalue);
 	}
 
 
 	//! Returns the name of the current node.
 	virtual const char_type* getNodeName() const
 	{
-		return NodeName.c_str();
+		return CurrentName;
 	}
 
 
 	//! Returns data of the current node.
 	virtual const char_type* getNodeData() const
 	{
-		return NodeName.c_str();
+		return CurrentName;
 	}
 
 
@@ -283,6 +279,7 @@ private:
 		// set current text to the parsed text, and replace xml special characters
 		core::string<char_type> s(start, (int)(end - start));
 		NodeName = replaceSpecialCharacters(s);
+		CurrentName = NodeName.c_str();
 
 		// current XML node type is text
 		CurrentNodeType = EXN_TEXT;
@@ -339,24 +336,28 @@ private:
 		{
 			NodeName = "";
 		}
+		CurrentName = NodeName.c_str();
 	}
 
 
 	//! parses an opening xml element and reads attributes
+	/** Names and values are parsed in place: they are terminated with 0
+	inside the text buffer (only at positions already passed by P), so no
+	string needs to be allocated for them. */
 	void parseOpeningXMLElement()
 	{
 		CurrentNodeType = EXN_ELEMENT;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		// find name
-		const char_type* startName = P;
+		char_type* startName = P;
 
 		// find end of element
 		while(*P && *P != L'>' && !isWhiteSpace(*P))
 			++P;
 
-		const char_type* endName = P;
+		char_type* endName = P;
 
 		// find Attributes
 		while(*P && *P != L'>')
@@ -370,12 +371,12 @@ private:
 					// we've got an attribute
 
 					// read the attribute names
-					const char_type* attributeNameBegin = P;
+					char_type* attributeNameBegin = P;
 
 					while(*P && !isWhiteSpace(*P) && *P != L'=')
 						++P;
 
-					const char_type* attributeNameEnd = P;
+					char_type* attributeNameEnd = P;
 					if (*P)
 						++P;
 
@@ -391,7 +392,7 @@ private:
 
 					if (*P)
 						++P;
-					const char_type* attributeValueBegin = P;
+					char_type* attributeValueBegin = P;
 
 					while(*P && *P != attributeQuoteChar)
 						++P;
@@ -399,18 +400,17 @@ private:
 					if (!*P) // malformatted xml file
 						return;
 
-					const char_type* attributeValueEnd = P;
+					char_type* attributeValueEnd = P;
 					if (*P)
 						++P;
 
-					SAttribute attr;
-					attr.Name = core::string<char_type>(attributeNameBegin,
-						(int)(attributeNameEnd - attributeNameBegin));
-
-					core::string<char_type> s(attributeValueBegin,
-						(int)(attributeValueEnd - attributeValueBegin));
+					*attributeNameEnd = 0;
+					*replaceSpecialCharactersInPlace(attributeValueBegin,
+						attributeValueEnd) = 0;
 
-					attr.Value = replaceSpecialCharacters(s);
+					SAttribute attr;
+					attr.Name = attributeNameBegin;
+					attr.Value = attributeValueBegin;
 					Attributes.push_back(attr);
 				}
 				else
@@ -432,10 +432,11 @@ private:
 			endName--;
 		}
 
-		NodeName = core::string<char_type>(startName, (int)(endName - startName));
-
 		if (*P)
 			++P;
+
+		*endName = 0;
+		CurrentName = startName;
 	}
 
 
@@ -444,19 +445,28 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT_END;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		if (*P)
 			++P;
-		const char_type* pBeginClose = P;
+		char_type* pBeginClose = P;
 
 		while(*P && *P != L'>')
 			++P;
 
-		NodeName = core::string<char_type>(pBeginClose, (int)(P - pBeginClose));
-		
+		char_type* pEndClose = P;
+
 		if (*P)
+		{
 			++P;
+			*pEndClose = 0;
+			CurrentName = pBeginClose;
+		}
+		else
+		{
+			NodeName = core::string<char_type>(pBeginClose, (int)(pEndClose - pBeginClose));
+			CurrentName = NodeName.c_str();
+		}
 	}
 
 	//! parses a possible CDATA section, returns false if begin was not a CDATA section
@@ -498,16 +508,18 @@ private:
 			NodeName = core::string<char_type>(cDataBegin, (int)(cDataEnd - cDataBegin));
 		else
 			NodeName = "";
+		CurrentName = NodeName.c_str();
 
 		return true;
 	}
 
 
-	// structure for storing attribute-name pairs
+	// structure for storing attribute-name pairs, both point into the
+	// text buffer
 	struct SAttribute
 	{
-		core::string<char_type> Name;
-		core::string<char_type> Value;
+		const char_type* Name;
+		const char_type* Value;
 	};
 
 	// finds a current attribute by name, returns 0 if not found
@@ -516,15 +528,98 @@ private:
 		if (!name)
 			return 0;
 
-		core::string<char_type> n = name;
-
-		for (int i=0; i<(int)Attributes.size(); ++i)
-			if (Attributes[i].Name == n)
+		for (u32 i=0; i<Attributes.size(); ++i)
+		{
+			const char_type* a = Attributes[i].Name;
+			const char_type* b = name;
+			while (*a && *a == *b)
+			{
+				++a;
+				++b;
+			}
+			if (*a == *b)
 				return &Attributes[i];
+		}
 
 		return 0;
 	}
 
+	// converts an attribute value to an integer without allocating
+	static int toInt(const char_type* value)
+	{
+		char buffer[64];
+		if (!narrowNumber(value, buffer, sizeof(buffer)))
+		{
+			core::stringc c(value);
+			return core::strtol10(c.c_str());
+		}
+		return core::strtol10(buffer);
+	}
+
+	// converts an attribute value to a float without allocating
+	static float toFloat(const char_type* value)
+	{
+		char buffer[64];
+		if (!narrowNumber(value, buffer, sizeof(buffer)))
+		{
+			core::stringc c(value);
+			return core::fast_atof(c.c_str());
+		}
+		return core::fast_atof(buffer);
+	}
+
+	// copies a value to a char buffer, returns false if it doesn't fit
+	static bool narrowNumber(const char_type* value, char* buffer, u32 size)
+	{
+		for (u32 i=0; i<size; ++i)
+		{
+			buffer[i] = (char)value[i];
+			if (!value[i])
+				return true;
+		}
+		return false;
+	}
+
+	// replaces xml special characters between start and end in place and
+	// returns the new end, the result is never longer than the input
+	char_type* replaceSpecialCharactersInPlace(char_type* start, char_type* end)
+	{
+		char_type* p = start;
+		while (p != end && *p != L'&')
+			++p;
+
+		char_type* out = p;
+		while (p != end)
+		{
+			if (*p != L'&')
+			{
+				*out++ = *p++;
+				continue;
+			}
+
+			int specialChar = -1;
+			for (int i=0; i<(int)SpecialCharacters.size(); ++i)
+			{
+				const int len = (int)SpecialCharacters[i].size() - 1;
+				if (end - (p + 1) >= len &&
+					equalsn(&SpecialCharacters[i][1], p + 1, len))
+				{
+					specialChar = i;
+					break;
+				}
+			}
+
+			if (specialChar != -1)
+			{
+				*out++ = SpecialCharacters[specialChar][0];
+				p += SpecialCharacters[specialChar].size();
+			}
+			else
+				*out++ = *p++;
+		}
+		return out;
+	}
+
 	// replaces xml special characters in a string and creates a new one
 	core::string<char_type> replaceSpecialCharacters(
 		core::string<char_type>& origstr)
@@ -820,8 +915,9 @@ private:
 	ETEXT_FORMAT SourceFormat;   // source format of the xml file
 	ETEXT_FORMAT TargetFormat;   // output format of this parser
 
-	core::string<char_type> NodeName;    // name of the node currently in - also used for text
+	core::string<char_type> NodeName;    // storage for text, comment and CDATA nodes
 	core::string<char_type> EmptyString; // empty string to be returned by getSafe() methods
+	const char_type* CurrentName;        // name of the node currently in - also used for text
 
 	bool IsEmptyElement;       // is the currently parsed node empty?
 
@@ -25,6 +25,15 @@
 #include <string.h>
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <mutex>
+
+/** Number of entries per second in the segment index of baked bezier
+ *  curves. */
+static const float BAKE_FPS = 60.0f;
+
+/** Longer curves are not baked to limit the memory usage. */
+static const unsigned int MAX_BAKED_SAMPLES = 2048;
 
 const std::string Ipo::m_all_channel_names[IPO_MAX] =
                 {"LocX", "LocY", "LocZ", "LocXYZ",
@@ -86,7 +95,10 @@ Ipo::IpoData::IpoData(const XMLNode &curve, float fps, bool reverse)
     if(m_channel==IPO_LOCXYZ)
         readCurve(curve, reverse);
     else
+    {
         readIPO(curve, fps, reverse);
+        bake();
+    }
 
 }   // IpoData
 
@@ -348,6 +360,86 @@ float Ipo::IpoData::get(float time, unsigned int index, unsigned int n)
     return 0;
 }   // IpoData::get
 
+// ----------------------------------------------------------------------------
+/** Bakes a bezier curve: the polynomial coefficients of each segment are
+ *  precomputed, and the segment used at each 1/BAKE_FPS seconds is stored,
+ *  so that get() neither needs to search the curve segment nor compute the
+ *  coefficients at runtime. The baked curve gives the same values as the
+ *  original one. Constant and linear curves are cheap to evaluate and are
+ *  not baked.
+ */
+void Ipo::IpoData::bake()
+{
+    if (m_interpolation != IP_BEZIER || m_points.size() < 2 ||
+        m_points.size() - 1 > UINT16_MAX || m_end_time <= m_start_time)
+        return;
+    // The segment search assumes that the control points are sorted
+    for (unsigned int n = 0; n < m_points.size() - 1; n++)
+    {
+        if (m_points[n + 1].getW() <= m_points[n].getW())
+            return;
+    }
+    const unsigned int num_samples =
+        (unsigned int)ceilf((m_end_time - m_start_time) * BAKE_FPS) + 1;
+    if (num_samples > MAX_BAKED_SAMPLES)
+        return;
+
+    m_baked_segments.resize(m_points.size() - 1);
+    for (unsigned int n = 0; n < m_baked_segments.size(); n++)
+    {
+        BakedSegment &segment = m_baked_segments[n];
+        segment.m_start_time = m_points[n].getW();
+        segment.m_end_time   = m_points[n + 1].getW();
+        for (unsigned int j = 0; j < 3; j++)
+        {
+            const float p0 = m_points [n    ][j];
+            const float p1 = m_handle2[n    ][j];
+            const float p2 = m_handle1[n + 1][j];
+            const float p3 = m_points [n + 1][j];
+            segment.m_c[j] = 3.0f*(p1-p0);
+            segment.m_b[j] = 3.0f*(p2-p1)-segment.m_c[j];
+            segment.m_a[j] = p3 - p0 - segment.m_c[j] - segment.m_b[j];
+            segment.m_d[j] = p0;
+        }
+    }   // for n < m_baked_segments.size()
+
+    m_baked_index.resize(num_samples);
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < num_samples; i++)
+    {
+        float time = std::min(m_start_time + i / BAKE_FPS, m_end_time);
+        while (n < m_baked_segments.size() - 1 &&
+               time >= m_baked_segments[n + 1].m_start_time)
+            n++;
+        m_baked_index[i] = (uint16_t)n;
+    }
+}   // bake
+
+// ----------------------------------------------------------------------------
+/** Returns the value of a baked curve.
+ *  \param time The time, which must already be adjusted with adjustTime().
+ *  \param index Which value to use (0=x, 1=y, 2=z).
+ */
+float Ipo::IpoData::getBaked(float time, unsigned int index) const
+{
+    float f = std::max(time - m_start_time, 0.0f) * BAKE_FPS;
+    unsigned int n = m_baked_index[std::min((unsigned int)f,
+                                   (unsigned int)m_baked_index.size() - 1)];
+    // Several short segments can be within one sample, and rounding can
+    // select the sample after the time
+    while (n < m_baked_segments.size() - 1 &&
+           time >= m_baked_segments[n + 1].m_start_time)
+        n++;
+    while (n > 0 && time < m_baked_segments[n].m_start_time)
+        n--;
+
+    const BakedSegment &segment = m_baked_segments[n];
+    float t = (time - segment.m_start_time)
+            / (segment.m_end_time - segment.m_start_time);
+    return ((segment.m_a[index]*t + segment.m_b[index])*t
+           + segment.m_c[index])*t + segment.m_d[index];
+}   // getBaked
+
 // ----------------------------------------------------------------------------
 /** Computes a cubic bezier curve for a given t in [0,1] and four control
  *  points. The curve will go through p0 (t=0), p3 (t=1).
@@ -435,11 +527,67 @@ float Ipo::IpoData::getCubicBezierDerivative(float t, float p0, float p1,
  */
 Ipo::Ipo(const XMLNode &curve, float fps, bool reverse)
 {
-    m_ipo_data     = new IpoData(curve, fps, reverse);
-    m_own_ipo_data = true;
+    m_ipo_data = loadIpoData(curve, fps, reverse);
     reset();
 }   // Ipo
 
+// ----------------------------------------------------------------------------
+/** Returns the IpoData for a curve. Tracks often use many instances of the
+ *  same animated library object, so the data of identical curves is only
+ *  read (and baked) once, and shared as long as any Ipo is using it.
+ *  \param curve The XML data for this curve.
+ *  \param fps Frames per second of the animation.
+ *  \param reverse If the ipo data will be reversed.
+ */
+std::shared_ptr<Ipo::IpoData> Ipo::loadIpoData(const XMLNode &curve,
+                                                float fps, bool reverse)
+{
+    static std::mutex cache_mutex;
+    static std::map<std::string, std::weak_ptr<IpoData> > cache;
+
+    // The key contains all attributes which are used by IpoData
+    std::string key = curve.getName() + (reverse ? " r " : " f ")
+                    + std::to_string(fps);
+    std::string value;
+    for (const char* name : { "channel", "interpolation", "extend", "speed" })
+    {
+        value.clear();
+        curve.get(name, &value);
+        key += ' ' + value;
+    }
+    for (unsigned int i = 0; i < curve.getNumNodes(); i++)
+    {
+        const XMLNode *node = curve.getNode(i);
+        for (const char* name : { "c", "h1", "h2" })
+        {
+            value.clear();
+            node->get(name, &value);
+            key += ' ' + value;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache.find(key);
+    if (it != cache.end())
+    {
+        if (std::shared_ptr<IpoData> data = it->second.lock())
+            return data;
+    }
+
+    std::shared_ptr<IpoData> data =
+        std::make_shared<IpoData>(curve, fps, reverse);
+    // Remove the entries of curves which are not used anymore
+    for (auto i = cache.begin(); i != cache.end();)
+    {
+        if (i->second.expired())
+            i = cache.erase(i);
+        else
+            i++;
+    }
+    cache[key] = data;
+    return data;
+}   // loadIpoData
+
 // ----------------------------------------------------------------------------
 /** A copy constructor. It shares the read-only data with the source Ipo
  *  \param ipo The ipo to copy from.
@@ -448,7 +596,6 @@ Ipo::Ipo(const Ipo *ipo)
 {
     // Share the read-only data
     m_ipo_data     = ipo->m_ipo_data;
-    m_own_ipo_data = false;
     reset();
 }   // Ipo(Ipo*)
 
@@ -462,13 +609,11 @@ Ipo  *Ipo::clone()
 }   // clone
 
 // ----------------------------------------------------------------------------
-/** The destructor only frees IpoData if it was created by this instance (and
- *  not if this instance was copied, therefore sharing the IpoData).
+/** The destructor. The IpoData is freed when the last Ipo using it is
+ *  deleted.
  */
 Ipo::~Ipo()
 {
-    if(m_own_ipo_data)
-        delete m_ipo_data;
 }   // ~Ipo
 
 // ----------------------------------------------------------------------------
@@ -564,6 +709,9 @@ float Ipo::get(float time, unsigned int index) const
     if(m_next_n==0)
         return m_ipo_data->m_points[0][index];
 
+    if (!m_ipo_data->m_baked_segments.empty())
+        return m_ipo_data->getBaked(m_ipo_data->adjustTime(time), index);
+
     updateNextN(&time);
 
     float rval = m_ipo_data->get(time, index, m_next_n-1);
@@ -19,6 +19,8 @@
 #ifndef HEADER_IPO_HPP
 #define HEADER_IPO_HPP
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -78,6 +80,25 @@ private:
 
         /** Stores the inital rotation of the object. */
         Vec3 m_initial_hpr;
+
+        /** The cubic polynomial of one bezier segment for all three axes,
+         *  with the coefficients computed like in getCubicBezier(). */
+        struct BakedSegment
+        {
+            /** Times of the two control points of the segment. */
+            float m_start_time, m_end_time;
+            /** Coefficients of ((a*t+b)*t+c)*t+d for each axis. */
+            float m_a[3], m_b[3], m_c[3], m_d[3];
+        };   // BakedSegment
+
+        /** The segments of a baked bezier curve of a single axis, empty if
+         *  the curve is not baked. */
+        std::vector<BakedSegment> m_baked_segments;
+
+        /** For each 1/BAKE_FPS seconds after m_start_time the index of the
+         *  segment used at that time, so the segment is found without
+         *  searching the control points. */
+        std::vector<uint16_t> m_baked_index;
     private:
         float  getCubicBezier(float t, float p0, float p1,
                               float p2, float p3) const;
@@ -97,18 +118,17 @@ private:
         float  adjustTime(float time);
         float  get(float time, unsigned int index, unsigned int n);
         float  getDerivative(float time, unsigned int index, unsigned int n);
+        void   bake();
+        float  getBaked(float time, unsigned int index) const;
 
     };   // IpoData
     // ------------------------------------------------------------------------
     /** The actual data of the IPO. This can be shared between Ipo (e.g. each
      *  cannon animation will use the same IpoData block, but its own instance
-     *  of Ipo, since data like m_next_n should not be shared). */
-    IpoData *m_ipo_data;
-
-    /** True if m_ipo_data is 'owned' by this object and therefore needs to be
-     *  freed. If an Ipo is cloned, it will share a reference to m_ipo_data,
-     *  and must therefore not free it. */
-    bool m_own_ipo_data;
+     *  of Ipo, since data like m_next_n should not be shared). Identical
+     *  curves, e.g. of several instances of an animated library object, also
+     *  share their data, see loadIpoData(). */
+    std::shared_ptr<IpoData> m_ipo_data;
 
     /** Which control points will be the next one (so m_next_n-1 and
     *  m_next_n are the control points to use now). This just reduces
@@ -118,6 +138,9 @@ private:
 
     void updateNextN(float *time) const;
 
+    static std::shared_ptr<IpoData> loadIpoData(const XMLNode &curve,
+                                                float fps, bool reverse);
+
     Ipo(const Ipo *ipo);
 public:
              Ipo(const XMLNode &curve, float fps=25, bool reverse=false);
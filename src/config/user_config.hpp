@@ -811,6 +811,27 @@ namespace UserConfigParams
     /** True if arena (battle/soccer) ai profiling. */
     PARAM_PREFIX bool m_arena_ai_stats PARAM_DEFAULT(false);
 
+    /** Speed of the headless simulation (no graphics and no networking)
+     *  relative to real time, 0 means as fast as possible. A negative value
+     *  disables the simulation mode (except in profile mode). */
+    PARAM_PREFIX float m_simulation_speed PARAM_DEFAULT(-1.0f);
+
+    /** In headless simulation: interval in simulated seconds in which a
+     *  checkpoint with the simulation progress is logged, 0 to disable. */
+    PARAM_PREFIX int m_simulation_checkpoint PARAM_DEFAULT(0);
+
+    /** The random seed specified on the command line, or -1. If set it is
+     *  also used for the items, so that races can be reproduced. */
+    PARAM_PREFIX int m_random_seed PARAM_DEFAULT(-1);
+
+    /** True if the recorded history stores a hash of the world state for
+     *  each tick (--history-hashes), which costs time every tick. */
+    PARAM_PREFIX bool m_history_state_hashes PARAM_DEFAULT(false);
+
+    /** True if the recorded history stores a keyframe of the world state
+     *  every second (--history-keyframes), which --history-seek uses. */
+    PARAM_PREFIX bool m_history_keyframes PARAM_DEFAULT(false);
+
     /** True if slipstream debugging is activated. */
     PARAM_PREFIX bool m_slipstream_debug  PARAM_DEFAULT( false );
 
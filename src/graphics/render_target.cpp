@@ -19,10 +19,13 @@
 #include "graphics/render_target.hpp"
 
 #include "graphics/2dutils.hpp"
+#include "graphics/central_settings.hpp"
 #include "graphics/frame_buffer.hpp"
 #include "graphics/irr_driver.hpp"
 #include "graphics/rtts.hpp"
 #include "graphics/shader_based_renderer.hpp"
+#include "graphics/sp/sp_base.hpp"
+#include "graphics/stk_tex_manager.hpp"
 
 #include <ISceneManager.h>
 #include <IVideoDriver.h>
@@ -155,4 +158,80 @@ void GL3RenderTarget::draw2DImage(const irr::core::rect<s32>& dest_rect,
                        clip_rect, colors, use_alpha_channel_of_texture);
 }   // draw2DImage
 
+//-----------------------------------------------------------------------------
+/** Reads back the rendered image, so that it can be cached on disk. */
+irr::video::IImage* GL3RenderTarget::createImage() const
+{
+    if (m_frame_buffer == NULL)
+        return NULL;
+
+    const unsigned width = m_frame_buffer->getWidth();
+    const unsigned height = m_frame_buffer->getHeight();
+    const unsigned pitch = width * 4;
+    uint8_t* rgba = new uint8_t[pitch * height];
+    m_frame_buffer->bind();
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    glBindFramebuffer(GL_FRAMEBUFFER, irr_driver->getDefaultFramebuffer());
+    glViewport(0, 0, irr_driver->getActualScreenSize().Width,
+        irr_driver->getActualScreenSize().Height);
+
+    // OpenGL images are stored bottom-up in RGBA, irrlicht images top-down
+    // in BGRA
+    uint8_t* pixels = new uint8_t[pitch * height];
+    for (unsigned y = 0; y < height; y++)
+    {
+        const uint8_t* src = rgba + (height - 1 - y) * pitch;
+        uint8_t* dst = pixels + y * pitch;
+        for (unsigned x = 0; x < pitch; x += 4)
+        {
+            uint8_t r = src[x], g = src[x + 1], b = src[x + 2];
+            if (CVS->isDeferredEnabled())
+            {
+                r = SP::linearToSrgb(r / 255.f);
+                g = SP::linearToSrgb(g / 255.f);
+                b = SP::linearToSrgb(b / 255.f);
+            }
+            dst[x] = b;
+            dst[x + 1] = g;
+            dst[x + 2] = r;
+            dst[x + 3] = src[x + 3];
+        }
+    }
+    delete [] rgba;
+    return irr_driver->getVideoDriver()->createImageFromData(
+        video::ECF_A8R8G8B8, core::dimension2du(width, height), pixels,
+        true/*ownForeignMemory*/);
+}   // createImage
+
+//-----------------------------------------------------------------------------
+TextureRenderTarget::TextureRenderTarget(irr::video::ITexture* texture)
+                   : m_texture(texture)
+{
+}   // TextureRenderTarget
+
+//-----------------------------------------------------------------------------
+TextureRenderTarget::~TextureRenderTarget()
+{
+    STKTexManager::getInstance()->removeTexture(m_texture);
+}   // ~TextureRenderTarget
+
+//-----------------------------------------------------------------------------
+irr::core::dimension2du TextureRenderTarget::getTextureSize() const
+{
+    return m_texture->getSize();
+}   // getTextureSize
+
+//-----------------------------------------------------------------------------
+void TextureRenderTarget::draw2DImage(const irr::core::rect<s32>& dest_rect,
+                                      const irr::core::rect<s32>* clip_rect,
+                                      const irr::video::SColor &colors,
+                                      bool use_alpha_channel_of_texture) const
+{
+    irr::core::rect<s32> source_rect(irr::core::position2di(0, 0),
+                                     m_texture->getSize());
+    ::draw2DImage(m_texture, dest_rect, source_rect, clip_rect, colors,
+                  use_alpha_channel_of_texture);
+}   // draw2DImage
+
 #endif   // !SERVER_ONLY
@@ -34,7 +34,7 @@ namespace irr
     }
     namespace video
     {
-        class ITexture; class SColor;
+        class IImage; class ITexture; class SColor;
     }
 }
 
@@ -50,6 +50,9 @@ public:
                              const irr::core::rect<irr::s32>* clip_rect,
                              const irr::video::SColor &colors,
                              bool use_alpha_channel_of_texture) const = 0;    
+    /** Returns a copy of the rendered image (which must be dropped by the
+     *  caller), or NULL if reading it back is not supported. */
+    virtual irr::video::IImage* createImage() const           { return NULL; }
 };
 
 class GL1RenderTarget: public RenderTarget
@@ -97,7 +100,26 @@ public:
     irr::core::dimension2du getTextureSize() const;
     void renderToTexture(irr::scene::ICameraSceneNode* camera, float dt);
     void setFrameBuffer(FrameBuffer* fb) { m_frame_buffer = fb; }
+    irr::video::IImage* createImage() const;
 
 };
 
+/** A render target whose content is a texture loaded from an image instead
+ *  of being rendered, e.g. a minimap from the cache. */
+class TextureRenderTarget: public RenderTarget
+{
+private:
+    irr::video::ITexture* m_texture;
+
+public:
+    TextureRenderTarget(irr::video::ITexture* texture);
+    ~TextureRenderTarget();
+    irr::core::dimension2du getTextureSize() const;
+    void renderToTexture(irr::scene::ICameraSceneNode* camera, float dt) {}
+    void draw2DImage(const irr::core::rect<irr::s32>& dest_rect,
+                     const irr::core::rect<irr::s32>* clip_rect,
+                     const irr::video::SColor &colors,
+                     bool use_alpha_channel_of_texture) const;
+};
+
 #endif
@@ -29,6 +29,7 @@
 #include "utils/log.hpp"
 #include "utils/string_utils.hpp"
 
+#include <IFileSystem.h>
 #include <IImageLoader.h>
 #include <IReadFile.h>
 #include <IVideoDriver.h>
@@ -136,7 +137,9 @@ std::shared_ptr<video::IImage> SPTexture::getImageFromPath
         return NULL;
     }
 
-    io::IReadFile* file = irr::io::createReadFile(path.c_str());
+    // Use the file system so that files of asset packs are found
+    io::IReadFile* file =
+        file_manager->getFileSystem()->createAndOpenFile(path.c_str());
     video::IImage* image = img_loader->loadImage(file);
     if (image == NULL || image->getDimension().Width == 0 ||
         image->getDimension().Height == 0)
@@ -26,108 +26,50 @@
 
 #include <algorithm> 
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <thread>
 
 #if __SSE2__ || _M_X64 || _M_IX86_FP >= 2
  #include <emmintrin.h>
  #define SIMD_SSE2_SUPPORT (1)
 #endif
-#if __SSE4_1__ || __AVX__
- #include <smmintrin.h>
- #define SIMD_SSE4_1_SUPPORT (1)
-#endif
-
-#if SIMD_SSE4_1_SUPPORT
- #include <smmintrin.h>
- #define SIMD_BLENDV_PS(x,y,mask) _mm_blendv_ps(x,y,mask)
-#elif SIMD_SSE2_SUPPORT
- #define SIMD_BLENDV_PS(x,y,mask) _mm_or_ps(_mm_andnot_ps(mask,x),_mm_and_ps(y,mask))
-#endif
 
 #if defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__clang__)
- #define ALWAYSINLINE __attribute__((always_inline))
  #define SIMD_ALIGN16 __attribute__((aligned(16)))
 #elif defined(_MSC_VER)
  #define SIMD_ALIGN16 __declspec(align(16))
- #define ALWAYSINLINE __forceinline
 #else
- #define ALWAYSINLINE
+ #define SIMD_ALIGN16
 #endif
 
 
 using namespace irr;
 
+std::map<uint64_t, SHCoefficients> SphericalHarmonics::m_cached_coefficients;
+
 namespace 
 {
 
-    #if defined(__x86_64__) || defined(__x86_64) || defined(__amd64__) || defined(__amd64) || defined(__i386__) || defined(__i386)  || defined(i386)
-
-    /* Input is 0.0,255.0, output is 0.0,1.0 */
-    static inline ALWAYSINLINE float srgb2linear( float v )
+    // ------------------------------------------------------------------------
+    /** Conversion of sRGB byte values to linear values in [0, 1]. A channel
+     *  only has 256 possible values, so a table is much cheaper than
+     *  converting each texel.
+     */
+    struct SRGBToLinear
     {
-        float v2, vpow, vpwsqrt;
-        union
-        {
-            int32_t i;
-            float f;
-        } u;
-        if( v <= (0.04045f*255.0f) )
-            v = v * ( (1.0f/12.92f)*(1.0f/255.0f) );
-        else
+        float m_value[256];
+        SRGBToLinear()
         {
-            v = ( v + (0.055f*255.0f) ) * ( (1.0f/1.055f)*(1.0f/255.0f) );
-            v2 = v * v;
-            u.f = v * 5417434112.0f;
-            u.i = (int32_t)( ( (float)u.i * 0.8f ) + 0.5f );
-            vpow = u.f;
-            vpwsqrt = sqrtf( vpow );
-            v = ( ( v2 * vpwsqrt ) + ( ( ( v2 * v ) / vpwsqrt ) / sqrtf( vpwsqrt ) ) ) * 0.51011878327f;
+            for (unsigned i = 0; i < 256; i++)
+            {
+                const float v = float(i) / 255.0f;
+                m_value[i] = v <= 0.04045f ? v / 12.92f
+                                           : powf((v + 0.055f) / 1.055f, 2.4f);
+            }
         }
-        return v;
-    }
-
-    #else
-
-    /* Input is 0.0,255.0, output is 0.0,1.0 */
-    /* Only for reference, this is waayyy too slow and should never be used */
-    static inline ALWAYSINLINE float srgb2linear( float v )
-    {
-        v *= (1.0f/255.0f);
-        if( v <= 0.04045f )
-            v = v * (1.0f/12.92f);
-        else
-            v = pow( ( v + 0.055f ) * (1.0f/1.055f), 2.4f );
-        return v;
-    }
-
-    #endif
-
-    #if SIMD_SSE2_SUPPORT
-
-    static const float SIMD_ALIGN16 srgbLinearConst00[4] = { 0.04045f*255.0f, 0.04045f*255.0f, 0.04045f*255.0f, 0.04045f*255.0f };
-    static const float SIMD_ALIGN16 srgbLinearConst01[4] = { (1.0f/12.92f)*(1.0f/255.0f), (1.0f/12.92f)*(1.0f/255.0f), (1.0f/12.92f)*(1.0f/255.0f), (1.0f/12.92f)*(1.0f/255.0f) };
-    static const float SIMD_ALIGN16 srgbLinearConst02[4] = { 0.055f*255.0f, 0.055f*255.0f, 0.055f*255.0f, 0.055f*255.0f };
-    static const float SIMD_ALIGN16 srgbLinearConst03[4] = { (1.0f/1.055f)*(1.0f/255.0f), (1.0f/1.055f)*(1.0f/255.0f), (1.0f/1.055f)*(1.0f/255.0f), (1.0f/1.055f)*(1.0f/255.0f) };
-    static const float SIMD_ALIGN16 srgbLinearConst04[4] = { 5417434112.0f, 5417434112.0f, 5417434112.0f, 5417434112.0f };
-    static const float SIMD_ALIGN16 srgbLinearConst05[4] = { 0.8f, 0.8f, 0.8f, 0.8f };
-    static const float SIMD_ALIGN16 srgbLinearConst06[4] = { 0.51011878327f, 0.51011878327f, 0.51011878327f, 0.51011878327f };
-
-    /* Input is 0.0,255.0 ~ output is 0.0,1.0 */
-    static inline ALWAYSINLINE __m128 srgb2linear4( __m128 vx )
-    {
-        __m128 vmask, vbase;
-        __m128 vpow, vpwsqrtinv, vpwsqrt, vx2;
-        vmask = _mm_cmple_ps( vx, *(__m128*)srgbLinearConst00 );
-        vbase = _mm_mul_ps( vx, *(__m128*)srgbLinearConst01 );
-        vx = _mm_mul_ps( _mm_add_ps( vx, *(__m128*)srgbLinearConst02 ), *(__m128*)srgbLinearConst03 );
-        vx2 = _mm_mul_ps( vx, vx );
-        vpow = _mm_castsi128_ps( _mm_cvtps_epi32( _mm_mul_ps( _mm_cvtepi32_ps( _mm_castps_si128( _mm_mul_ps( vx, *(__m128*)srgbLinearConst04 ) ) ), *(__m128*)srgbLinearConst05 ) ) );
-        vpwsqrtinv = _mm_rsqrt_ps( vpow );
-        vpwsqrt = _mm_mul_ps( vpow, vpwsqrtinv );
-        vx = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( vx2, vpwsqrt ), _mm_mul_ps( _mm_mul_ps( _mm_mul_ps( vx2, vx ), vpwsqrtinv ), _mm_rsqrt_ps( vpwsqrt ) ) ), *(__m128*)srgbLinearConst06 );
-        return SIMD_BLENDV_PS( vx, vbase, vmask );
-    }
-
-    #endif
+    };
+    const SRGBToLinear g_srgb_to_linear;
 
     // ------------------------------------------------------------------------
     /** Print the nine first spherical harmonics coefficients
@@ -172,344 +114,236 @@ namespace
     }   // getTexelValue
     
     // ------------------------------------------------------------------------
-    /** Return a normalized vector aiming at a texel on a cubemap
-     *  \param face The face of the cubemap
-     *  \param j The texel line in the face
-     *  \param j The texel column in the face
-     *  \param x The x vector component
-     *  \param y The y vector component
-     *  \param z The z vector component
-     */    
-    void getXYZ(GLenum face, float i, float j, float &x, float &y, float &z)
+    /** Directions of the texels of each cubemap face. The x, y and z vector
+     *  components (before normalization) are c + ci * i + cj * j for the
+     *  texel line i and column j in [-1, 1], stored as { c, ci, cj }.
+     */
+    const float FACE_AXES[6][3][3] =
     {
-        float norminv;
-        switch (face)
+        { {  1.0f,  0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f }, { 0.0f,  0.0f, -1.0f } }, // PosX
+        { { -1.0f,  0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f }, { 0.0f,  0.0f,  1.0f } }, // NegX
+        { {  0.0f,  0.0f,  1.0f }, { 1.0f,  0.0f,  0.0f }, { 0.0f,  1.0f,  0.0f } }, // PosY
+        { {  0.0f,  0.0f,  1.0f }, {-1.0f,  0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f } }, // NegY
+        { {  0.0f,  0.0f,  1.0f }, { 0.0f, -1.0f,  0.0f }, { 1.0f,  0.0f,  0.0f } }, // PosZ
+        { {  0.0f,  0.0f, -1.0f }, { 0.0f, -1.0f,  0.0f }, {-1.0f,  0.0f,  0.0f } }, // NegZ
+    };
+
+    // ------------------------------------------------------------------------
+    /** Sum the colors of the texels of a cubemap face, weighted by their
+     *  solid angle and by the 9 first SH basis functions (without their
+     *  constant part).
+     *  \param shface The cubemap face (sRGB byte texture)
+     *  \param face Index of the face
+     *  \param edge_size Size of the cubemap face
+     *  \param texel_weights The solid angle and inverse distance of each
+     *         texel, which are the same for all faces
+     *  \param[out] sums The 9 sums for blue, green and red
+     */
+    void projectFace(const unsigned char *shface, unsigned face,
+                     unsigned edge_size, const float *texel_weights,
+                     float sums[9][3])
+    {
+        const float edge_size_inv = 2.0f / edge_size;
+        const float *srgb = g_srgb_to_linear.m_value;
+        // Direction coefficients copied to locals, so they are kept in
+        // registers in the inner loop
+        const float cx = FACE_AXES[face][0][0], cix = FACE_AXES[face][0][1],
+                    cjx = FACE_AXES[face][0][2];
+        const float cy = FACE_AXES[face][1][0], ciy = FACE_AXES[face][1][1],
+                    cjy = FACE_AXES[face][1][2];
+        const float cz = FACE_AXES[face][2][0], ciz = FACE_AXES[face][2][1],
+                    cjz = FACE_AXES[face][2][2];
+#if SIMD_SSE2_SUPPORT
+        __m128 sh0, sh1, sh2, sh3, sh4, sh5, sh6, sh7, sh8;
+        sh0 = sh1 = sh2 = sh3 = sh4 = sh5 = sh6 = sh7 = sh8 = _mm_setzero_ps();
+#else
+        float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f, b3 = 0.0f, b4 = 0.0f,
+              b5 = 0.0f, b6 = 0.0f, b7 = 0.0f, b8 = 0.0f;
+        float g0 = 0.0f, g1 = 0.0f, g2 = 0.0f, g3 = 0.0f, g4 = 0.0f,
+              g5 = 0.0f, g6 = 0.0f, g7 = 0.0f, g8 = 0.0f;
+        float r0 = 0.0f, r1 = 0.0f, r2 = 0.0f, r3 = 0.0f, r4 = 0.0f,
+              r5 = 0.0f, r6 = 0.0f, r7 = 0.0f, r8 = 0.0f;
+#endif
+        for (unsigned i = 0; i < edge_size; i++)
+        {
+            const unsigned char *row = shface + i * edge_size * 4;
+            const float *weights = texel_weights + i * edge_size * 2;
+            const float fi = (float(i) * edge_size_inv) - 1.0f;
+            // Part of the direction which is constant on a line
+            const float rx = cx + cix * fi;
+            const float ry = cy + ciy * fi;
+            const float rz = cz + ciz * fi;
+            for (unsigned j = 0; j < edge_size; j++)
+            {
+                const float fj = (float(j) * edge_size_inv) - 1.0f;
+                const float solidangle = weights[j * 2];
+                const float dinv = weights[j * 2 + 1];
+                const float shx = (rx + cjx * fj) * dinv;
+                const float shy = (ry + cjy * fj) * dinv;
+                const float shz = (rz + cjz * fj) * dinv;
+                const float y20 = (3.0f * shz * shz) - 1.0f;
+                const float y22 = (shx * shx) - (shy * shy);
+#if SIMD_SSE2_SUPPORT
+                const __m128 vrgb = _mm_mul_ps(
+                    _mm_setr_ps( srgb[row[j * 4 + 0]], srgb[row[j * 4 + 1]],
+                                 srgb[row[j * 4 + 2]], 0.0f ),
+                    _mm_set1_ps( solidangle ) );
+                sh0 = _mm_add_ps( sh0, vrgb );
+                sh1 = _mm_add_ps( sh1, _mm_mul_ps( vrgb, _mm_set1_ps( shy ) ) );
+                sh2 = _mm_add_ps( sh2, _mm_mul_ps( vrgb, _mm_set1_ps( shz ) ) );
+                sh3 = _mm_add_ps( sh3, _mm_mul_ps( vrgb, _mm_set1_ps( shx ) ) );
+                sh4 = _mm_add_ps( sh4, _mm_mul_ps( vrgb, _mm_set1_ps( shx * shy ) ) );
+                sh5 = _mm_add_ps( sh5, _mm_mul_ps( vrgb, _mm_set1_ps( shy * shz ) ) );
+                sh6 = _mm_add_ps( sh6, _mm_mul_ps( vrgb, _mm_set1_ps( y20 ) ) );
+                sh7 = _mm_add_ps( sh7, _mm_mul_ps( vrgb, _mm_set1_ps( shx * shz ) ) );
+                sh8 = _mm_add_ps( sh8, _mm_mul_ps( vrgb, _mm_set1_ps( y22 ) ) );
+#else
+                const float b = srgb[row[j * 4 + 0]] * solidangle;
+                const float g = srgb[row[j * 4 + 1]] * solidangle;
+                const float r = srgb[row[j * 4 + 2]] * solidangle;
+                b0 += b; b1 += b * shy; b2 += b * shz; b3 += b * shx;
+                b4 += b * shx * shy; b5 += b * shy * shz; b6 += b * y20;
+                b7 += b * shx * shz; b8 += b * y22;
+                g0 += g; g1 += g * shy; g2 += g * shz; g3 += g * shx;
+                g4 += g * shx * shy; g5 += g * shy * shz; g6 += g * y20;
+                g7 += g * shx * shz; g8 += g * y22;
+                r0 += r; r1 += r * shy; r2 += r * shz; r3 += r * shx;
+                r4 += r * shx * shy; r5 += r * shy * shz; r6 += r * y20;
+                r7 += r * shx * shz; r8 += r * y22;
+#endif
+            }
+        }
+#if SIMD_SSE2_SUPPORT
+        const __m128 sh[9] = { sh0, sh1, sh2, sh3, sh4, sh5, sh6, sh7, sh8 };
+        for (unsigned k = 0; k < 9; k++)
+        {
+            float SIMD_ALIGN16 bgra[4];
+            _mm_store_ps(bgra, sh[k]);
+            sums[k][0] = bgra[0];
+            sums[k][1] = bgra[1];
+            sums[k][2] = bgra[2];
+        }
+#else
+        const float b[9] = { b0, b1, b2, b3, b4, b5, b6, b7, b8 };
+        const float g[9] = { g0, g1, g2, g3, g4, g5, g6, g7, g8 };
+        const float r[9] = { r0, r1, r2, r3, r4, r5, r6, r7, r8 };
+        for (unsigned k = 0; k < 9; k++)
         {
-        case 0: // PosX
-            x = 1.0f;
-            y = -i;
-            z = -j;
-            break;
-        case 1: // NegX
-            x = -1.0f;
-            y = -i;
-            z = j;
-            break;
-        case 2: // PosY
-            x = j;
-            y = 1.0f;
-            z = i;
-            break;
-        case 3: // NegY
-            x = j;
-            y = -1.0f;
-            z = -i;
-            break;
-        case 4: // PosZ
-            x = j;
-            y = -i;
-            z = 1.0f;
-            break;
-        case 5: // NegZ
-            x = -j;
-            y = -i;
-            z = -1.0f;
-            break;
+            sums[k][0] = b[k];
+            sums[k][1] = g[k];
+            sums[k][2] = r[k];
         }
+#endif
+    }   // projectFace
 
-        norminv = 1.0f / sqrtf(x * x + y * y + z * z);
-        x *= norminv, y *= norminv, z *= norminv;
-        return;
-    }   // getXYZ
+    // ------------------------------------------------------------------------
+    /** Return a hash (64-bit FNV-1a of each 32-bit texel) of the 6 cubemap
+     *  faces, used to look up already computed coefficients.
+     *  \param sh_rgba The 6 cubemap faces
+     *  \param width The face width
+     *  \param height The face height
+     */
+    uint64_t hashTextures(unsigned char *sh_rgba[6], unsigned width,
+                          unsigned height)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        hash = (hash ^ width) * 1099511628211ULL;
+        hash = (hash ^ height) * 1099511628211ULL;
+        for (unsigned face = 0; face < 6; face++)
+        {
+            for (unsigned i = 0; i < width * height; i++)
+            {
+                uint32_t texel;
+                memcpy(&texel, sh_rgba[face] + i * 4, 4);
+                hash = (hash ^ texel) * 1099511628211ULL;
+            }
+        }
+        return hash;
+    }   // hashTextures
 
-    
 } //namespace
 
 // ----------------------------------------------------------------------------
 /** Compute m_SH_coeff->red_SH_coeff, m_SH_coeff->green_SH_coeff 
- *  and m_SH_coeff->blue_SH_coeff from Yml values
+ *  and m_SH_coeff->blue_SH_coeff from Yml values. The faces are projected
+ *  in parallel if they are large enough. Each face has its own sums which
+ *  are added in order afterwards, so the result does not depend on the
+ *  number of threads.
  *  \param sh_rgba The 6 cubemap faces (sRGB byte textures)
  *  \param edge_size Size of the cubemap face
  */
 void SphericalHarmonics::generateSphericalHarmonics(unsigned char *sh_rgba[6],
                                                     unsigned int edge_size)
 {
+    // constant part of Ylm, in the order of the coefficients (L00, L1-1,
+    // L10, L11, L2-2, L2-1, L20, L21, L22)
+    const float c[9] =
+    {
+        0.282095f, 0.488603f, 0.488603f, 0.488603f, 1.092548f, 1.092548f,
+        0.315392f, 1.092548f, 0.546274f
+    };
+    float face_sums[6][9][3];
+
+    // The solid angle and distance of a texel only depend on its position in
+    // the face, so they are computed once for all faces
+    std::vector<float> texel_weights(edge_size * edge_size * 2);
+    const float wh = float(edge_size * edge_size);
+    const float edge_size_inv = 2.0f / edge_size;
+    for (unsigned i = 0; i < edge_size; i++)
+    {
+        const float fi = (float(i) * edge_size_inv) - 1.0f;
+        const float fi2p1 = (fi * fi) + 1.0f;
+        for (unsigned j = 0; j < edge_size; j++)
+        {
+            const float fj = (float(j) * edge_size_inv) - 1.0f;
+            const float d = sqrtf(fi2p1 + (fj * fj));
+            // Constant obtained by projecting unprojected ref values
+            texel_weights[(i * edge_size + j) * 2] =
+                2.75f / (wh * sqrtf(d * d * d));
+            texel_weights[(i * edge_size + j) * 2 + 1] = 1.0f / d;
+        }
+    }
 
-#if SIMD_SSE2_SUPPORT
+    unsigned thread_count = std::thread::hardware_concurrency();
+    // Not worth starting threads for small faces (e.g. the ambient light)
+    if (edge_size < 64)
+        thread_count = 1;
+    thread_count = std::max(1u, std::min(6u, thread_count));
 
-    float wh = float(edge_size * edge_size);
-    float edge_size_inv;
-    float fi, fj, fi2p1;
-    unsigned char *shface;
-    __m128 sh0, sh1, sh2, sh3, sh4, sh5, sh6, sh7, sh8;
-
-    // constant part of Ylm
-    const float c00 = 0.282095f;
-    const float c1minus1 = 0.488603f;
-    const float c10 = 0.488603f;
-    const float c11 = 0.488603f;
-    const float c2minus2 = 1.092548f;
-    const float c2minus1 = 1.092548f;
-    const float c21 = 1.092548f;
-    const float c20 = 0.315392f;
-    const float c22 = 0.546274f;
-
-    sh0 = _mm_setzero_ps();
-    sh1 = _mm_setzero_ps();
-    sh2 = _mm_setzero_ps();
-    sh3 = _mm_setzero_ps();
-    sh4 = _mm_setzero_ps();
-    sh5 = _mm_setzero_ps();
-    sh6 = _mm_setzero_ps();
-    sh7 = _mm_setzero_ps();
-    sh8 = _mm_setzero_ps();
-
-    edge_size_inv = 2.0f / edge_size;
-    for (unsigned face = 0; face < 6; face++)
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < thread_count; t++)
     {
-        shface = sh_rgba[face];
-        for (int i = 0; i < int(edge_size); i++)
-        {
-            int shidx = ( i * edge_size ) * 4;
-            fi = (float(i) * edge_size_inv) - 1.0f;
-            fi2p1 = (fi * fi) + 1.0f;
-            for (unsigned j = 0; j < edge_size; j++, shidx += 4)
+        threads.emplace_back([&, t]()
             {
-                float d, solidangle, dinv;
-                float shx, shy, shz;
-                __m128 vrgb;
-
-                fj = (float(j) * edge_size_inv) - 1.0f;
-                d = sqrtf(fi2p1 + (fj * fj));
-                dinv = 1.0f / d;
-                // Constant obtained by projecting unprojected ref values
-                solidangle = 2.75f / (wh * sqrtf(d*d*d));
- #if SIMD_SSE4_1_SUPPORT
-                vrgb = _mm_cvtepi32_ps( _mm_cvtepu8_epi32( _mm_castps_si128( _mm_load_ss( (float *)&shface[shidx+0] ) ) ) );
- #else
-                vrgb = _mm_cvtepi32_ps( _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_castps_si128( _mm_load_ss( (float *)&shface[shidx+0] ) ), _mm_setzero_si128() ), _mm_setzero_si128() ) );
- #endif
-                vrgb = _mm_mul_ps( srgb2linear4( vrgb ), _mm_set1_ps( solidangle ) );
-
-                // TODO: This is very suboptimal, and a pity to break such a streamlined loop
-                // I think people will disapprove if I unroll the 'face' loop 6 times...
-                // What about some branchless vblendps masking?
-                switch (face)
+                for (unsigned face = t; face < 6; face += thread_count)
                 {
-                case 0: // PosX
-                    shx = 1.0f;
-                    shy = -fi;
-                    shz = -fj;
-                    break;
-                case 1: // NegX
-                    shx = -1.0f;
-                    shy = -fi;
-                    shz = fj;
-                    break;
-                case 2: // PosY
-                    shx = fj;
-                    shy = 1.0f;
-                    shz = fi;
-                    break;
-                case 3: // NegY
-                    shx = fj;
-                    shy = -1.0f;
-                    shz = -fi;
-                    break;
-                case 4: // PosZ
-                    shx = fj;
-                    shy = -fi;
-                    shz = 1.0f;
-                    break;
-                case 5: // NegZ
-                    shx = -fj;
-                    shy = -fi;
-                    shz = -1.0f;
-                    break;
+                    projectFace(sh_rgba[face], face, edge_size,
+                                texel_weights.data(), face_sums[face]);
                 }
-                shx *= dinv;
-                shy *= dinv;
-                shz *= dinv;
-
-                sh0 = _mm_add_ps( sh0, vrgb );
-                sh1 = _mm_add_ps( sh1, _mm_mul_ps( vrgb, _mm_set1_ps( shy ) ) );
-                sh2 = _mm_add_ps( sh2, _mm_mul_ps( vrgb, _mm_set1_ps( shz ) ) );
-                sh3 = _mm_add_ps( sh3, _mm_mul_ps( vrgb, _mm_set1_ps( shx ) ) );
-                sh4 = _mm_add_ps( sh4, _mm_mul_ps( vrgb, _mm_set1_ps( shx * shy ) ) );
-                sh5 = _mm_add_ps( sh5, _mm_mul_ps( vrgb, _mm_set1_ps( shy * shz ) ) );
-                sh6 = _mm_add_ps( sh6, _mm_mul_ps( vrgb, _mm_set1_ps( shx * shz ) ) );
-                sh7 = _mm_add_ps( sh7, _mm_mul_ps( vrgb, _mm_set1_ps( ((3.0f * shz * shz) - 1.0f) ) ) );
-                sh8 = _mm_add_ps( sh8, _mm_mul_ps( vrgb, _mm_set1_ps( ((shx * shx) - (shy * shy)) ) ) );
-            }
-        }
+            });
     }
+    for (unsigned face = 0; face < 6; face += thread_count)
+    {
+        projectFace(sh_rgba[face], face, edge_size, texel_weights.data(),
+                    face_sums[face]);
+    }
+    for (std::thread& t : threads)
+        t.join();
 
-    sh0 = _mm_mul_ps( sh0, _mm_set1_ps( c00 ) );
-    sh1 = _mm_mul_ps( sh1, _mm_set1_ps( c1minus1 ) );
-    sh2 = _mm_mul_ps( sh2, _mm_set1_ps( c10 ) );
-    sh3 = _mm_mul_ps( sh3, _mm_set1_ps( c11 ) );
-    sh4 = _mm_mul_ps( sh4, _mm_set1_ps( c2minus2 ) );
-    sh5 = _mm_mul_ps( sh5, _mm_set1_ps( c2minus1 ) );
-    sh6 = _mm_mul_ps( sh6, _mm_set1_ps( c21 ) );
-    sh7 = _mm_mul_ps( sh7, _mm_set1_ps( c20 ) );
-    sh8 = _mm_mul_ps( sh8, _mm_set1_ps( c22 ) );
-
-    m_SH_coeff->blue_SH_coeff[0] = _mm_cvtss_f32( sh0 );
-    m_SH_coeff->blue_SH_coeff[1] = _mm_cvtss_f32( sh1 );
-    m_SH_coeff->blue_SH_coeff[2] = _mm_cvtss_f32( sh2 );
-    m_SH_coeff->blue_SH_coeff[3] = _mm_cvtss_f32( sh3 );
-    m_SH_coeff->blue_SH_coeff[4] = _mm_cvtss_f32( sh4 );
-    m_SH_coeff->blue_SH_coeff[5] = _mm_cvtss_f32( sh5 );
-    m_SH_coeff->blue_SH_coeff[6] = _mm_cvtss_f32( sh6 );
-    m_SH_coeff->blue_SH_coeff[7] = _mm_cvtss_f32( sh7 );
-    m_SH_coeff->blue_SH_coeff[8] = _mm_cvtss_f32( sh8 );
-
-    m_SH_coeff->green_SH_coeff[0] = _mm_cvtss_f32( _mm_shuffle_ps( sh0, sh0, 0x55 ) );
-    m_SH_coeff->green_SH_coeff[1] = _mm_cvtss_f32( _mm_shuffle_ps( sh1, sh1, 0x55 ) );
-    m_SH_coeff->green_SH_coeff[2] = _mm_cvtss_f32( _mm_shuffle_ps( sh2, sh2, 0x55 ) );
-    m_SH_coeff->green_SH_coeff[3] = _mm_cvtss_f32( _mm_shuffle_ps( sh3, sh3, 0x55 ) );
-    m_SH_coeff->green_SH_coeff[4] = _mm_cvtss_f32( _mm_shuffle_ps( sh4, sh4, 0x55 ) );
-    m_SH_coeff->green_SH_coeff[5] = _mm_cvtss_f32( _mm_shuffle_ps( sh5, sh5, 0x55 ) );
-    m_SH_coeff->green_SH_coeff[6] = _mm_cvtss_f32( _mm_shuffle_ps( sh6, sh6, 0x55 ) );
-    m_SH_coeff->green_SH_coeff[7] = _mm_cvtss_f32( _mm_shuffle_ps( sh7, sh7, 0x55 ) );
-    m_SH_coeff->green_SH_coeff[8] = _mm_cvtss_f32( _mm_shuffle_ps( sh8, sh8, 0x55 ) );
-
-    m_SH_coeff->red_SH_coeff[0] = _mm_cvtss_f32( _mm_movehl_ps( sh0, sh0 ) );
-    m_SH_coeff->red_SH_coeff[1] = _mm_cvtss_f32( _mm_movehl_ps( sh1, sh1 ) );
-    m_SH_coeff->red_SH_coeff[2] = _mm_cvtss_f32( _mm_movehl_ps( sh2, sh2 ) );
-    m_SH_coeff->red_SH_coeff[3] = _mm_cvtss_f32( _mm_movehl_ps( sh3, sh3 ) );
-    m_SH_coeff->red_SH_coeff[4] = _mm_cvtss_f32( _mm_movehl_ps( sh4, sh4 ) );
-    m_SH_coeff->red_SH_coeff[5] = _mm_cvtss_f32( _mm_movehl_ps( sh5, sh5 ) );
-    m_SH_coeff->red_SH_coeff[6] = _mm_cvtss_f32( _mm_movehl_ps( sh6, sh6 ) );
-    m_SH_coeff->red_SH_coeff[7] = _mm_cvtss_f32( _mm_movehl_ps( sh7, sh7 ) );
-    m_SH_coeff->red_SH_coeff[8] = _mm_cvtss_f32( _mm_movehl_ps( sh8, sh8 ) );
-
-#else
-
-    float wh = float(edge_size * edge_size);
-    float b0 = 0., b1 = 0., b2 = 0., b3 = 0., b4 = 0., b5 = 0., b6 = 0., b7 = 0., b8 = 0.;
-    float g0 = 0., g1 = 0., g2 = 0., g3 = 0., g4 = 0., g5 = 0., g6 = 0., g7 = 0., g8 = 0.;
-    float r0 = 0., r1 = 0., r2 = 0., r3 = 0., r4 = 0., r5 = 0., r6 = 0., r7 = 0., r8 = 0.;
-    float edge_size_inv;
-    float fi, fj, fi2p1;
-    unsigned char *shface;
-
-    // constant part of Ylm
-    const float c00 = 0.282095f;
-    const float c1minus1 = 0.488603f;
-    const float c10 = 0.488603f;
-    const float c11 = 0.488603f;
-    const float c2minus2 = 1.092548f;
-    const float c2minus1 = 1.092548f;
-    const float c21 = 1.092548f;
-    const float c20 = 0.315392f;
-    const float c22 = 0.546274f;
-
-    edge_size_inv = 2.0f / edge_size;
-    for (unsigned face = 0; face < 6; face++)
+    for (unsigned k = 0; k < 9; k++)
     {
-        shface = sh_rgba[face];
-        for (int i = 0; i < int(edge_size); i++)
+        float b = 0.0f, g = 0.0f, r = 0.0f;
+        for (unsigned face = 0; face < 6; face++)
         {
-            int shidx = ( i * edge_size ) * 4;
-            fi = (float(i) * edge_size_inv) - 1.0f;
-            fi2p1 = (fi * fi) + 1.0f;
-            for (unsigned j = 0; j < edge_size; j++, shidx += 4)
-            {
-                fj = (float(j) * edge_size_inv) - 1.0f;
-
-                float d = sqrtf(fi2p1 + (fj * fj));
-                // Constant obtained by projecting unprojected ref values
-                float solidangle = 2.75f / (wh * sqrtf(d*d*d));
-                float r, g, b;
-                float y00, y1m1, y10, y11, y2m2, y2m1, y21, y20, y22;
-                float shx, shy, shz;
-
-                b = srgb2linear( float(shface[shidx+0]) ) * solidangle;
-                g = srgb2linear( float(shface[shidx+1]) ) * solidangle;
-                r = srgb2linear( float(shface[shidx+2]) ) * solidangle;
-
-                getXYZ(face, fi, fj, shx, shy, shz);
-                y00 = c00;
-                y1m1 = c1minus1 * shy;
-                y10 = c10 * shz;
-                y11 = c11 * shx;
-                y2m2 = c2minus2 * shx * shy;
-                y2m1 = c2minus1 * shy * shz;
-                y21 = c21 * shx * shz;
-                y20 = c20 * ((3.0f * shz * shz) - 1.0f);
-                y22 = c22 * ((shx * shx) - (shy * shy));
-
-                b0 += b * y00;
-                b1 += b * y1m1;
-                b2 += b * y10;
-                b3 += b * y11;
-                b4 += b * y2m2;
-                b5 += b * y2m1;
-                b6 += b * y20;
-                b7 += b * y21;
-                b8 += b * y22;
-
-                g0 += g * y00;
-                g1 += g * y1m1;
-                g2 += g * y10;
-                g3 += g * y11;
-                g4 += g * y2m2;
-                g5 += g * y2m1;
-                g6 += g * y20;
-                g7 += g * y21;
-                g8 += g * y22;
-
-                r0 += r * y00;
-                r1 += r * y1m1;
-                r2 += r * y10;
-                r3 += r * y11;
-                r4 += r * y2m2;
-                r5 += r * y2m1;
-                r6 += r * y20;
-                r7 += r * y21;
-                r8 += r * y22;
-            }
+            b += face_sums[face][k][0];
+            g += face_sums[face][k][1];
+            r += face_sums[face][k][2];
         }
+        m_SH_coeff->blue_SH_coeff[k] = b * c[k];
+        m_SH_coeff->green_SH_coeff[k] = g * c[k];
+        m_SH_coeff->red_SH_coeff[k] = r * c[k];
     }
-
-    m_SH_coeff->blue_SH_coeff[0] = b0;
-    m_SH_coeff->blue_SH_coeff[1] = b1;
-    m_SH_coeff->blue_SH_coeff[2] = b2;
-    m_SH_coeff->blue_SH_coeff[3] = b3;
-    m_SH_coeff->blue_SH_coeff[4] = b4;
-    m_SH_coeff->blue_SH_coeff[5] = b5;
-    m_SH_coeff->blue_SH_coeff[6] = b6;
-    m_SH_coeff->blue_SH_coeff[7] = b7;
-    m_SH_coeff->blue_SH_coeff[8] = b8;
-
-    m_SH_coeff->red_SH_coeff[0] = r0;
-    m_SH_coeff->red_SH_coeff[1] = r1;
-    m_SH_coeff->red_SH_coeff[2] = r2;
-    m_SH_coeff->red_SH_coeff[3] = r3;
-    m_SH_coeff->red_SH_coeff[4] = r4;
-    m_SH_coeff->red_SH_coeff[5] = r5;
-    m_SH_coeff->red_SH_coeff[6] = r6;
-    m_SH_coeff->red_SH_coeff[7] = r7;
-    m_SH_coeff->red_SH_coeff[8] = r8;
-
-    m_SH_coeff->green_SH_coeff[0] = g0;
-    m_SH_coeff->green_SH_coeff[1] = g1;
-    m_SH_coeff->green_SH_coeff[2] = g2;
-    m_SH_coeff->green_SH_coeff[3] = g3;
-    m_SH_coeff->green_SH_coeff[4] = g4;
-    m_SH_coeff->green_SH_coeff[5] = g5;
-    m_SH_coeff->green_SH_coeff[6] = g6;
-    m_SH_coeff->green_SH_coeff[7] = g7;
-    m_SH_coeff->green_SH_coeff[8] = g8;
-
-#endif
-/*
-printf( "#### SH ; Coeffs R ; %f %f %f %f %f %f %f %f\n", m_SH_coeff->red_SH_coeff[0], m_SH_coeff->red_SH_coeff[1], m_SH_coeff->red_SH_coeff[2], m_SH_coeff->red_SH_coeff[3], m_SH_coeff->red_SH_coeff[4], m_SH_coeff->red_SH_coeff[5], m_SH_coeff->red_SH_coeff[6], m_SH_coeff->red_SH_coeff[7] );
-printf( "#### SH ; Coeffs G ; %f %f %f %f %f %f %f %f\n", m_SH_coeff->green_SH_coeff[0], m_SH_coeff->green_SH_coeff[1], m_SH_coeff->green_SH_coeff[2], m_SH_coeff->green_SH_coeff[3], m_SH_coeff->green_SH_coeff[4], m_SH_coeff->green_SH_coeff[5], m_SH_coeff->green_SH_coeff[6], m_SH_coeff->green_SH_coeff[7] );
-printf( "#### SH ; Coeffs B ; %f %f %f %f %f %f %f %f\n", m_SH_coeff->blue_SH_coeff[0], m_SH_coeff->blue_SH_coeff[1], m_SH_coeff->blue_SH_coeff[2], m_SH_coeff->blue_SH_coeff[3], m_SH_coeff->blue_SH_coeff[4], m_SH_coeff->blue_SH_coeff[5], m_SH_coeff->blue_SH_coeff[6], m_SH_coeff->blue_SH_coeff[7] );
-*/
-}   // projectSH
+}   // generateSphericalHarmonics
 
 // ----------------------------------------------------------------------------
 SphericalHarmonics::SphericalHarmonics(const std::vector<video::IImage *> &spherical_harmonics_textures)
@@ -563,7 +397,17 @@ void SphericalHarmonics::setTextures(const std::vector<video::IImage *> &spheric
         m_spherical_harmonics_textures[idx]->drop();
     } //for (unsigned i = 0; i < 6; i++)
 
-    generateSphericalHarmonics(sh_rgba, sh_w);
+    const uint64_t hash = hashTextures(sh_rgba, sh_w, sh_h);
+    auto it = m_cached_coefficients.find(hash);
+    if (it != m_cached_coefficients.end())
+    {
+        *m_SH_coeff = it->second;
+    }
+    else
+    {
+        generateSphericalHarmonics(sh_rgba, sh_w);
+        m_cached_coefficients[hash] = *m_SH_coeff;
+    }
 
     for (unsigned i = 0; i < 6; i++)
         delete[] sh_rgba[i];
@@ -20,6 +20,8 @@
 #define HEADER_SPHERICAL_HARMONICS_HPP
 
 #include <ITexture.h>
+#include <cstdint>
+#include <map>
 #include <vector>
 
 struct Color
@@ -49,6 +51,11 @@ private:
     /** The spherical harmonics coefficients */
     SHCoefficients *m_SH_coeff;
 
+    /** Coefficients computed from textures, indexed by a hash of the
+     *  texture data, so a track which is loaded again (or another track
+     *  with the same skybox) does not need to compute them again. */
+    static std::map<uint64_t, SHCoefficients> m_cached_coefficients;
+
     void generateSphericalHarmonics(unsigned char *sh_rgba[6], unsigned int edge_size);
     
 public:
@@ -23,6 +23,7 @@
 #include "guiengine/engine.hpp"
 #include "io/file_manager.hpp"
 #include "utils/string_utils.hpp"
+#include "utils/time.hpp"
 #include "utils/log.hpp"
 
 #include <algorithm>
@@ -220,6 +221,49 @@ int STKTexManager::dumpTextureUsage()
     return size;
 }   // dumpTextureUsage
 
+// ----------------------------------------------------------------------------
+/** Decodes the images of many textures in parallel, so that the following
+ *  getTexture calls with the same paths only need to upload them. This is
+ *  used for screens which load a lot of small textures at once (like kart
+ *  icons or track screenshots). Vulkan textures are already loaded in a
+ *  separate thread, so nothing is done there.
+ *  \param paths Full paths of the textures, textures already loaded are
+ *         skipped.
+ */
+void STKTexManager::prefetchTextures(const std::vector<std::string>& paths)
+{
+#ifndef SERVER_ONLY
+    if (GUIEngine::isNoGraphics() || GE::getVKDriver())
+        return;
+
+    std::vector<std::string> todo;
+    for (const std::string& path : paths)
+    {
+        if (path.empty() || path.find('/') == std::string::npos ||
+            m_all_textures.find(path) != m_all_textures.end())
+            continue;
+        todo.push_back(path);
+    }
+    if (todo.empty())
+        return;
+
+    uint64_t start = StkTime::getMonoTimeMs();
+    GE::prefetchImages(todo);
+    Log::debug("STKTexManager", "Decoded %u images in %d ms.",
+        (unsigned)todo.size(), (int)(StkTime::getMonoTimeMs() - start));
+#endif
+}   // prefetchTextures
+
+// ----------------------------------------------------------------------------
+/** Frees the images decoded by prefetchTextures which were not used by any
+ *  texture. */
+void STKTexManager::clearPrefetchedTextures()
+{
+#ifndef SERVER_ONLY
+    GE::clearPrefetchedImages();
+#endif
+}   // clearPrefetchedTextures
+
 // ----------------------------------------------------------------------------
 bool STKTexManager::hasTexture(const std::string& path)
 {
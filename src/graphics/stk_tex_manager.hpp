@@ -29,6 +29,7 @@
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class STKTexture;
 namespace irr
@@ -57,6 +58,10 @@ public:
     irr::video::ITexture* getTexture(const std::string& path,
                 std::function<void(irr::video::IImage*)> image_mani = nullptr);
     // ------------------------------------------------------------------------
+    void prefetchTextures(const std::vector<std::string>& paths);
+    // ------------------------------------------------------------------------
+    void clearPrefetchedTextures();
+    // ------------------------------------------------------------------------
     irr::video::ITexture* addTexture(irr::video::ITexture* texture);
     // ------------------------------------------------------------------------
     bool hasTexture(const std::string& path);
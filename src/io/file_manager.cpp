@@ -655,6 +655,7 @@ void FileManager::pushModelSearchPath(const std::string& path)
         // (which has index n) to position 0 (by -n positions):
         m_file_system->moveFileArchive(n, -n);
     }
+    pushAssetPack(path);
 }   // pushModelSearchPath
 
 //-----------------------------------------------------------------------------
@@ -685,8 +686,118 @@ void FileManager::pushTextureSearchPath(const std::string& path, const std::stri
         // (which has index n) to position 0 (by -n positions):
         m_file_system->moveFileArchive(n, -n);
     }
+    pushAssetPack(path);
 }   // pushTextureSearchPath
 
+//-----------------------------------------------------------------------------
+/** Returns the name of the asset pack of a kart or track directory.
+ */
+std::string FileManager::getAssetPack(const std::string& path) const
+{
+    if (!path.empty() && path[path.size() - 1] == '/')
+        return path + "assets.stkpack";
+    return path + "/assets.stkpack";
+}   // getAssetPack
+
+//-----------------------------------------------------------------------------
+/** If the given kart or track directory contains an asset pack (see
+ *  tools/create_asset_pack.py), adds it in front of all other file archives,
+ *  so that files of this directory are read from the memory mapped pack
+ *  instead of being opened one by one. The directory itself is still
+ *  searched for any file which is not in the pack. A pack is ignored if it
+ *  is stale, see isAssetPackUpToDate().
+ *  \param path The directory which might contain a pack.
+ */
+void FileManager::pushAssetPack(const std::string& path)
+{
+    const std::string pack = getAssetPack(path);
+    if (!fileExists(pack))
+        return;
+
+    std::unique_lock<std::recursive_mutex> ul = m_file_system->acquireFileArchivesMutex();
+    const int n = m_file_system->getFileArchiveCount();
+    m_file_system->addFileArchive(createAbsoluteFilename(pack),
+                                  /*ignoreCase*/false,
+                                  /*ignorePaths*/false,
+                                  io::EFAT_STKPACK);
+    // Nothing to do if the pack was already added, or is invalid
+    if ((int)m_file_system->getFileArchiveCount() <= n)
+        return;
+
+    io::IFileArchive* archive = m_file_system->getFileArchive(n);
+    if (!isAssetPackUpToDate(pack, archive))
+    {
+        m_file_system->removeFileArchive(archive);
+        return;
+    }
+    if (n > 0)
+        m_file_system->moveFileArchive(n, -n);
+}   // pushAssetPack
+
+//-----------------------------------------------------------------------------
+/** Checks that the directory of an asset pack was not changed after the
+ *  pack was created, since the loose files are the authoritative source.
+ *  Normally only the modification time of the directory is compared with
+ *  the one of the pack, which catches files being added, removed or
+ *  replaced. In artist debug mode each file of the pack is checked too, so
+ *  that files edited in place are also noticed while working on a kart or
+ *  track.
+ *  \param pack Name of the pack file.
+ *  \param archive The file archive of the pack.
+ */
+bool FileManager::isAssetPackUpToDate(const std::string& pack,
+                                      io::IFileArchive* archive) const
+{
+    struct stat pack_stat;
+    if (FileUtils::statU8Path(pack, &pack_stat) < 0)
+        return false;
+
+    // Directory of the pack, including the trailing '/'
+    const std::string dir = pack.substr(0, pack.find_last_of('/') + 1);
+    // Windows can not stat a directory name with a trailing '/'
+    struct stat dir_stat;
+    if (FileUtils::statU8Path(dir.substr(0, dir.size() - 1), &dir_stat) < 0 ||
+        dir_stat.st_mtime > pack_stat.st_mtime)
+    {
+        Log::warn("FileManager", "Ignoring stale asset pack '%s': "
+                  "'%s' was changed after it was created.", pack.c_str(),
+                  dir.c_str());
+        return false;
+    }
+
+    if (!UserConfigParams::m_artist_debug_mode)
+        return true;
+
+    const io::IFileList* files = archive->getFileList();
+    for (unsigned int i = 0; i < files->getFileCount(); i++)
+    {
+        if (files->isDirectory(i))
+            continue;
+        const std::string file = dir + files->getFullFileName(i).c_str();
+        struct stat file_stat;
+        if (FileUtils::statU8Path(file, &file_stat) < 0 ||
+            file_stat.st_mtime > pack_stat.st_mtime)
+        {
+            Log::warn("FileManager", "Ignoring stale asset pack '%s': "
+                      "'%s' was changed after it was created.", pack.c_str(),
+                      file.c_str());
+            return false;
+        }
+    }
+    return true;
+}   // isAssetPackUpToDate
+
+//-----------------------------------------------------------------------------
+/** Removes the asset pack of the given directory, if one was added.
+ *  \param path The directory which might contain a pack.
+ */
+void FileManager::popAssetPack(const std::string& path)
+{
+    const std::string pack = getAssetPack(path);
+    if (fileExists(pack))
+        m_file_system->removeFileArchive(createAbsoluteFilename(pack));
+}   // popAssetPack
+
 //-----------------------------------------------------------------------------
 /** Removes the last added texture search path from the list of paths.
  */
@@ -697,6 +808,7 @@ void FileManager::popTextureSearchPath()
         TextureSearchPath dir = m_texture_search_path.back();
         m_texture_search_path.pop_back();
         m_file_system->removeFileArchive(createAbsoluteFilename(dir.m_texture_search_path));
+        popAssetPack(dir.m_texture_search_path);
     }
 }   // popTextureSearchPath
 
@@ -710,6 +822,7 @@ void FileManager::popModelSearchPath()
         std::string dir = m_model_search_path.back();
         m_model_search_path.pop_back();
         m_file_system->removeFileArchive(createAbsoluteFilename(dir));
+        popAssetPack(dir);
     }
 }   // popModelSearchPath
 
@@ -1650,3 +1763,111 @@ bool FileManager::moveDirectoryInto(std::string source, std::string target)
     return rename(source.c_str(), target.c_str()) != -1;
 #endif
 }   // moveDirectoryInto
+
+// ----------------------------------------------------------------------------
+/** Tests reading asset packs (see tools/create_asset_pack.py), especially
+ *  that invalid index entries are rejected.
+ */
+void FileManager::unitTesting()
+{
+    struct Entry
+    {
+        uint32_t m_offset, m_size;
+        std::string m_name;
+    };
+    // Creates a pack with the given entries, followed by the data
+    auto create_pack = [](const std::vector<Entry>& entries,
+                          const std::string& data, uint32_t version = 1,
+                          uint32_t extra_index_size = 0)
+    {
+        std::string pack = "STKPACK1";
+        auto add_u32 = [&pack](uint32_t v)
+        {
+            for (int i = 0; i < 4; i++)
+                pack += (char)((v >> (8 * i)) & 0xff);
+        };
+        std::string index;
+        for (const Entry& e : entries)
+        {
+            for (int i = 0; i < 4; i++)
+                index += (char)((e.m_offset >> (8 * i)) & 0xff);
+            for (int i = 0; i < 4; i++)
+                index += (char)((e.m_size >> (8 * i)) & 0xff);
+            index += (char)(e.m_name.size() & 0xff);
+            index += (char)(e.m_name.size() >> 8);
+            index += e.m_name;
+        }
+        add_u32(version);
+        add_u32((uint32_t)entries.size());
+        add_u32((uint32_t)index.size() + extra_index_size);
+        add_u32(1);
+        return pack + index + data;
+    };
+    // Returns the pack as file archive, or NULL if it is rejected
+    auto add_pack = [this](const std::string& pack) -> io::IFileArchive*
+    {
+        io::IReadFile* file = m_file_system->createMemoryReadFile(
+            (void*)pack.data(), (s32)pack.size(),
+            "stkpack-unit-test/assets.stkpack", false);
+        io::IFileArchive* archive = NULL;
+        m_file_system->addFileArchive(file, false, false, io::EFAT_STKPACK,
+                                      "", &archive);
+        file->drop();
+        return archive;
+    };
+
+    // Header of 24 bytes, index of 10 + name length bytes per entry
+    const uint32_t data_start = 24 + 15 + 19;
+    std::string pack = create_pack({ { data_start, 5, "a.txt" },
+                                     { data_start + 5, 3, "sub/b.xml" } },
+                                   "hello<a>");
+    io::IFileArchive* archive = add_pack(pack);
+    assert(archive && archive->getFileList()->getFileCount() == 2);
+    char buffer[8] = {};
+    io::IReadFile* f = archive->createAndOpenFile("a.txt");
+    assert(f && f->getSize() == 5);
+    f->read(buffer, 5);
+    assert(memcmp(buffer, "hello", 5) == 0);
+    f->drop();
+    // Files can also be opened by their path
+    f = archive->createAndOpenFile("stkpack-unit-test/sub/b.xml");
+    assert(f && f->getSize() == 3);
+    f->read(buffer, 3);
+    assert(memcmp(buffer, "<a>", 3) == 0);
+    f->drop();
+    assert(archive->createAndOpenFile("c.txt") == NULL);
+    m_file_system->removeFileArchive(archive);
+
+    // Data start of a pack with only a.txt
+    const uint32_t single_start = 24 + 15;
+    archive = add_pack(create_pack({ { single_start, 5, "a.txt" } }, "hello"));
+    assert(archive);
+    m_file_system->removeFileArchive(archive);
+
+    // Wrong magic or version
+    std::string bad = pack;
+    bad[0] = 'X';
+    assert(add_pack(bad) == NULL);
+    assert(add_pack(create_pack({ { single_start, 5, "a.txt" } }, "hello",
+                                /*version*/2)) == NULL);
+    // Truncated file
+    assert(add_pack(pack.substr(0, 20)) == NULL);
+    // Index larger than the file
+    assert(add_pack(create_pack({ { single_start, 5, "a.txt" } }, "hello", 1,
+                                /*extra_index_size*/1000)) == NULL);
+    // More files than index entries
+    bad = pack;
+    bad[12] = 3;
+    assert(add_pack(bad) == NULL);
+    // Name longer than the index
+    bad = pack;
+    bad[24 + 8] = (char)200;
+    assert(add_pack(bad) == NULL);
+    // Data outside of the pack, and size overflowing the offset
+    assert(add_pack(create_pack({ { single_start, 6, "a.txt" } }, "hello"))
+           == NULL);
+    assert(add_pack(create_pack({ { 0xfffffff0u, 0x20, "a.txt" } }, "hello"))
+           == NULL);
+    assert(add_pack(create_pack({ { single_start, 0xffffffffu, "a.txt" } },
+                                "hello")) == NULL);
+}   // unitTesting
@@ -33,7 +33,7 @@
 namespace irr
 {
     class IrrlichtDevice;
-    namespace io { class IFileSystem; }
+    namespace io { class IFileArchive; class IFileSystem; }
 }
 using namespace irr;
 
@@ -131,6 +131,10 @@ private:
     void              checkAndCreateGPDir();
     void              discoverPaths();
     void              addAssetsSearchPath();
+    void              pushAssetPack(const std::string& path);
+    bool              isAssetPackUpToDate(const std::string& pack,
+                                          io::IFileArchive* archive) const;
+    void              popAssetPack(const std::string& path);
     void              resetSubdir();
 #if !defined(WIN32) && !defined(__APPLE__)
     std::string       checkAndCreateLinuxDir(const char *env_name,
@@ -155,6 +159,7 @@ public:
     std::string       getReplayDir() const;
     std::string       getCachedTexturesDir() const;
     std::string       getGPDir() const;
+    std::string       getAssetPack(const std::string& path) const;
     bool              checkAndCreateDirectory(const std::string &path);
     bool              checkAndCreateDirectoryP(const std::string &path);
     const std::string &getAddonsDir() const;
@@ -212,6 +217,7 @@ public:
     void       redirectOutput();
 
     bool       fileIsNewer(const std::string& f1, const std::string& f2) const;
+    void       unitTesting();
     // ------------------------------------------------------------------------
     const std::string& getUserConfigDir() const   { return m_user_config_dir; }
     // ------------------------------------------------------------------------
@@ -0,0 +1,127 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "io/file_prefetcher.hpp"
+
+#include "utils/file_utils.hpp"
+#include "utils/log.hpp"
+#include "utils/time.hpp"
+#include "utils/vs.hpp"
+
+#include <algorithm>
+#include <set>
+#include <stdio.h>
+
+// ----------------------------------------------------------------------------
+FilePrefetcher::FilePrefetcher()
+{
+    m_cancel.store(false);
+    m_skip_current_file.store(false);
+}   // FilePrefetcher
+
+// ----------------------------------------------------------------------------
+FilePrefetcher::~FilePrefetcher()
+{
+    cancel();
+}   // ~FilePrefetcher
+
+// ----------------------------------------------------------------------------
+/** Stops reading the files of a previous prefetch() call, and starts reading
+ *  the given files in a separate thread.
+ *  \param files Full paths of the files, the most important ones first.
+ */
+void FilePrefetcher::prefetch(const std::vector<std::string>& files)
+{
+    cancel();
+    if (files.empty())
+        return;
+    m_files.assign(files.begin(), files.end());
+    m_cancel.store(false);
+    m_thread = std::thread(&FilePrefetcher::readFiles, this);
+}   // prefetch
+
+// ----------------------------------------------------------------------------
+/** Removes all files which are not in the given list from the files still to
+ *  be read, and stops reading the current file if it is not in the list.
+ *  Files which are not yet read keep their order.
+ *  \param files Full paths of the files to keep.
+ */
+void FilePrefetcher::keepOnly(const std::vector<std::string>& files)
+{
+    std::set<std::string> keep(files.begin(), files.end());
+    std::lock_guard<std::mutex> lock(m_files_mutex);
+    m_files.erase(std::remove_if(m_files.begin(), m_files.end(),
+        [&keep](const std::string& f) { return keep.count(f) == 0; }),
+        m_files.end());
+    if (!m_current_file.empty() && keep.count(m_current_file) == 0)
+        m_skip_current_file.store(true);
+}   // keepOnly
+
+// ----------------------------------------------------------------------------
+/** Stops reading files, and waits for the thread to finish.
+ */
+void FilePrefetcher::cancel()
+{
+    m_cancel.store(true);
+    if (m_thread.joinable())
+        m_thread.join();
+    m_files.clear();
+}   // cancel
+
+// ----------------------------------------------------------------------------
+/** Reads all files, the content is discarded. The cancel flags are checked
+ *  after each block, so cancel() and keepOnly() do not have to wait for big
+ *  files.
+ */
+void FilePrefetcher::readFiles()
+{
+    VS::setThreadName("FilePrefetcher");
+    const uint64_t start = StkTime::getMonoTimeMs();
+    size_t total = 0;
+    unsigned count = 0;
+    std::vector<char> buffer(256 * 1024);
+    while (!m_cancel.load())
+    {
+        std::unique_lock<std::mutex> ul(m_files_mutex);
+        if (m_files.empty())
+        {
+            m_current_file.clear();
+            break;
+        }
+        m_current_file = m_files.front();
+        m_files.pop_front();
+        m_skip_current_file.store(false);
+        const std::string name = m_current_file;
+        ul.unlock();
+
+        FILE* fp = FileUtils::fopenU8Path(name, "rb");
+        if (!fp)
+            continue;
+        size_t n;
+        while (!m_cancel.load() && !m_skip_current_file.load() &&
+               (n = fread(buffer.data(), 1, buffer.size(), fp)) > 0)
+            total += n;
+        fclose(fp);
+        count++;
+    }
+    if (m_cancel.load())
+        return;
+    Log::debug("FilePrefetcher", "Read %u files (%u kB) in %dms.",
+        count, (unsigned)(total / 1024),
+        (int)(StkTime::getMonoTimeMs() - start));
+}   // readFiles
@@ -0,0 +1,69 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_FILE_PREFETCHER_HPP
+#define HEADER_FILE_PREFETCHER_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Reads a list of files in a separate thread, so that they are in the
+ *  operating system's file cache when they are loaded later. This is used
+ *  to read the files of the most voted tracks while players are voting.
+ *  Nothing is parsed or kept in memory by this class itself, so it is safe
+ *  to prefetch files which are never loaded.
+ * \ingroup io
+ */
+class FilePrefetcher : public NoCopy
+{
+private:
+    /** The thread reading the files. */
+    std::thread m_thread;
+
+    /** Set to stop the thread before it has read all files. */
+    std::atomic<bool> m_cancel;
+
+    /** Protects m_files and m_current_file. */
+    std::mutex m_files_mutex;
+
+    /** The files which were not read yet. */
+    std::deque<std::string> m_files;
+
+    /** The file which is being read. */
+    std::string m_current_file;
+
+    /** Set to stop reading m_current_file, and continue with the next. */
+    std::atomic<bool> m_skip_current_file;
+
+    void readFiles();
+public:
+    FilePrefetcher();
+    ~FilePrefetcher();
+    void prefetch(const std::vector<std::string>& files);
+    void keepOnly(const std::vector<std::string>& files);
+    void cancel();
+};   // FilePrefetcher
+
+#endif
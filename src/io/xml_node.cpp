@@ -23,7 +23,12 @@
 #include "utils/string_utils.hpp"
 #include "utils/vec3.hpp"
 
+#include <IFileSystem.h>
+#include <IReadFile.h>
+
+#include <assert.h>
 #include <stdexcept>
+#include <wchar.h>
 
 XMLNode::XMLNode(io::IXMLReader *xml)
 {
@@ -664,3 +669,83 @@ bool XMLNode::hasChildNamed(const char* name) const
     }
     return false;
 }
+
+// ----------------------------------------------------------------------------
+/** Tests the XML reader (names and attributes are parsed in place in its
+ *  buffer) and the conversion into a XMLNode tree.
+ */
+void XMLNode::unitTesting()
+{
+    std::string s =
+        "<?xml version=\"1.0\"?>\n"
+        "<root a=\"1\" b='2.5' name=\"x &amp; &lt;y&gt; &quot;z&quot;\">\n"
+        "  <!-- comment -->\n"
+        "  <child id=\"7\"/>\n"
+        "  <child id=\"-8\" empty=\"\"></child>\n"
+        "  <text>a &amp; b</text>\n"
+        "</root>\n";
+
+    // Test the reader directly, the XMLNode tree copies all strings
+    char *b = new char[s.size()];
+    memcpy(b, s.c_str(), s.size());
+    io::IFileSystem *fs = file_manager->getFileSystem();
+    io::IReadFile *file = fs->createMemoryReadFile(b, (int)s.size(),
+                                                   "unittest.xml", true);
+    io::IXMLReader *xml = fs->createXMLReader(file);
+    while (xml->read() && xml->getNodeType() != io::EXN_ELEMENT) {}
+    const wchar_t *root_name = xml->getNodeName();
+    assert(wcscmp(root_name, L"root") == 0);
+    assert(xml->getAttributeCount() == 3);
+    assert(wcscmp(xml->getAttributeName(0), L"a") == 0);
+    assert(xml->getAttributeValueAsInt(L"a") == 1);
+    assert(xml->getAttributeValueAsFloat(L"b") == 2.5f);
+    assert(wcscmp(xml->getAttributeValue(L"name"),
+                  L"x & <y> \"z\"") == 0);
+    assert(xml->getAttributeValue(L"missing") == NULL);
+    assert(wcscmp(xml->getAttributeValueSafe(L"missing"), L"") == 0);
+    assert(!xml->isEmptyElement());
+
+    int children = 0;
+    bool found_text = false;
+    while (xml->read())
+    {
+        if (xml->getNodeType() == io::EXN_ELEMENT &&
+            wcscmp(xml->getNodeName(), L"child") == 0)
+        {
+            children++;
+            assert(xml->isEmptyElement() == (children == 1));
+            assert(xml->getAttributeValueAsInt(L"id") ==
+                   (children == 1 ? 7 : -8));
+        }
+        else if (xml->getNodeType() == io::EXN_TEXT &&
+                 wcscmp(xml->getNodeData(), L"a & b") == 0)
+        {
+            found_text = true;
+        }
+    }
+    assert(children == 2);
+    assert(found_text);
+    (void)found_text;  // avoid warning about unused variable
+    // Names stay valid for the lifetime of the reader
+    assert(wcscmp(root_name, L"root") == 0);
+    (void)root_name;  // avoid warning about unused variable
+    xml->drop();
+    file->drop();
+
+    XMLNode *root = file_manager->createXMLTreeFromString(s);
+    assert(root && root->getName() == "root");
+    assert(root->getNumNodes() == 3);
+    std::string name;
+    assert(root->get("name", &name) == 1 && name == "x & <y> \"z\"");
+    int id = 0;
+    assert(root->getNode(1)->get("id", &id) == 1 && id == -8);
+    (void)id;  // avoid warning about unused variable
+    assert(root->getNode(1)->get("empty", &name) == 1 && name.empty());
+    assert(root->getNode(2)->getName() == "text");
+    delete root;
+
+    // A truncated document must not read past the end of the buffer
+    XMLNode *truncated =
+        file_manager->createXMLTreeFromString("<root a=\"1\"><child b=\"");
+    delete truncated;
+}   // unitTesting
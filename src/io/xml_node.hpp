@@ -100,6 +100,8 @@ public:
 
     bool hasChildNamed(const char* name) const;
 
+    static void unitTesting();
+
     /** Handy functions to test the bit pattern returned by get(vector3df*).*/
     static bool hasX(int b) { return (b&1)==1; }
     static bool hasY(int b) { return (b&2)==2; }
@@ -42,8 +42,8 @@
 #include "karts/explosion_animation.hpp"
 #include "modes/linear_world.hpp"
 #include "network/compress_network_body.hpp"
+#include "network/network_bit_stream.hpp"
 #include "network/network_config.hpp"
-#include "network/network_string.hpp"
 #include "network/rewind_manager.hpp"
 #include "physics/physics.hpp"
 #include "tracks/track.hpp"
@@ -664,19 +664,19 @@ void Flyable::moveToInfinity(bool set_moveable_trans)
 }   // moveToInfinity
 
 // ----------------------------------------------------------------------------
-BareNetworkString* Flyable::saveState(std::vector<std::string>* ru)
+BareNetworkString* Flyable::saveState(std::vector<uint8_t>* ru)
 {
     if (m_has_hit_something)
         return NULL;
 
-    ru->push_back(getUniqueIdentity());
+    ru->push_back((uint8_t)getRewinderID());
 
     BareNetworkString* buffer = new BareNetworkString();
-    uint16_t ticks_since_thrown_animation = (m_ticks_since_thrown & 32767) |
-        (hasAnimation() ? 32768 : 0);
-    buffer->addUInt16(ticks_since_thrown_animation);
+    NetworkBitWriter writer(buffer);
+    writer.addBool(hasAnimation()).addVarUInt(m_ticks_since_thrown & 32767);
     if (m_do_terrain_info)
-        buffer->addUInt32(m_compressed_gravity_vector);
+        writer.addBits(m_compressed_gravity_vector, 32);
+    writer.flush();
 
     if (hasAnimation())
         m_animation->saveState(buffer);
@@ -691,11 +691,12 @@ BareNetworkString* Flyable::saveState(std::vector<std::string>* ru)
 // ----------------------------------------------------------------------------
 void Flyable::restoreState(BareNetworkString *buffer, int count)
 {
-    uint16_t ticks_since_thrown_animation = buffer->getUInt16();
-    bool has_animation_in_state =
-        (ticks_since_thrown_animation >> 15 & 1) == 1;
+    NetworkBitReader reader(buffer);
+    bool has_animation_in_state = reader.getBool();
+    uint16_t ticks_since_thrown = (uint16_t)reader.getVarUInt();
     if (m_do_terrain_info)
-        m_compressed_gravity_vector = buffer->getUInt32();
+        m_compressed_gravity_vector = reader.getBits(32);
+    reader.align();
 
     if (has_animation_in_state)
     {
@@ -729,7 +730,7 @@ void Flyable::restoreState(BareNetworkString *buffer, int count)
             buffer, m_body.get(), m_motion_state.get());
         m_transform = m_body->getWorldTransform();
     }
-    m_ticks_since_thrown = ticks_since_thrown_animation & 32767;
+    m_ticks_since_thrown = ticks_since_thrown & 32767;
     m_has_server_state = true;
     m_has_hit_something = false;
 }   // restoreState
@@ -18,8 +18,8 @@
 
 #include "items/item_event_info.hpp"
 
+#include "network/network_bit_stream.hpp"
 #include "network/network_config.hpp"
-#include "network/network_string.hpp"
 #include "network/protocols/game_protocol.hpp"
 #include "network/rewind_manager.hpp"
 #include "network/stk_host.hpp"
@@ -27,30 +27,33 @@
 
 /** Loads an event from a server message. It helps encapsulate the encoding
  *  of events from and into a message buffer.
- *  \param buffer A network string with the event data.
- *  \param count The number of bytes read will be subtracted from this value.
+ *  \param reader The bit reader of the network string with the event data.
+ *  \param prev_ticks Time of the previous event (or the state for the first
+ *         event), the time of this event is saved relative to it. It will
+ *         be updated to the time of this event.
  */
-ItemEventInfo::ItemEventInfo(BareNetworkString *buffer, int *count)
+ItemEventInfo::ItemEventInfo(NetworkBitReader *reader, int *prev_ticks)
 {
     m_ticks_till_return = 0;
-    m_type    = (EventType)buffer->getUInt8();
-    m_ticks   = buffer->getTime();
-    *count   -= 5;
+    m_type    = (EventType)reader->getBits(2);
+    m_ticks   = *prev_ticks + reader->getVarInt();
+    *prev_ticks = m_ticks;
     if (m_type != IEI_SWITCH)
     {
-        m_kart_id = buffer->getInt8();
-        m_index = buffer->getUInt16();
-        *count -= 3;
+        m_kart_id = reader->getVarInt();
+        m_index = reader->getVarUInt();
         if (m_type == IEI_NEW)
         {
-            m_xyz = buffer->getVec3();
-            m_normal = buffer->getVec3();
-            *count -= 24;
+            m_xyz.setX(reader->getFloat());
+            m_xyz.setY(reader->getFloat());
+            m_xyz.setZ(reader->getFloat());
+            m_normal.setX(reader->getFloat());
+            m_normal.setY(reader->getFloat());
+            m_normal.setZ(reader->getFloat());
         }
         else   // IEI_COLLECT
         {
-            m_ticks_till_return = buffer->getUInt16();
-            *count -= 2;
+            m_ticks_till_return = (int16_t)reader->getVarInt();
         }
     }   // is not switch
     else   // switch
@@ -58,26 +61,31 @@ ItemEventInfo::ItemEventInfo(BareNetworkString *buffer, int *count)
         m_index = -1;
         m_kart_id = -1;
     }
-}   // ItemEventInfo(BareNetworkString, int *count)
+}   // ItemEventInfo(NetworkBitReader, int *prev_ticks)
 
 //-----------------------------------------------------------------------------
 /** Stores this event into a network string.
- *  \param buffer The network string to which the data should be appended.
+ *  \param writer The bit writer to which the data should be appended.
+ *  \param prev_ticks Time of the previous event saved (or the state for the
+ *         first event). It will be updated to the time of this event.
  */
-void ItemEventInfo::saveState(BareNetworkString *buffer)
+void ItemEventInfo::saveState(NetworkBitWriter *writer, int *prev_ticks)
 {
     assert(NetworkConfig::get()->isServer());
-    buffer->addUInt8(m_type).addTime(m_ticks);
+    writer->addBits(m_type, 2).addVarInt(m_ticks - *prev_ticks);
+    *prev_ticks = m_ticks;
     if (m_type != IEI_SWITCH)
     {
         // Only new item and collecting items need the index and kart id:
-        buffer->addUInt8(m_kart_id).addUInt16(m_index);
+        writer->addVarInt(m_kart_id).addVarUInt(m_index);
         if (m_type == IEI_NEW)
         {
-            buffer->add(m_xyz);
-            buffer->add(m_normal);
+            writer->addFloat(m_xyz.getX()).addFloat(m_xyz.getY())
+                .addFloat(m_xyz.getZ());
+            writer->addFloat(m_normal.getX()).addFloat(m_normal.getY())
+                .addFloat(m_normal.getZ());
         }
         else if (m_type == IEI_COLLECT)
-            buffer->addUInt16(m_ticks_till_return);
+            writer->addVarInt(m_ticks_till_return);
     }
 }   // saveState
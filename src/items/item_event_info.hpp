@@ -25,7 +25,8 @@
 
 #include <assert.h>
 
-class BareNetworkString;
+class NetworkBitReader;
+class NetworkBitWriter;
 
 // ------------------------------------------------------------------------
 /** This class stores a delta, i.e. an item event (either collection of
@@ -94,8 +95,8 @@ public:
     }   // ItemEventInfo(switch)
 
     // --------------------------------------------------------------------
-         ItemEventInfo(BareNetworkString *buffer, int *count);
-    void saveState(BareNetworkString *buffer);
+         ItemEventInfo(NetworkBitReader *reader, int *prev_ticks);
+    void saveState(NetworkBitWriter *writer, int *prev_ticks);
 
     // --------------------------------------------------------------------
     /** Returns if this event represents a new item. */
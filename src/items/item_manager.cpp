@@ -30,6 +30,7 @@
 #include "modes/easter_egg_hunt.hpp"
 #include "modes/profile_world.hpp"
 #include "network/network_config.hpp"
+#include "network/network_string.hpp"
 #include "network/race_event_manager.hpp"
 #include "physics/triangle_mesh.hpp"
 #include "tracks/arena_graph.hpp"
@@ -590,6 +591,71 @@ void ItemManager::switchItemsInternal(std::vector<ItemState*> &all_items)
 
 }   // switchItems
 
+//-----------------------------------------------------------------------------
+/** Saves the state of all items for a keyframe of a history (see
+ *  History::saveKeyFrame()).
+ *  \param buffer The buffer to write the state to.
+ */
+void ItemManager::saveKeyFrame(BareNetworkString* buffer) const
+{
+    buffer->addUInt32(m_switch_ticks).addUInt32((uint32_t)m_all_items.size());
+    for (const ItemState* item : m_all_items)
+    {
+        buffer->addUInt8(item ? 1 : 0);
+        if (item)
+            item->saveCompleteState(buffer);
+    }
+}   // saveKeyFrame
+
+//-----------------------------------------------------------------------------
+/** Restores the state of all items from a keyframe of a history. Items
+ *  dropped after the keyframe are removed, and items which were dropped
+ *  before the keyframe but are used up now are created again.
+ *  \param buffer The buffer to read the state from.
+ */
+void ItemManager::restoreKeyFrame(const BareNetworkString& buffer)
+{
+    m_switch_ticks = buffer.getUInt32();
+    const unsigned int all_items = buffer.getUInt32();
+    for (unsigned int i = all_items; i < m_all_items.size(); i++)
+    {
+        if (m_all_items[i])
+            deleteItem(m_all_items[i]);
+    }
+    m_all_items.resize(all_items, NULL);
+
+    for (unsigned int i = 0; i < all_items; i++)
+    {
+        if (buffer.getUInt8() == 0)
+        {
+            if (m_all_items[i])
+                deleteItem(m_all_items[i]);
+            continue;
+        }
+        ItemState is(buffer);
+        ItemState* item = m_all_items[i];
+        // A different item might use this index now, which also needs to be
+        // moved to another quad
+        if (item && item->getXYZ() != is.getXYZ())
+        {
+            deleteItem(item);
+            item = NULL;
+        }
+        if (item)
+        {
+            *item = is;
+            continue;
+        }
+        Vec3 xyz = is.getXYZ();
+        Vec3 normal = is.getNormal();
+        Item* item_new = dropNewItem(is.getType(), is.getPreviousOwner(),
+                                     &xyz, &normal);
+        *((ItemState*)item_new) = is;
+        m_all_items[i] = item_new;
+        insertItemInQuad(item_new);
+    }   // for i < all_items
+}   // restoreKeyFrame
+
 //-----------------------------------------------------------------------------
 bool ItemManager::randomItemsForArena(const AlignedArray<btTransform>& pos)
 {
@@ -37,6 +37,7 @@
 #include <string>
 #include <vector>
 
+class BareNetworkString;
 class Kart;
 class STKPeer;
 
@@ -149,6 +150,8 @@ public:
     virtual void   collectedItem   (ItemState *item, AbstractKart *kart);
     virtual void   switchItems     ();
     bool           randomItemsForArena(const AlignedArray<btTransform>& pos);
+    void           saveKeyFrame    (BareNetworkString* buffer) const;
+    void           restoreKeyFrame (const BareNetworkString& buffer);
 
     // ------------------------------------------------------------------------
     /** Returns true if the items are switched atm. */
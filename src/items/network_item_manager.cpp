@@ -20,8 +20,8 @@
 
 #include "karts/abstract_kart.hpp"
 #include "modes/world.hpp"
+#include "network/network_bit_stream.hpp"
 #include "network/network_config.hpp"
-#include "network/network_string.hpp"
 #include "network/protocols/game_protocol.hpp"
 #include "network/rewind_manager.hpp"
 #include "network/stk_host.hpp"
@@ -219,9 +219,9 @@ void NetworkItemManager::setItemConfirmationTime(std::weak_ptr<STKPeer> peer,
  *  to save the initial state, which is the first confirmed state by all
  *  clients.
  */
-BareNetworkString* NetworkItemManager::saveState(std::vector<std::string>* ru)
+BareNetworkString* NetworkItemManager::saveState(std::vector<uint8_t>* ru)
 {
-    ru->push_back(getUniqueIdentity());
+    ru->push_back((uint8_t)getRewinderID());
     // On the server:
     // ==============
     m_item_events.lock();
@@ -236,10 +236,16 @@ BareNetworkString* NetworkItemManager::saveState(std::vector<std::string>* ru)
     BareNetworkString *s =
         new BareNetworkString(n * (  sizeof(int) + sizeof(uint16_t)
                                    + sizeof(uint8_t)              ) );
+    // The event times are saved relative to the previous event (or the
+    // state time for the first event)
+    NetworkBitWriter writer(s);
+    writer.addVarUInt(n);
+    int prev_ticks = World::getWorld()->getTicksSinceStart();
     for (auto p : m_item_events.getData())
     {
-        p.saveState(s);
+        p.saveState(&writer, &prev_ticks);
     }
+    writer.flush();
     m_item_events.unlock();
     return s;
 }   // saveState
@@ -357,11 +363,14 @@ void NetworkItemManager::restoreState(BareNetworkString *buffer, int count)
     // Note that the actual ItemManager states must NOT be changed here, only
     // the confirmed states in the Network manager are allowed to be modified.
     // They will all be copied to the ItemManager states after the loop.
-    while(count > 0)
+    NetworkBitReader reader(buffer);
+    unsigned num_events = has_state ? reader.getVarUInt() : 0;
+    int prev_ticks = rewind_to_time;
+    for (unsigned i = 0; i < num_events; i++)
     {
         // 1.1) Decode the event in the message
         // ------------------------------------
-        ItemEventInfo iei(buffer, &count);
+        ItemEventInfo iei(&reader, &prev_ticks);
         if(m_network_item_debugging)
             Log::info("NIM", "Rewindto %d current %d iei.index %d iei tick %d iei.coll %d iei.new %d iei.ttr %d confirmed %lx",
                       rewind_to_time, current_time,
@@ -445,7 +454,7 @@ void NetworkItemManager::restoreState(BareNetworkString *buffer, int count)
                        iei.getTicks());
         }
         current_time = iei.getTicks();
-    }   // while count >0
+    }   // for i < num_events
 
 
     // 2. Update Server 
@@ -29,7 +29,7 @@
 #include "karts/abstract_kart.hpp"
 #include "karts/controller/controller.hpp"
 #include "karts/kart_properties.hpp"
-#include "network/network_string.hpp"
+#include "network/network_bit_stream.hpp"
 #include "physics/physical_object.hpp"
 #include "physics/physics.hpp"
 #include "tracks/track.hpp"
@@ -254,17 +254,17 @@ void Plunger::hitTrack()
 }   // hitTrack
 
 // ----------------------------------------------------------------------------
-BareNetworkString* Plunger::saveState(std::vector<std::string>* ru)
+BareNetworkString* Plunger::saveState(std::vector<uint8_t>* ru)
 {
     BareNetworkString* buffer = Flyable::saveState(ru);
     if (!buffer)
         return NULL;
 
-    buffer->addUInt16(m_keep_alive);
+    NetworkBitWriter writer(buffer);
+    writer.addVarInt(m_keep_alive).addBool(m_rubber_band != NULL);
     if (m_rubber_band)
-        buffer->addUInt8(m_rubber_band->get8BitState());
-    else
-        buffer->addUInt8(255);
+        writer.addBits(m_rubber_band->get8BitState(), 8);
+    writer.flush();
     return buffer;
 }   // saveState
 
@@ -272,7 +272,8 @@ BareNetworkString* Plunger::saveState(std::vector<std::string>* ru)
 void Plunger::restoreState(BareNetworkString *buffer, int count)
 {
     Flyable::restoreState(buffer, count);
-    m_keep_alive = buffer->getUInt16();
+    NetworkBitReader reader(buffer);
+    m_keep_alive = (int16_t)reader.getVarInt();
     // Restore position base on m_keep_alive in Plunger::hit
     if (m_keep_alive == -1)
         m_moved_to_infinity = false;
@@ -282,7 +283,8 @@ void Plunger::restoreState(BareNetworkString *buffer, int count)
         m_moved_to_infinity = true;
     }
 
-    uint8_t bit_state = buffer->getUInt8();
+    uint8_t bit_state = reader.getBool() ? (uint8_t)reader.getBits(8) : 255;
+    reader.align();
     if (bit_state == 255 && m_rubber_band)
     {
         delete m_rubber_band;
@@ -32,11 +32,18 @@
 #include "network/network_config.hpp"
 #include "network/network_string.hpp"
 #include "network/rewind_manager.hpp"
+#include "network/state_hash.hpp"
 #include "utils/stk_process.hpp"
 #include "utils/string_utils.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <set>
 #include <typeinfo>
 
+/** Size of a cell of the spatial hash used for proximity queries. */
+static const float PROJECTILE_GRID_SIZE = 10.0f;
+
 //=============================================================================================
 ProjectileManager* g_projectile_manager[PT_COUNT];
 //---------------------------------------------------------------------------------------------
@@ -67,6 +74,13 @@ void ProjectileManager::clear()
     memset(g_projectile_manager, 0, sizeof(g_projectile_manager));
 }   // clear
 
+//---------------------------------------------------------------------------------------------
+ProjectileManager::ProjectileManager()
+{
+    m_projectile_grid_ticks = -1;
+    m_projectile_grid_dirty = true;
+}   // ProjectileManager
+
 //---------------------------------------------------------------------------------------------
 void ProjectileManager::loadData()
 {
@@ -84,6 +98,8 @@ void ProjectileManager::removeTextures()
 void ProjectileManager::cleanup()
 {
     m_active_projectiles.clear();
+    m_projectile_grid.clear();
+    m_projectile_grid_dirty = true;
     for(HitEffects::iterator i  = m_active_hit_effects.begin();
         i != m_active_hit_effects.end(); ++i)
     {
@@ -109,6 +125,8 @@ void ProjectileManager::updateGraphics(float dt)
 void ProjectileManager::update(int ticks)
 {
     updateServer(ticks);
+    // Projectiles have moved (or will be moved by physics)
+    m_projectile_grid_dirty = true;
 
     if (RewindManager::get()->isRewinding())
         return;
@@ -203,12 +221,101 @@ std::shared_ptr<Flyable>
     // This cannot be done in constructor because of virtual function
     f->onFireFlyable();
     m_active_projectiles[uid] = f;
+    m_projectile_grid_dirty = true;
     if (RewindManager::get()->isEnabled())
         f->addForRewind(uid);
 
     return f;
 }   // newProjectile
 
+// -----------------------------------------------------------------------------
+/** Returns the key of the cell of the spatial hash which contains the given
+ *  grid coordinates. Only x and z are used, tracks are mostly flat. The sign
+ *  bits are flipped so that the keys are sorted like the coordinates, which
+ *  makes the cells of a row with the same x a continuous range of keys.
+ */
+static uint64_t getProjectileGridKey(int x, int z)
+{
+    return ((uint64_t)((uint32_t)x ^ 0x80000000u) << 32) |
+            ((uint32_t)z ^ 0x80000000u);
+}   // getProjectileGridKey
+
+// -----------------------------------------------------------------------------
+/** Rebuilds the spatial hash of all projectiles if any projectile was added,
+ *  removed or moved since it was last built. The AI queries nearby
+ *  projectiles for every kart in every time step, so this is done at most
+ *  once per time step instead of testing all projectiles for each kart.
+ */
+void ProjectileManager::updateProjectileGrid()
+{
+    const int ticks = World::getWorld()->getTicksSinceStart();
+    if (!m_projectile_grid_dirty && m_projectile_grid_ticks == ticks)
+        return;
+    m_projectile_grid_dirty = false;
+    m_projectile_grid_ticks = ticks;
+
+    m_projectile_grid.clear();
+    for (auto& p : m_active_projectiles)
+    {
+        if (!p.second->hasServerState())
+            continue;
+        const Vec3& xyz = p.second->getXYZ();
+        int x = (int)floorf(xyz.getX() / PROJECTILE_GRID_SIZE);
+        int z = (int)floorf(xyz.getZ() / PROJECTILE_GRID_SIZE);
+        m_projectile_grid.emplace_back(getProjectileGridKey(x, z),
+                                       p.second.get());
+    }
+    std::sort(m_projectile_grid.begin(), m_projectile_grid.end());
+}   // updateProjectileGrid
+
+// -----------------------------------------------------------------------------
+/** Returns all projectiles (with a server state) within the given distance
+ *  of a point. The result is only valid till the next call.
+ *  \param xyz The point to test.
+ *  \param radius Distance within which the projectiles must be.
+ */
+const std::vector<Flyable*>&
+    ProjectileManager::findNearbyProjectiles(const Vec3 &xyz, float radius)
+{
+    updateProjectileGrid();
+    m_nearby_projectiles.clear();
+    if (m_projectile_grid.empty())
+        return m_nearby_projectiles;
+
+    const float r2 = radius * radius;
+    const int min_x = (int)floorf((xyz.getX() - radius) / PROJECTILE_GRID_SIZE);
+    const int max_x = (int)floorf((xyz.getX() + radius) / PROJECTILE_GRID_SIZE);
+    const int min_z = (int)floorf((xyz.getZ() - radius) / PROJECTILE_GRID_SIZE);
+    const int max_z = (int)floorf((xyz.getZ() + radius) / PROJECTILE_GRID_SIZE);
+
+    // For a large radius compared to the number of projectiles testing all
+    // of them is faster than looking up all rows of cells
+    if ((int64_t)(max_x - min_x + 1) > (int64_t)m_projectile_grid.size())
+    {
+        for (auto& p : m_projectile_grid)
+        {
+            if (p.second->getXYZ().distance2(xyz) < r2)
+                m_nearby_projectiles.push_back(p.second);
+        }
+        return m_nearby_projectiles;
+    }
+
+    for (int x = min_x; x <= max_x; x++)
+    {
+        // All cells of a row are adjacent in the sorted grid
+        const uint64_t last_key = getProjectileGridKey(x, max_z);
+        auto it = std::lower_bound(m_projectile_grid.begin(),
+            m_projectile_grid.end(),
+            std::make_pair(getProjectileGridKey(x, min_z), (Flyable*)NULL));
+        for (; it != m_projectile_grid.end() && it->first <= last_key; it++)
+        {
+            if (it->second->getXYZ().distance2(xyz) < r2)
+                m_nearby_projectiles.push_back(it->second);
+        }
+    }   // for x
+    return m_nearby_projectiles;
+}   // findNearbyProjectiles
+
 // -----------------------------------------------------------------------------
 /** Returns true if a projectile is within the given distance of the specified
  *  kart.
@@ -218,16 +325,7 @@ std::shared_ptr<Flyable>
 bool ProjectileManager::projectileIsClose(const AbstractKart * const kart,
                                          float radius)
 {
-    float r2 = radius * radius;
-    for (auto i = m_active_projectiles.begin(); i != m_active_projectiles.end(); i++)
-    {
-        if (!i->second->hasServerState())
-            continue;
-        float dist2 = i->second->getXYZ().distance2(kart->getXYZ());
-        if (dist2 < r2)
-            return true;
-    }
-    return false;
+    return !findNearbyProjectiles(kart->getXYZ(), radius).empty();
 }   // projectileIsClose
 
 // -----------------------------------------------------------------------------
@@ -241,22 +339,14 @@ int ProjectileManager::getNearbyProjectileCount(const AbstractKart * const kart,
                                          float radius, PowerupManager::PowerupType type,
                                          bool exclude_owned)
 {
-    float r2 = radius * radius;
     int projectile_count = 0;
-    for (auto i = m_active_projectiles.begin(); i != m_active_projectiles.end(); i++)
+    for (Flyable* f : findNearbyProjectiles(kart->getXYZ(), radius))
     {
-        if (!i->second->hasServerState())
-            continue;
-        if (i->second->getType() == type)
+        if (f->getType() == type)
         {
-            if (exclude_owned && (i->second->getOwner() == kart))
+            if (exclude_owned && (f->getOwner() == kart))
                 continue;
-
-            float dist2 = i->second->getXYZ().distance2(kart->getXYZ());
-            if (dist2 < r2)
-            {
-                projectile_count++;
-            }
+            projectile_count++;
         }
     }
     return projectile_count;
@@ -372,3 +462,88 @@ std::shared_ptr<Rewinder>
     return f;
 }   // addProjectileFromNetworkState
 
+// -----------------------------------------------------------------------------
+/** Adds the unique identity and physical state of all active projectiles to
+ *  a hash of the world state, see World::computeStateHash().
+ *  \param hash The hash to add to.
+ */
+void ProjectileManager::addToStateHash(StateHash* hash) const
+{
+    hash->addInt((int)m_active_projectiles.size());
+    for (auto& p : m_active_projectiles)
+    {
+        hash->add(p.first.data(), p.first.size());
+        if (p.second->getBody())
+            hash->addBody(p.second->getBody());
+    }
+}   // addToStateHash
+
+// -----------------------------------------------------------------------------
+/** Saves the unique identity and state of all active projectiles for a
+ *  keyframe of a history (see History::saveKeyFrame()).
+ *  \param buffer The buffer to write the state to.
+ */
+void ProjectileManager::saveKeyFrame(BareNetworkString* buffer)
+{
+    std::vector<std::pair<const std::string*, BareNetworkString*> > states;
+    std::vector<uint8_t> rewinder_using;
+    for (auto& p : m_active_projectiles)
+    {
+        if (!p.second->hasServerState())
+            continue;
+        BareNetworkString* state = p.second->saveState(&rewinder_using);
+        if (state)
+            states.emplace_back(&p.first, state);
+    }
+    buffer->addUInt8((uint8_t)states.size());
+    for (auto& s : states)
+    {
+        buffer->encodeString(*s.first).addUInt16((uint16_t)s.second->size());
+        *buffer += *s.second;
+        delete s.second;
+    }
+}   // saveKeyFrame
+
+// -----------------------------------------------------------------------------
+/** Restores all projectiles from a keyframe of a history: projectiles which
+ *  were fired after the keyframe are removed, and the ones which were
+ *  removed after it are created again.
+ *  \param buffer The buffer to read the state from.
+ */
+void ProjectileManager::restoreKeyFrame(BareNetworkString* buffer)
+{
+    std::set<std::string> restored;
+    const unsigned int count = buffer->getUInt8();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        std::string uid;
+        buffer->decodeString(&uid);
+        const uint16_t size = buffer->getUInt16();
+        std::shared_ptr<Rewinder> r;
+        auto it = m_active_projectiles.find(uid);
+        if (it != m_active_projectiles.end())
+            r = it->second;
+        else
+            r = addRewinderFromNetworkState(uid);
+        if (!r)
+        {
+            buffer->skip(size);
+            continue;
+        }
+        r->restoreState(buffer, size);
+        restored.insert(uid);
+    }
+
+    for (auto p = m_active_projectiles.begin();
+         p != m_active_projectiles.end();)
+    {
+        if (restored.find(p->first) != restored.end())
+        {
+            p++;
+            continue;
+        }
+        p->second->onDeleteFlyable();
+        p = m_active_projectiles.erase(p);
+    }
+    m_projectile_grid_dirty = true;
+}   // restoreKeyFrame
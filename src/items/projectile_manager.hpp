@@ -19,9 +19,11 @@
 #ifndef HEADER_PROJECTILEMANAGER_HPP
 #define HEADER_PROJECTILEMANAGER_HPP
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace irr
@@ -33,10 +35,12 @@ namespace irr
 #include "utils/no_copy.hpp"
 
 class AbstractKart;
+class BareNetworkString;
 class Flyable;
 class HitEffect;
 class Rewinder;
 class Track;
+class StateHash;
 class Vec3;
 
 /**
@@ -55,6 +59,25 @@ private:
      *  being shown or have a sfx playing. */
     HitEffects       m_active_hit_effects;
 
+    /** A spatial hash of all active projectiles with a server state, used
+     *  for proximity queries: pairs of grid cell and projectile, sorted by
+     *  the cell. It is rebuilt when first needed in a time step. */
+    std::vector<std::pair<uint64_t, Flyable*> > m_projectile_grid;
+
+    /** Projectiles found by the last call of findNearbyProjectiles(). */
+    std::vector<Flyable*> m_nearby_projectiles;
+
+    /** World ticks at which m_projectile_grid was built. */
+    int              m_projectile_grid_ticks;
+
+    /** True if projectiles were moved, added or removed since
+     *  m_projectile_grid was built. */
+    bool             m_projectile_grid_dirty;
+
+    void             updateProjectileGrid();
+    const std::vector<Flyable*>& findNearbyProjectiles(const Vec3 &xyz,
+                                                       float radius);
+
     std::string      getUniqueIdentity(AbstractKart* kart,
                                        PowerupManager::PowerupType type);
     void             updateServer(int ticks);
@@ -68,7 +91,7 @@ public:
     // ----------------------------------------------------------------------------------------
     static void clear();
     // ----------------------------------------------------------------------------------------
-                     ProjectileManager() {}
+                     ProjectileManager();
                     ~ProjectileManager() {}
     void             loadData         ();
     void             cleanup          ();
@@ -95,11 +118,23 @@ public:
     // ------------------------------------------------------------------------
     std::vector<Vec3> getBasketballPositions();
     // ------------------------------------------------------------------------
+    void addToStateHash(StateHash* hash) const;
+    // ------------------------------------------------------------------------
+    void saveKeyFrame(BareNetworkString* buffer);
+    // ------------------------------------------------------------------------
+    void restoreKeyFrame(BareNetworkString* buffer);
+    // ------------------------------------------------------------------------
     void addByUID(const std::string& uid, std::shared_ptr<Flyable> f)
-                                             { m_active_projectiles[uid] = f; }
+    {
+        m_active_projectiles[uid] = f;
+        m_projectile_grid_dirty = true;
+    }   // addByUID
     // ------------------------------------------------------------------------
     void removeByUID(const std::string& uid)
-                                           { m_active_projectiles.erase(uid); }
+    {
+        m_active_projectiles.erase(uid);
+        m_projectile_grid_dirty = true;
+    }   // removeByUID
 };
 
 #endif
@@ -28,7 +28,7 @@
 #include "karts/abstract_kart.hpp"
 #include "karts/kart_properties.hpp"
 #include "modes/linear_world.hpp"
-#include "network/network_string.hpp"
+#include "network/network_bit_stream.hpp"
 #include "network/rewind_info.hpp"
 #include "network/rewind_manager.hpp"
 #include "physics/btKart.hpp"
@@ -884,13 +884,16 @@ bool RubberBall::hit(AbstractKart* kart, PhysicalObject* object)
 }   // hit
 
 // ----------------------------------------------------------------------------
-BareNetworkString* RubberBall::saveState(std::vector<std::string>* ru)
+BareNetworkString* RubberBall::saveState(std::vector<uint8_t>* ru)
 {
     BareNetworkString* buffer = Flyable::saveState(ru);
     if (!buffer)
         return NULL;
 
-    buffer->addUInt16((int16_t)m_last_aimed_graph_node);
+    NetworkBitWriter writer(buffer);
+    writer.addVarInt(m_last_aimed_graph_node).addVarInt(m_delete_ticks)
+        .addBits(m_tunnel_count, 7).addBool(m_aiming_at_target);
+    writer.flush();
     buffer->add(m_control_points[0]);
     buffer->add(m_control_points[1]);
     buffer->add(m_control_points[2]);
@@ -903,9 +906,7 @@ BareNetworkString* RubberBall::saveState(std::vector<std::string>* ru)
     buffer->addFloat(m_t_increase);
     buffer->addFloat(m_interval);
     buffer->addFloat(m_height_timer);
-    buffer->addUInt16(m_delete_ticks);
     buffer->addFloat(m_current_max_height);
-    buffer->addUInt8(m_tunnel_count | (m_aiming_at_target ? (1 << 7) : 0));
     TrackSector::saveState(buffer);
     return buffer;
 }   // saveState
@@ -915,8 +916,12 @@ void RubberBall::restoreState(BareNetworkString *buffer, int count)
 {
     Flyable::restoreState(buffer, count);
     m_restoring_state = true;
-    int16_t last_aimed_graph_node = buffer->getUInt16();
-    m_last_aimed_graph_node = last_aimed_graph_node;
+    NetworkBitReader reader(buffer);
+    m_last_aimed_graph_node = reader.getVarInt();
+    m_delete_ticks = (int16_t)reader.getVarInt();
+    m_tunnel_count = (uint8_t)reader.getBits(7);
+    m_aiming_at_target = reader.getBool();
+    reader.align();
     m_control_points[0] = buffer->getVec3();
     m_control_points[1] = buffer->getVec3();
     m_control_points[2] = buffer->getVec3();
@@ -929,11 +934,7 @@ void RubberBall::restoreState(BareNetworkString *buffer, int count)
     m_t_increase = buffer->getFloat();
     m_interval = buffer->getFloat();
     m_height_timer = buffer->getFloat();
-    m_delete_ticks = buffer->getUInt16();
     m_current_max_height = buffer->getFloat();
-    uint8_t tunnel_and_aiming = buffer->getUInt8();
-    m_tunnel_count = tunnel_and_aiming & 127;
-    m_aiming_at_target = ((tunnel_and_aiming >> 7) & 1) == 1;
     TrackSector::rewindTo(buffer);
 }   // restoreState
 
@@ -25,7 +25,7 @@
 #include "karts/kart_properties.hpp"
 #include "karts/controller/ai_properties.hpp"
 #include "modes/world.hpp"
-#include "network/network_string.hpp"
+#include "network/network_bit_stream.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
 
@@ -42,6 +42,7 @@ AIBaseController::AIBaseController(AbstractKart *kart)
     m_kart_width    = m_kart->getKartWidth();
     m_ai_properties = m_kart->getKartProperties()
                             ->getAIPropertiesForDifficulty();
+    m_stuck_count   = 0;
 }   // AIBaseController
 
 //-----------------------------------------------------------------------------
@@ -50,6 +51,7 @@ void AIBaseController::reset()
 {
     m_enabled_network_ai = false;
     m_stuck = false;
+    m_stuck_count = 0;
     m_collision_ticks.clear();
 }   // reset
 
@@ -278,6 +280,8 @@ void AIBaseController::crashed(const Material *m)
         // chassis from the physics world, which would then cause
         // inconsistencies and potentially a crash during the physics
         // processing. So only set a flag, which is tested during update.
+        if (!m_stuck)
+            m_stuck_count++;
         m_stuck = true;
     }
 
@@ -332,18 +336,23 @@ void AIBaseController::determineTurnRadius(const Vec3 &end, Vec3 *center,
 }   // determineTurnRadius
 
 //-----------------------------------------------------------------------------
-bool AIBaseController::saveState(BareNetworkString *buffer) const
+bool AIBaseController::saveState(NetworkBitWriter *writer) const
 {
     // Endcontroller needs this for proper offset in kart rewinder
-    // Must match the number of bytes in Playercontroller.
-    buffer->addUInt16(0).addUInt16(0).addUInt8(0);
+    // Must match the format in Playercontroller (no input saved).
+    writer->addBool(false);
     return false;
 }   // copyToBuffer
 
 //-----------------------------------------------------------------------------
-void AIBaseController::rewindTo(BareNetworkString *buffer)
+void AIBaseController::rewindTo(NetworkBitReader *reader)
 {
     // Endcontroller needs this for proper offset in kart rewinder.
-    // Skip the same number of bytes as PlayerController.
-    buffer->skip(2 + 2 + 1);
+    // Skip the same number of bits as PlayerController.
+    if (reader->getBool())
+    {
+        reader->getBits(16);
+        reader->getBits(16);
+        reader->getBits(2);
+    }
 }   // rewindTo
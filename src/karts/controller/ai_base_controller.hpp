@@ -42,6 +42,10 @@ private:
     *  this kart is stuck and needs to be rescued. */
     bool m_stuck;
 
+    /** How often the kart was detected to be stuck in this race, used for
+     *  profiling the AI. */
+    unsigned int m_stuck_count;
+
 protected:
     bool m_enabled_network_ai;
 
@@ -90,6 +94,7 @@ public:
     static  void enableDebug() {m_ai_debug = true; }
     static  void setTestAI(int n) {m_test_ai = n; }
     static  int  getTestAI() { return m_test_ai; }
+    unsigned int getStuckCount() const { return m_stuck_count; }
     virtual void crashed(const AbstractKart *k) OVERRIDE {};
     virtual void handleZipper(bool play_sound) OVERRIDE {};
     virtual void finishedRace(float time) OVERRIDE {};
@@ -104,8 +109,8 @@ public:
     };
     virtual void skidBonusTriggered() OVERRIDE {}
     // ------------------------------------------------------------------------
-    virtual bool saveState(BareNetworkString *buffer) const OVERRIDE;
-    virtual void rewindTo(BareNetworkString *buffer) OVERRIDE;
+    virtual bool saveState(NetworkBitWriter *writer) const OVERRIDE;
+    virtual void rewindTo(NetworkBitReader *reader) OVERRIDE;
     void setNetworkAI(bool val)                 { m_enabled_network_ai = val; }
     // ------------------------------------------------------------------------
     virtual void update(int ticks) OVERRIDE;
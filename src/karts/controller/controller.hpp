@@ -21,7 +21,8 @@
 #include <irrString.h>
 using namespace irr;
 
-class BareNetworkString;
+class NetworkBitReader;
+class NetworkBitWriter;
 
 /**
   * \defgroup controller Karts/controller
@@ -77,8 +78,8 @@ public:
      *  rubber-banding. */
     virtual bool  isPlayerController () const = 0;
     virtual bool  disableSlipstreamBonus() const = 0;
-    virtual bool  saveState(BareNetworkString *buffer) const = 0;
-    virtual void  rewindTo(BareNetworkString *buffer) = 0;
+    virtual bool  saveState(NetworkBitWriter *writer) const = 0;
+    virtual void  rewindTo(NetworkBitReader *reader) = 0;
     virtual void rumble(float strength_low, float strength_high, uint16_t duration) {}
     // ---------------------------------------------------------------------------
     /** Sets the controller name for this controller. */
@@ -62,9 +62,9 @@ public:
                         bool dry_run=false) OVERRIDE;
     virtual void skidBonusTriggered() OVERRIDE {}
     virtual void newLap(int lap) OVERRIDE {}
-    virtual bool saveState(BareNetworkString *buffer) const OVERRIDE
+    virtual bool saveState(NetworkBitWriter *writer) const OVERRIDE
                                                               { return false; }
-    virtual void rewindTo(BareNetworkString *buffer) OVERRIDE {}
+    virtual void rewindTo(NetworkBitReader *reader) OVERRIDE {}
 
     void         addReplayTime(float time);
     // ------------------------------------------------------------------------
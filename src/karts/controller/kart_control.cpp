@@ -17,7 +17,7 @@
 //  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "karts/controller/kart_control.hpp"
-#include "network/network_string.hpp"
+#include "network/network_bit_stream.hpp"
 
 #include "irrMath.h"
 #include <algorithm>
@@ -81,18 +81,24 @@ void KartControl::setLookBack(bool b)
 }   // setLookBack
 // ----------------------------------------------------------------------------
 /** Copies the important data from this objects into a memory buffer. */
-void KartControl::saveState(BareNetworkString *buffer) const
+void KartControl::saveState(NetworkBitWriter *writer) const
 {
-    buffer->addUInt16(m_steer);
-    buffer->addUInt16(m_accel);
-    buffer->addChar(getButtonsCompressed());
+    // Steering and acceleration are often 0, so only save them if needed
+    writer->addBool(m_steer != 0).addBool(m_accel != 0);
+    if (m_steer != 0)
+        writer->addBits((uint16_t)m_steer, 16);
+    if (m_accel != 0)
+        writer->addBits(m_accel, 16);
+    writer->addBits(getButtonsCompressed(), 7);
 }   // saveState
 
 // ----------------------------------------------------------------------------
 /** Restores this object from a previously saved memory  buffer. */
-void KartControl::rewindTo(BareNetworkString *buffer)
+void KartControl::rewindTo(NetworkBitReader *reader)
 {
-    m_steer = buffer->getUInt16();
-    m_accel = buffer->getUInt16();
-    setButtonsCompressed(buffer->getUInt8());
+    bool has_steer = reader->getBool();
+    bool has_accel = reader->getBool();
+    m_steer = has_steer ? (int16_t)reader->getBits(16) : 0;
+    m_accel = has_accel ? (uint16_t)reader->getBits(16) : 0;
+    setButtonsCompressed((char)reader->getBits(7));
 }   // setFromMemory
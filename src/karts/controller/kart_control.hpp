@@ -21,7 +21,8 @@
 
 #include "utils/types.hpp"
 
-class BareNetworkString;
+class NetworkBitReader;
+class NetworkBitWriter;
 
 /**
   * \ingroup controller
@@ -95,10 +96,10 @@ public:
     }    // operator==
     // ------------------------------------------------------------------------
     /** Copies the important data from this objects into a memory buffer. */
-    void saveState(BareNetworkString *buffer) const;
+    void saveState(NetworkBitWriter *writer) const;
     // ------------------------------------------------------------------------
     /** Restores this object from a previously saved memory  buffer. */
-    void rewindTo(BareNetworkString *buffer);
+    void rewindTo(NetworkBitReader *reader);
     // ------------------------------------------------------------------------
     /** Compresses all buttons into a single byte. */
     char getButtonsCompressed() const
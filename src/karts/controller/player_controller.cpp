@@ -31,9 +31,9 @@
 #include "modes/world.hpp"
 #include "network/game_setup.hpp"
 #include "network/rewind_manager.hpp"
+#include "network/network_bit_stream.hpp"
 #include "network/network_config.hpp"
 #include "network/network_player_profile.hpp"
-#include "network/network_string.hpp"
 #include "race/history.hpp"
 #include "states_screens/race_gui_base.hpp"
 #include "utils/constants.hpp"
@@ -374,26 +374,39 @@ void PlayerController::handleZipper(bool play_sound)
 }   // handleZipper
 
 //-----------------------------------------------------------------------------
-bool PlayerController::saveState(BareNetworkString *buffer) const
+bool PlayerController::saveState(NetworkBitWriter *writer) const
 {
-    // NOTE: when the size changes, the AIBaseController::saveState and
+    // NOTE: when the format changes, the AIBaseController::saveState and
     // restore state MUST be adjusted!!
     int steer_abs = std::abs(m_steer_val);
-    buffer->addUInt16((uint16_t)steer_abs).addUInt16(m_prev_accel)
-        .addUInt8((m_prev_brake ? 1 : 0) | (m_prev_nitro ? 2 : 0));
+    bool has_input = steer_abs != 0 || m_prev_accel != 0 || m_prev_brake ||
+        m_prev_nitro;
+    writer->addBool(has_input);
+    if (has_input)
+    {
+        writer->addBits((uint16_t)steer_abs, 16).addBits(m_prev_accel, 16)
+            .addBool(m_prev_brake).addBool(m_prev_nitro);
+    }
     return m_steer_val < 0;
 }   // copyToBuffer
 
 //-----------------------------------------------------------------------------
-void PlayerController::rewindTo(BareNetworkString *buffer)
+void PlayerController::rewindTo(NetworkBitReader *reader)
 {
-    // NOTE: when the size changes, the AIBaseController::saveState and
+    // NOTE: when the format changes, the AIBaseController::saveState and
     // restore state MUST be adjusted!!
-    m_steer_val  = buffer->getUInt16();
-    m_prev_accel = buffer->getUInt16();
-    uint8_t c = buffer->getUInt8();
-    m_prev_brake = (c & 1) != 0;
-    m_prev_nitro = (c & 2) != 0;
+    if (!reader->getBool())
+    {
+        m_steer_val  = 0;
+        m_prev_accel = 0;
+        m_prev_brake = false;
+        m_prev_nitro = false;
+        return;
+    }
+    m_steer_val  = reader->getBits(16);
+    m_prev_accel = reader->getBits(16);
+    m_prev_brake = reader->getBool();
+    m_prev_nitro = reader->getBool();
 }   // rewindTo
 
 // ----------------------------------------------------------------------------
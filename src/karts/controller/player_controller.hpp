@@ -49,8 +49,8 @@ public:
     virtual void reset             () OVERRIDE;
     virtual void handleZipper(bool play_sound) OVERRIDE;
     virtual void resetInputState();
-    virtual bool saveState(BareNetworkString *buffer) const OVERRIDE;
-    virtual void rewindTo(BareNetworkString *buffer) OVERRIDE;
+    virtual bool saveState(NetworkBitWriter *writer) const OVERRIDE;
+    virtual void rewindTo(NetworkBitReader *reader) OVERRIDE;
     // ------------------------------------------------------------------------
     virtual void  collectedItem(const ItemState &item,
                                 float previous_energy=0 ) OVERRIDE { };
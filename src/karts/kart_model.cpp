@@ -262,11 +262,6 @@ KartModel::~KartModel()
             assert(!m_is_master);
             m_wheel_node[i]->drop();
         }
-        if(m_is_master && m_wheel_model[i])
-        {
-            irr_driver->dropAllTextures(m_wheel_model[i]);
-            irr_driver->removeMeshFromCache(m_wheel_model[i]);
-        }
     }
 
     for(size_t i=0; i<m_speed_weighted_objects.size(); i++)
@@ -277,7 +272,52 @@ KartModel::~KartModel()
             assert(!m_is_master);
             m_speed_weighted_objects[i].m_node->drop();
         }
-        if (m_is_master && m_speed_weighted_objects[i].m_model)
+    }
+
+    for (size_t i = 0; i < m_headlight_objects.size(); i++)
+    {
+        HeadlightObject& obj = m_headlight_objects[i];
+        if (obj.getLightNode())
+        {
+            // Master KartModels should never have a headlight attached.
+            assert(!m_is_master);
+            obj.getLightNode()->drop();
+        }
+    }
+
+    if (m_is_master)
+        unloadModels();
+
+    delete m_hat_location;
+#ifdef DEBUG
+#if SKELETON_DEBUG
+    irr_driver->clearDebugMeshes();
+#endif
+#endif
+
+}  // ~KartModel
+
+// ----------------------------------------------------------------------------
+/** Releases all meshes loaded by loadModels of a master kart model. The
+ *  information read from the kart.xml file and the kart dimensions are kept,
+ *  so loadModels can be called again when the meshes are needed.
+ */
+void KartModel::unloadModels()
+{
+    assert(m_is_master);
+    for(unsigned int i=0; i<4; i++)
+    {
+        if(m_wheel_model[i])
+        {
+            irr_driver->dropAllTextures(m_wheel_model[i]);
+            irr_driver->removeMeshFromCache(m_wheel_model[i]);
+            m_wheel_model[i] = NULL;
+        }
+    }
+
+    for(size_t i=0; i<m_speed_weighted_objects.size(); i++)
+    {
+        if (m_speed_weighted_objects[i].m_model)
         {
             m_speed_weighted_objects[i].m_model->drop();
             irr_driver->dropAllTextures(m_speed_weighted_objects[i].m_model);
@@ -285,19 +325,14 @@ KartModel::~KartModel()
             {
                 irr_driver->removeMeshFromCache(m_speed_weighted_objects[i].m_model);
             }
+            m_speed_weighted_objects[i].m_model = NULL;
         }
     }
 
     for (size_t i = 0; i < m_headlight_objects.size(); i++)
     {
         HeadlightObject& obj = m_headlight_objects[i];
-        if (obj.getLightNode())
-        {
-            // Master KartModels should never have a headlight attached.
-            assert(!m_is_master);
-            obj.getLightNode()->drop();
-        }
-        if (m_is_master && obj.getModel())
+        if (obj.getModel())
         {
             obj.getModel()->drop();
             irr_driver->dropAllTextures(obj.getModel());
@@ -305,29 +340,23 @@ KartModel::~KartModel()
             {
                 irr_driver->removeMeshFromCache(obj.getModel());
             }
+            obj.setModel(NULL);
         }
     }
 
-    if (m_is_master && m_mesh)
+    if (m_mesh)
     {
         m_mesh->drop();
         // If there is only one copy left, it's the copy in irrlicht's
         // mesh cache, so it can be removed.
-        if (m_mesh && m_mesh->getReferenceCount() == 1)
+        if (m_mesh->getReferenceCount() == 1)
         {
             irr_driver->dropAllTextures(m_mesh);
             irr_driver->removeMeshFromCache(m_mesh);
         }
+        m_mesh = NULL;
     }
-
-    delete m_hat_location;
-#ifdef DEBUG
-#if SKELETON_DEBUG
-    irr_driver->clearDebugMeshes();
-#endif
-#endif
-
-}  // ~KartModel
+}   // unloadModels
 
 // ----------------------------------------------------------------------------
 /** This function returns a copy of this object. The memory is allocated
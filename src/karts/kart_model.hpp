@@ -347,6 +347,7 @@ public:
     void          reset();
     void          loadInfo(const XMLNode &node);
     bool          loadModels(const KartProperties &kart_properties);
+    void          unloadModels();
     void          setDefaultSuspension();
     void          update(float dt, float distance, float steer, float speed,
                          float current_lean_angle,
@@ -359,6 +360,9 @@ public:
     /** Returns the animated mesh of this kart model. */
     scene::IAnimatedMesh*
                   getModel() const { return m_mesh; }
+    // ------------------------------------------------------------------------
+    /** True if the meshes of this (master) kart model are loaded. */
+    bool          isLoaded() const { return m_mesh != NULL; }
 
     // ------------------------------------------------------------------------
     /** Returns the mesh of the wheel for this kart. */
@@ -27,6 +27,7 @@
 #include "graphics/material_manager.hpp"
 #include "graphics/shader_files_manager.hpp"
 #include "graphics/stk_tex_manager.hpp"
+#include "guiengine/engine.hpp"
 #include "graphics/sp/sp_shader_manager.hpp"
 #include "graphics/sp/sp_texture_manager.hpp"
 #include "io/file_manager.hpp"
@@ -367,6 +368,11 @@ void KartProperties::load(const std::string &filename, const std::string &node)
     m_shadow_material = material_manager->getMaterialSPM(m_shadow_file, "",
         "alphablend");
 
+    // Without graphics only the dimensions of the kart are needed until it
+    // is used in a race, so release the meshes (see getKartModelCopy).
+    if (GUIEngine::isNoGraphics() && m_kart_model->isLoaded())
+        m_kart_model->unloadModels();
+
     STKTexManager::getInstance()->unsetTextureErrorMessage();
     file_manager->popTextureSearchPath();
     file_manager->popModelSearchPath();
@@ -384,9 +390,38 @@ void KartProperties::load(const std::string &filename, const std::string &node)
  */
 KartModel* KartProperties::getKartModelCopy(std::shared_ptr<GE::GERenderInfo> ri) const
 {
+    if (!m_kart_model->isLoaded() && m_version >= 1)
+    {
+        // The meshes were released after loading or after the last race,
+        // load them again using the kart properties which loaded them first
+        // (this object can be a per player copy).
+        std::string unique_id =
+            StringUtils::insertValues("karts/%s", m_ident.c_str());
+        file_manager->pushModelSearchPath(m_root);
+        file_manager->pushTextureSearchPath(m_root, unique_id);
+        if (!m_kart_model->loadModels(*m_kart_model->getKartProperties()))
+            Log::error("KartProperties", "Cannot reload models of '%s'.",
+                       m_ident.c_str());
+        file_manager->popTextureSearchPath();
+        file_manager->popModelSearchPath();
+    }
     return m_kart_model->makeCopy(ri);
 }  // getKartModelCopy
 
+// ----------------------------------------------------------------------------
+/** Releases the meshes of the kart model if no kart in a race uses them
+ *  (which share the model through their copy of the kart properties). This
+ *  is only done without graphics, where nothing but the kart dimensions is
+ *  needed outside of a race. The meshes are loaded again on demand by
+ *  getKartModelCopy.
+ */
+void KartProperties::unloadKartModel()
+{
+    if (GUIEngine::isNoGraphics() && m_kart_model &&
+        m_kart_model.use_count() == 1 && m_kart_model->isLoaded())
+        m_kart_model->unloadModels();
+}  // unloadKartModel
+
 // ----------------------------------------------------------------------------
 /** Sets the name of a mesh to be used for this kart.
  *  \param hat_name Name of the mesh.
@@ -260,6 +260,8 @@ public:
     // ------------------------------------------------------------------------
     KartModel* getKartModelCopy(std::shared_ptr<GE::GERenderInfo> ri=nullptr) const;
     // ------------------------------------------------------------------------
+    void unloadKartModel();
+    // ------------------------------------------------------------------------
     /** Returns a pointer to the main KartModel object. This copy
      *  should not be modified, not attachModel be called on it. */
     const KartModel& getMasterKartModel() const {return *m_kart_model;        }
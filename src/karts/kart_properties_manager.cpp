@@ -92,6 +92,25 @@ void KartPropertiesManager::unloadAllKarts()
     m_all_groups.clear();
 }   // unloadAllKarts
 
+//-----------------------------------------------------------------------------
+/** Releases the meshes of all karts which are not used in a race anymore.
+ *  This only has an effect without graphics, see
+ *  KartProperties::unloadKartModel.
+ *  \param keep Idents of karts whose meshes are kept, e.g. the karts of the
+ *         race that just finished, which are likely to be used again in the
+ *         next race.
+ */
+void KartPropertiesManager::unloadUnusedKartModels(
+                                           const std::set<std::string>& keep)
+{
+    for (unsigned int i = 0; i < m_karts_properties.size(); i++)
+    {
+        KartProperties* kp = m_karts_properties.get(i);
+        if (keep.find(kp->getIdent()) == keep.end())
+            kp->unloadKartModel();
+    }
+}   // unloadUnusedKartModels
+
 //-----------------------------------------------------------------------------
 /** Remove a kart from the kart manager.
  *  \param id The kart id (i.e. name of the directory) to remove.
@@ -34,7 +34,7 @@
 #include "network/compress_network_body.hpp"
 #include "network/protocols/client_lobby.hpp"
 #include "network/rewind_manager.hpp"
-#include "network/network_string.hpp"
+#include "network/network_bit_stream.hpp"
 #include "physics/btKart.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/translation.hpp"
@@ -159,66 +159,70 @@ void KartRewinder::computeError()
 /** Saves all state information for a kart in a memory buffer. The memory
  *  is allocated here and the address returned. It will then be managed
  *  by the RewindManager.
- *  \param[out] ru The unique identity of rewinder writing to.
+ *  \param[out] ru The rewinder id of rewinder writing to.
  *  \return The address of the memory buffer with the state.
  */
-BareNetworkString* KartRewinder::saveState(std::vector<std::string>* ru)
+BareNetworkString* KartRewinder::saveState(std::vector<uint8_t>* ru)
 {
     if (m_eliminated)
         return nullptr;
 
-    ru->push_back(getUniqueIdentity());
+    ru->push_back((uint8_t)getRewinderID());
     const int MEMSIZE = 17*sizeof(float) + 9+3;
 
     BareNetworkString *buffer = new BareNetworkString(MEMSIZE);
 
     // 1) Steering and other player controls
     // -------------------------------------
-    getControls().saveState(buffer);
-    bool sign_neg = getController()->saveState(buffer);
+    // Controls, flags and timers are bit packed, most of them are zero most
+    // of the time
+    NetworkBitWriter writer(buffer);
+    getControls().saveState(&writer);
+    bool sign_neg = getController()->saveState(&writer);
 
     // 2) Boolean handling to determine if need saving
     const bool has_animation = m_kart_animation != NULL;
-    uint8_t bool_for_each_data = 0;
-    if (m_fire_clicked)
-        bool_for_each_data |= 1;
-    if (m_bubblegum_ticks > 0)
-        bool_for_each_data |= (1 << 1);
-    if (m_view_blocked_by_plunger > 0)
-        bool_for_each_data |= (1 << 2);
-    if (m_invulnerable_ticks > 0)
-        bool_for_each_data |= (1 << 3);
-    if (getEnergy() > 0.0f)
-        bool_for_each_data |= (1 << 4);
-    if (has_animation)
-        bool_for_each_data |= (1 << 5);
-    if (m_vehicle->getTimedRotationTicks() > 0)
-        bool_for_each_data |= (1 << 6);
-    if (m_vehicle->getCentralImpulseTicks() > 0)
-        bool_for_each_data |= (1 << 7);
-    buffer->addUInt8(bool_for_each_data);
-
-    uint8_t bool_for_each_data_2 = 0;
-    if (sign_neg)
-        bool_for_each_data_2 |= 1;
-    if (m_bounce_back_ticks > 0)
-        bool_for_each_data_2 |= (1 << 1);
-    if (getAttachment()->getType() != Attachment::ATTACH_NOTHING)
-        bool_for_each_data_2 |= (1 << 2);
-    if (getPowerup()->getType() != PowerupManager::POWERUP_NOTHING)
-        bool_for_each_data_2 |= (1 << 3);
-    if (m_bubblegum_torque_sign)
-        bool_for_each_data_2 |= (1 << 4);
-    buffer->addUInt8(bool_for_each_data_2);
+    const bool has_timed_rotation = m_vehicle->getTimedRotationTicks() > 0;
+    const bool has_impulse = m_vehicle->getCentralImpulseTicks() > 0;
+    writer.addBool(m_fire_clicked).addBool(m_bubblegum_ticks > 0)
+        .addBool(m_view_blocked_by_plunger > 0)
+        .addBool(m_invulnerable_ticks > 0).addBool(getEnergy() > 0.0f)
+        .addBool(has_animation).addBool(has_timed_rotation)
+        .addBool(has_impulse);
+
+    writer.addBool(sign_neg).addBool(m_bounce_back_ticks > 0)
+        .addBool(getAttachment()->getType() != Attachment::ATTACH_NOTHING)
+        .addBool(getPowerup()->getType() != PowerupManager::POWERUP_NOTHING)
+        .addBool(m_bubblegum_torque_sign);
 
     if (m_bubblegum_ticks > 0)
-        buffer->addUInt16(m_bubblegum_ticks);
+        writer.addVarUInt((uint16_t)m_bubblegum_ticks);
     if (m_view_blocked_by_plunger > 0)
-        buffer->addUInt16(m_view_blocked_by_plunger);
+        writer.addVarUInt((uint16_t)m_view_blocked_by_plunger);
     if (m_invulnerable_ticks > 0)
-        buffer->addUInt16(m_invulnerable_ticks);
+        writer.addVarUInt((uint16_t)m_invulnerable_ticks);
     if (getEnergy() > 0.0f)
-        buffer->addFloat(getEnergy());
+        writer.addFloat(getEnergy());
+
+    // Physics timers, used for collision rewind
+    if (!has_animation)
+    {
+        if (has_timed_rotation)
+        {
+            writer.addVarUInt(m_vehicle->getTimedRotationTicks());
+            writer.addFloat(m_vehicle->getTimedRotation());
+        }
+        if (m_bounce_back_ticks > 0)
+            writer.addVarUInt(m_bounce_back_ticks);
+        if (has_impulse)
+        {
+            const btVector3& impulse = m_vehicle->getAdditionalImpulse();
+            writer.addVarUInt(m_vehicle->getCentralImpulseTicks());
+            writer.addFloat(impulse.x()).addFloat(impulse.y())
+                .addFloat(impulse.z());
+        }
+    }
+    writer.flush();
 
     // 3) Kart animation status or physics values (transform and velocities)
     // -------------------------------------------
@@ -231,21 +235,6 @@ BareNetworkString* KartRewinder::saveState(std::vector<std::string>* ru)
     {
         CompressNetworkBody::compress(
             m_body.get(), m_motion_state.get(), buffer);
-
-        if (m_vehicle->getTimedRotationTicks() > 0)
-        {
-            buffer->addUInt16(m_vehicle->getTimedRotationTicks());
-            buffer->addFloat(m_vehicle->getTimedRotation());
-        }
-
-        // For collision rewind
-        if (m_bounce_back_ticks > 0)
-            buffer->addUInt8(m_bounce_back_ticks);
-        if (m_vehicle->getCentralImpulseTicks() > 0)
-        {
-            buffer->addUInt16(m_vehicle->getCentralImpulseTicks());
-            buffer->add(m_vehicle->getAdditionalImpulse());
-        }
     }
 
     // 4) Attachment, powerup, nitro
@@ -278,57 +267,82 @@ void KartRewinder::restoreState(BareNetworkString *buffer, int count)
 
     // 1) Steering and other controls
     // ------------------------------
-    getControls().rewindTo(buffer);
-    getController()->rewindTo(buffer);
+    NetworkBitReader reader(buffer);
+    getControls().rewindTo(&reader);
+    getController()->rewindTo(&reader);
 
     // 2) Boolean handling to determine if need saving
     // -----------
-    uint8_t bool_for_each_data = buffer->getUInt8();
-    m_fire_clicked = (bool_for_each_data & 1) == 1;
-    bool read_bubblegum = ((bool_for_each_data >> 1) & 1) == 1;
-    bool read_plunger = ((bool_for_each_data >> 2) & 1) == 1;
-    bool read_invulnerable = ((bool_for_each_data >> 3) & 1) == 1;
-    bool read_energy =  ((bool_for_each_data >> 4) & 1) == 1;
-    bool has_animation_in_state = ((bool_for_each_data >> 5) & 1) == 1;
-    bool read_timed_rotation =  ((bool_for_each_data >> 6) & 1) == 1;
-    bool read_impulse = ((bool_for_each_data >> 7) & 1) == 1;
-
-    uint8_t bool_for_each_data_2 = buffer->getUInt8();
-    bool controller_steer_sign = (bool_for_each_data_2 & 1) == 1;
+    m_fire_clicked = reader.getBool();
+    bool read_bubblegum = reader.getBool();
+    bool read_plunger = reader.getBool();
+    bool read_invulnerable = reader.getBool();
+    bool read_energy = reader.getBool();
+    bool has_animation_in_state = reader.getBool();
+    bool read_timed_rotation = reader.getBool();
+    bool read_impulse = reader.getBool();
+
+    bool controller_steer_sign = reader.getBool();
     if (controller_steer_sign)
     {
         PlayerController* pc = dynamic_cast<PlayerController*>(m_controller);
         if (pc)
             pc->m_steer_val = pc->m_steer_val * -1;
     }
-    bool read_bounce_back = ((bool_for_each_data_2 >> 1) & 1) == 1;
-    bool read_attachment = ((bool_for_each_data_2 >> 2) & 1) == 1;
-    bool read_powerup = ((bool_for_each_data_2 >> 3) & 1) == 1;
-    m_bubblegum_torque_sign = ((bool_for_each_data_2 >> 4) & 1) == 1;
+    bool read_bounce_back = reader.getBool();
+    bool read_attachment = reader.getBool();
+    bool read_powerup = reader.getBool();
+    m_bubblegum_torque_sign = reader.getBool();
 
     if (read_bubblegum)
-        m_bubblegum_ticks = buffer->getUInt16();
+        m_bubblegum_ticks = (uint16_t)reader.getVarUInt();
     else
         m_bubblegum_ticks = 0;
 
     if (read_plunger)
-        m_view_blocked_by_plunger = buffer->getUInt16();
+        m_view_blocked_by_plunger = (uint16_t)reader.getVarUInt();
     else
         m_view_blocked_by_plunger = 0;
 
     if (read_invulnerable)
-        m_invulnerable_ticks = buffer->getUInt16();
+        m_invulnerable_ticks = (uint16_t)reader.getVarUInt();
     else
         m_invulnerable_ticks = 0;
 
     if (read_energy)
     {
-        float nitro = buffer->getFloat();
+        float nitro = reader.getFloat();
         setEnergy(nitro);
     }
     else
         setEnergy(0.0f);
 
+    uint16_t time_rot = 0;
+    float timed_rotation_y = 0.0f;
+    uint16_t central_impulse_ticks = 0;
+    Vec3 additional_impulse(0.0f);
+    if (!has_animation_in_state)
+    {
+        if (read_timed_rotation)
+        {
+            time_rot = (uint16_t)reader.getVarUInt();
+            timed_rotation_y = reader.getFloat();
+        }
+        // Collision rewind
+        if (read_bounce_back)
+            m_bounce_back_ticks = (uint8_t)reader.getVarUInt();
+        else
+            m_bounce_back_ticks = 0;
+        if (read_impulse)
+        {
+            central_impulse_ticks = (uint16_t)reader.getVarUInt();
+            additional_impulse.setX(reader.getFloat());
+            additional_impulse.setY(reader.getFloat());
+            additional_impulse.setZ(reader.getFloat());
+        }
+    }
+    reader.align();
+
     // 3) Kart animation status or transform and velocities
     // -----------
     if (has_animation_in_state)
@@ -384,8 +398,6 @@ void KartRewinder::restoreState(BareNetworkString *buffer, int count)
 
         if (read_timed_rotation)
         {
-            uint16_t time_rot = buffer->getUInt16();
-            float timed_rotation_y = buffer->getFloat();
             // Set timed rotation divides by time_rot
             m_vehicle->setTimedRotation(time_rot,
                 stk_config->ticks2Time(time_rot) * timed_rotation_y);
@@ -393,15 +405,8 @@ void KartRewinder::restoreState(BareNetworkString *buffer, int count)
         else
             m_vehicle->setTimedRotation(0, 0.0f);
 
-        // Collision rewind
-        if (read_bounce_back)
-            m_bounce_back_ticks = buffer->getUInt8();
-        else
-            m_bounce_back_ticks = 0;
         if (read_impulse)
         {
-            uint16_t central_impulse_ticks = buffer->getUInt16();
-            Vec3 additional_impulse = buffer->getVec3();
             m_vehicle->setTimedCentralImpulse(central_impulse_ticks,
                 additional_impulse, true/*rewind*/);
         }
@@ -498,3 +503,62 @@ std::function<void()> KartRewinder::getLocalStateRestoreFunction()
         m_skidding->m_remaining_jump_time = remaining_jump_time;
     };
 }   // getLocalStateRestoreFunction
+
+// ----------------------------------------------------------------------------
+/** Saves the state of this kart for a keyframe of a history (see
+ *  History::saveKeyFrame()): the state which is sent to clients, and the
+ *  values which clients only keep locally (see
+ *  getLocalStateRestoreFunction()).
+ *  \param buffer The buffer to write the state to.
+ */
+void KartRewinder::saveKeyFrame(BareNetworkString* buffer)
+{
+    std::vector<uint8_t> rewinder_using;
+    BareNetworkString* state = saveState(&rewinder_using);
+    if (!state)
+    {
+        buffer->addUInt16(0);
+        return;
+    }
+    buffer->addUInt16((uint16_t)state->size());
+    *buffer += *state;
+    delete state;
+
+    PlayerController* pc = dynamic_cast<PlayerController*>(m_controller);
+    const MaxSpeed::SpeedDecrease& terrain =
+        m_max_speed->m_speed_decrease[MaxSpeed::MS_DECREASE_TERRAIN];
+    buffer->addUInt32(m_brake_ticks).addUInt8(m_min_nitro_ticks)
+        .addUInt32(pc ? pc->m_steer_val_l : 0)
+        .addUInt32(pc ? pc->m_steer_val_r : 0)
+        .addFloat(terrain.m_current_fraction)
+        .addUInt16(terrain.m_max_speed_fraction)
+        .addFloat(m_skidding->m_remaining_jump_time);
+}   // saveKeyFrame
+
+// ----------------------------------------------------------------------------
+/** Restores the state of this kart from a keyframe of a history.
+ *  \param buffer The buffer to read the state from.
+ */
+void KartRewinder::restoreKeyFrame(BareNetworkString* buffer)
+{
+    const uint16_t size = buffer->getUInt16();
+    if (size == 0)
+        return;
+    restoreState(buffer, size);
+
+    m_brake_ticks = buffer->getUInt32();
+    m_min_nitro_ticks = buffer->getInt8();
+    const int steer_val_l = buffer->getUInt32();
+    const int steer_val_r = buffer->getUInt32();
+    PlayerController* pc = dynamic_cast<PlayerController*>(m_controller);
+    if (pc)
+    {
+        pc->m_steer_val_l = steer_val_l;
+        pc->m_steer_val_r = steer_val_r;
+    }
+    MaxSpeed::SpeedDecrease& terrain =
+        m_max_speed->m_speed_decrease[MaxSpeed::MS_DECREASE_TERRAIN];
+    terrain.m_current_fraction = buffer->getFloat();
+    terrain.m_max_speed_fraction = buffer->getUInt16();
+    m_skidding->m_remaining_jump_time = buffer->getFloat();
+}   // restoreKeyFrame
@@ -29,7 +29,7 @@
 #include "karts/max_speed.hpp"
 #include "karts/controller/controller.hpp"
 #include "modes/world.hpp"
-#include "network/network_string.hpp"
+#include "network/network_bit_stream.hpp"
 #include "network/rewind_manager.hpp"
 #include "physics/btKart.hpp"
 #include "tracks/track.hpp"
@@ -101,10 +101,19 @@ void Skidding::reset()
  */
 void Skidding::saveState(BareNetworkString *buffer)
 {
-    buffer->addUInt8(m_skid_state);
-    buffer->addUInt16(m_skid_time);
-    buffer->addFloat(m_skid_factor);
-    buffer->addFloat(m_visual_rotation);
+    // Most of the time the kart is not skidding, so only save the skidding
+    // values if they are not the default ones
+    NetworkBitWriter writer(buffer);
+    writer.addBits(m_skid_state, 3);
+    writer.addBool(m_skid_time != 0);
+    if (m_skid_time != 0)
+        writer.addVarUInt(m_skid_time);
+    const bool has_skid_values =
+        m_skid_factor != 1.0f || m_visual_rotation != 0.0f;
+    writer.addBool(has_skid_values);
+    if (has_skid_values)
+        writer.addFloat(m_skid_factor).addFloat(m_visual_rotation);
+    writer.flush();
 }   // saveState
 
 // ----------------------------------------------------------------------------
@@ -113,10 +122,19 @@ void Skidding::saveState(BareNetworkString *buffer)
  */
 void Skidding::rewindTo(BareNetworkString *buffer)
 {
-    m_skid_state = (SkidState)buffer->getUInt8();
-    m_skid_time = buffer->getUInt16();
-    m_skid_factor = buffer->getFloat();
-    m_visual_rotation = buffer->getFloat();
+    NetworkBitReader reader(buffer);
+    m_skid_state = (SkidState)reader.getBits(3);
+    m_skid_time = reader.getBool() ? (uint16_t)reader.getVarUInt() : 0;
+    if (reader.getBool())
+    {
+        m_skid_factor = reader.getFloat();
+        m_visual_rotation = reader.getFloat();
+    }
+    else
+    {
+        m_skid_factor = 1.0f;
+        m_visual_rotation = 0.0f;
+    }
 }   // rewindTo
 
 // ----------------------------------------------------------------------------
@@ -230,6 +230,7 @@ extern "C" {
 #include "input/keyboard_device.hpp"
 #include "input/wiimote_manager.hpp"
 #include "io/file_manager.hpp"
+#include "io/xml_node.hpp"
 #include "items/attachment_manager.hpp"
 #include "items/item_manager.hpp"
 #include "items/network_item_manager.hpp"
@@ -248,7 +249,9 @@ extern "C" {
 #include "network/protocols/client_lobby.hpp"
 #include "network/protocols/server_lobby.hpp"
 #include "network/network.hpp"
+#include "network/network_bit_stream.hpp"
 #include "network/network_config.hpp"
+#include "network/network_console.hpp"
 #include "network/network_string.hpp"
 #include "network/protocols/connect_to_server.hpp"
 #include "network/protocols/client_lobby.hpp"
@@ -264,6 +267,7 @@ extern "C" {
 #include "network/stk_peer.hpp"
 #include "online/profile_manager.hpp"
 #include "online/request_manager.hpp"
+#include "physics/triangle_mesh.hpp"
 #include "race/grand_prix_manager.hpp"
 #include "race/highscore_manager.hpp"
 #include "race/history.hpp"
@@ -592,6 +596,14 @@ void cmdLineHelp()
                               "laps.\n"
     "       --profile-time=n   Enable automatic driven profile mode for n "
                               "seconds.\n"
+    "       --profile-report=file Write the results of a profile run as json "
+                              "to file.\n"
+    "       --simulation-speed=f With --no-graphics and no networking, run "
+                              "the race f times\n"
+    "                          faster than real time (0 as fast as "
+                              "possible).\n"
+    "       --simulation-checkpoint=n Log the simulation progress every n "
+                              "simulated seconds.\n"
     "       --unlock-all       Permanently unlock all karts and tracks for testing.\n"
     "       --no-unlock-all    Disable unlock-all (i.e. base unlocking on player achievement).\n"
     "       --xmas=n           Toggle Xmas/Christmas mode. n=0 Use current date, n=1, Always enable,\n"
@@ -606,7 +618,19 @@ void cmdLineHelp()
     "                          spaces are allowed in the track names.\n"
     "       --demo-laps=n      Number of laps to use in a demo.\n"
     "       --demo-karts=n     Number of karts to use in a demo.\n"
-    "       --history          Replay history file 'history.dat'.\n"
+    "       --history          Replay history file 'history.dat', and report "
+                              "the first tick\n"
+    "                          at which the state differs from the "
+                              "recording.\n"
+    "       --history-hashes   Record a hash of the world state per tick in "
+                              "the history,\n"
+    "                          which --history compares.\n"
+    "       --history-keyframes Record a keyframe of the world state every "
+                              "second in the\n"
+    "                          history (races only).\n"
+    "       --history-seek=s   Jump to time s (in seconds) when replaying a "
+                              "history,\n"
+    "                          starting from the last keyframe before it.\n"
     "       --server-config=file Specify the server_config.xml for server hosting, it will create\n"
     "                            one if not found.\n"
     "       --network-console  Enable network console.\n"
@@ -1001,6 +1025,7 @@ int handleCmdLinePreliminary()
     if (CommandLine::has("--seed", &n))
     {
         srand(n);
+        UserConfigParams::m_random_seed = n;
         Log::info("main", "STK using random seed (%d)", n);
     }
 
@@ -1531,6 +1556,9 @@ int handleCmdLine(bool has_server_config, bool has_parent_process)
         {
             const KartProperties *km =
                 kart_properties_manager->getKartById(i);
+            // Without graphics the meshes are only loaded for a race
+            const scene::IAnimatedMesh *mesh =
+                km->getMasterKartModel().getModel();
             Log::info("main", "%s:\t%swidth: %f length: %f height: %f "
                       "mesh-buffer count %d",
                       km->getIdent().c_str(),
@@ -1538,8 +1566,7 @@ int handleCmdLine(bool has_server_config, bool has_parent_process)
                       km->getMasterKartModel().getWidth(),
                       km->getMasterKartModel().getLength(),
                       km->getMasterKartModel().getHeight(),
-                      km->getMasterKartModel().getModel()
-                        ->getMeshBufferCount());
+                      mesh ? (int)mesh->getMeshBufferCount() : 0);
         }    // for i
     }   // --kartsize-debug
 
@@ -1726,6 +1753,30 @@ int handleCmdLine(bool has_server_config, bool has_parent_process)
         RaceManager::get()->setNumLaps(999999); // profile end depends on time
     }   // --profile-time
 
+    if(CommandLine::has("--profile-report", &s))
+    {
+        ProfileWorld::setReportFile(s);
+    }   // --profile-report
+
+    float f;
+    if(CommandLine::has("--simulation-speed", &f))
+    {
+        if (!GUIEngine::isNoGraphics())
+        {
+            Log::warn("main", "--simulation-speed needs --no-graphics, "
+                      "ignored.");
+        }
+        else
+        {
+            UserConfigParams::m_simulation_speed = std::max(f, 0.0f);
+            Log::info("main", "Simulation speed %f.",
+                      UserConfigParams::m_simulation_speed);
+        }
+    }   // --simulation-speed
+
+    if(CommandLine::has("--simulation-checkpoint", &n))
+        UserConfigParams::m_simulation_checkpoint = std::max(n, 0);
+
     if(CommandLine::has("--history"))
     {
         history->setReplayHistory(true);
@@ -1735,6 +1786,19 @@ int handleCmdLine(bool has_server_config, bool has_parent_process)
             UserConfigParams::m_no_start_screen = true;
     }   // --history
 
+    if(CommandLine::has("--history-hashes"))
+        UserConfigParams::m_history_state_hashes = true;
+
+    if(CommandLine::has("--history-keyframes"))
+        UserConfigParams::m_history_keyframes = true;
+
+    if(CommandLine::has("--history-seek", &s))
+    {
+        float t = 0;
+        StringUtils::fromString(s, t);
+        history->setSeekTicks(stk_config->time2Ticks(t));
+    }
+
     // Demo mode
     if(CommandLine::has("--demo-mode", &s))
     {
@@ -2811,10 +2875,22 @@ void runUnitTests()
     GraphicsRestrictions::unitTesting();
     Log::info("UnitTest", "NetworkString");
     NetworkString::unitTesting();
+    Log::info("UnitTest", "NetworkBitWriter and NetworkBitReader");
+    NetworkBitWriter::unitTesting();
     Log::info("UnitTest", "SocketAddress");
     SocketAddress::unitTesting();
+    Log::info("UnitTest", "NetworkConsole");
+    NetworkConsole::unitTesting();
     Log::info("UnitTest", "StringUtils::versionToInt");
     StringUtils::unitTesting();
+    Log::info("UnitTest", "XMLNode");
+    XMLNode::unitTesting();
+    Log::info("UnitTest", "Asset packs");
+    file_manager->unitTesting();
+    Log::info("UnitTest", "TriangleMesh BVH cache");
+    TriangleMesh::unitTesting();
+    Log::info("UnitTest", "Translation cache");
+    translations->unitTesting();
 
     Log::info("UnitTest", "Easter detection");
     // Test easter mode: in 2015 Easter is 5th of April - check with 0 days
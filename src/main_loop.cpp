@@ -59,6 +59,7 @@
 #include "utils/translation.hpp"
 #include "io/rich_presence.hpp"
 
+#include <algorithm>
 #include <thread>
 
 #include <IrrlichtDevice.h>
@@ -109,6 +110,9 @@ MainLoop::MainLoop(unsigned parent_pid, bool download_assets)
     m_allow_large_dt  = false;
     m_frame_before_loading_world = false;
     m_download_assets = download_assets;
+    m_simulation_start = m_curr_time;
+    m_last_checkpoint  = -1;
+    resetCheckpointStats();
 #ifdef WIN32
     if (parent_pid != 0)
     {
@@ -221,9 +225,10 @@ double MainLoop::getLimitedDt()
     }
 #endif
 
-    // In profile mode without graphics, run with a fixed dt of 1/60
-    if ((ProfileWorld::isProfileMode() && GUIEngine::isNoGraphics()) ||
-        UserConfigParams::m_arena_ai_stats)
+    // In headless simulation (e.g. profile mode without graphics), run with
+    // a fixed dt of 1/60 independent of real time. run() will pace the
+    // frames if a simulation speed is set.
+    if (isHeadlessSimulation() || UserConfigParams::m_arena_ai_stats)
     {
         return 1.0f/60.0f;
     }
@@ -311,6 +316,72 @@ double MainLoop::getLimitedDt()
     return dt;
 }   // getLimitedDt
 
+//-----------------------------------------------------------------------------
+/** Returns true if the world is advanced independently of real time: this is
+ *  the case without graphics and networking if either profile mode or a
+ *  simulation speed (--simulation-speed) is used.
+ */
+bool MainLoop::isHeadlessSimulation() const
+{
+    return GUIEngine::isNoGraphics() &&
+           !NetworkConfig::get()->isNetworking() &&
+           (ProfileWorld::isProfileMode() ||
+            UserConfigParams::m_simulation_speed >= 0.0f);
+}   // isHeadlessSimulation
+
+//-----------------------------------------------------------------------------
+/** In headless simulation logs the progress of the current race every
+ *  --simulation-checkpoint simulated seconds, so long batch runs can be
+ *  monitored.
+ */
+void MainLoop::checkpointSimulation()
+{
+    World* world = World::getWorld();
+    if (!world || UserConfigParams::m_simulation_checkpoint <= 0)
+        return;
+
+    int ticks = world->getTicksSinceStart();
+    int interval = stk_config->time2Ticks(
+        (float)UserConfigParams::m_simulation_checkpoint);
+    int checkpoint = ticks / std::max(interval, 1);
+    // A new world was started
+    if (checkpoint < m_last_checkpoint || m_last_checkpoint == -1)
+    {
+        m_simulation_start = std::chrono::steady_clock::now();
+        m_last_checkpoint = checkpoint;
+        resetCheckpointStats();
+        return;
+    }
+    if (checkpoint == m_last_checkpoint)
+        return;
+
+    m_last_checkpoint = checkpoint;
+    TimePoint now = std::chrono::steady_clock::now();
+    double real_time = convertToTime(now, m_simulation_start) * 0.001;
+    double interval_time = convertToTime(now, m_checkpoint_time) * 0.001;
+    float world_time = stk_config->ticks2Time(ticks);
+    Log::info("MainLoop", "Checkpoint: %d ticks, world time %f, "
+              "real time %f, %.1fx real time.", ticks, world_time, real_time,
+              real_time > 0.0 ? world_time / real_time : 0.0);
+    Log::info("MainLoop", "Checkpoint: last %d ticks in %f s, world update "
+              "%.3f ms average, %.3f ms max.", m_checkpoint_ticks,
+              interval_time, m_checkpoint_ticks > 0 ?
+              m_checkpoint_update_time / m_checkpoint_ticks : 0.0,
+              m_checkpoint_max_update_time);
+    resetCheckpointStats();
+}   // checkpointSimulation
+
+//-----------------------------------------------------------------------------
+/** Starts measuring the world updates for the next simulation checkpoint.
+ */
+void MainLoop::resetCheckpointStats()
+{
+    m_checkpoint_time = std::chrono::steady_clock::now();
+    m_checkpoint_ticks = 0;
+    m_checkpoint_update_time = 0.0;
+    m_checkpoint_max_update_time = 0.0;
+}   // resetCheckpointStats
+
 //-----------------------------------------------------------------------------
 /** Updates all race related objects.
  *  \param ticks Number of ticks (physics steps) to simulate - should be 1.
@@ -623,6 +694,11 @@ void MainLoop::run()
             bool fast_forward = NetworkConfig::get()->isNetworking() &&
                 NetworkConfig::get()->isClient() &&
                 num_steps > stk_config->time2Ticks(1.0f);
+            // Measure the real duration of the world updates for the
+            // simulation checkpoints
+            const bool measure_updates =
+                UserConfigParams::m_simulation_checkpoint > 0 &&
+                isHeadlessSimulation();
             for (int i = 0; i < num_steps; i++)
             {
                 if (World::getWorld() && history->replayHistory())
@@ -642,7 +718,29 @@ void MainLoop::run()
                 PROFILER_PUSH_CPU_MARKER("Update race", 0, 255, 255);
                 if (World::getWorld())
                 {
+                    TimePoint update_start;
+                    if (measure_updates)
+                        update_start = std::chrono::steady_clock::now();
                     updateRace(1, fast_forward);
+                    if (measure_updates)
+                    {
+                        double t = convertToTime(
+                            std::chrono::steady_clock::now(), update_start);
+                        m_checkpoint_ticks++;
+                        m_checkpoint_update_time += t;
+                        m_checkpoint_max_update_time =
+                            std::max(m_checkpoint_max_update_time, t);
+                    }
+                }
+                // Record or compare the world state for history replays
+                if (World::getWorld() &&
+                    !NetworkConfig::get()->isNetworking())
+                {
+                    const int ticks = World::getWorld()->getTicksSinceStart();
+                    if (history->needsStateHash())
+                        history->updateStateHash(ticks);
+                    if (history->needsKeyFrames())
+                        history->updateKeyFrame(ticks);
                 }
                 PROFILER_POP_CPU_MARKER();
 
@@ -679,6 +777,9 @@ void MainLoop::run()
             if (World::getWorld() && RewindManager::isEnabled())
                  RewindManager::get()->handleResetSmoothNetworkBody();
 
+            if (isHeadlessSimulation())
+                checkpointSimulation();
+
             // Handle controller the last to avoid slow PC sending actions too 
             // late
             if (!GUIEngine::isNoGraphics())
@@ -715,11 +816,26 @@ void MainLoop::run()
             (irr_driver->isRecording() && UserConfigParams::m_limit_game_fps) ?
             UserConfigParams::m_record_fps : UserConfigParams::m_max_fps;
 
+        if (isHeadlessSimulation())
+        {
+            // Each frame simulates 1/60 s, pace it to the requested multiple
+            // of real time, or run as fast as possible with speed 0.
+            const float speed = UserConfigParams::m_simulation_speed;
+            if (speed > 0.0f && frame_time < 1.0 / 60.0 / speed)
+            {
+                double wait_time = 1.0 / 60.0 / speed - frame_time;
+                std::chrono::nanoseconds wait_time_ns(
+                    (uint64_t)(wait_time * 1000.0 * 1000.0 * 1000.0));
+                PROFILER_PUSH_CPU_MARKER("Throttle simulation", 0, 0, 0);
+                std::this_thread::sleep_for(wait_time_ns);
+                PROFILER_POP_CPU_MARKER();
+            }
+        }
         // Throttle fps if more than maximum, which can reduce
         // the noise the fan on a graphics card makes.
         // No need to throttle if vsync is on (m_swap_interval == 1) as
         // endScene handles fps according to monitor refresh rate
-        if ((UserConfigParams::m_swap_interval == 0 ||
+        else if ((UserConfigParams::m_swap_interval == 0 ||
             GUIEngine::isNoGraphics()) &&
             m_throttle_fps && !ProfileWorld::isProfileMode() &&
             current_fps > max_fps)
@@ -53,8 +53,25 @@ private:
     TimePoint m_curr_time;
     TimePoint m_prev_time;
     unsigned m_parent_pid;
+
+    /** Headless simulation only: real time at which the current world
+     *  started, and index of the last checkpoint logged. */
+    TimePoint m_simulation_start;
+    int       m_last_checkpoint;
+
+    /** Headless simulation only: real time of the last checkpoint, and the
+     *  number, total and maximum real duration (in ms) of the world updates
+     *  since then. */
+    TimePoint m_checkpoint_time;
+    int       m_checkpoint_ticks;
+    double    m_checkpoint_update_time;
+    double    m_checkpoint_max_update_time;
+
     double   getLimitedDt();
     void     updateRace(int ticks, bool fast_forward);
+    bool     isHeadlessSimulation() const;
+    void     checkpointSimulation();
+    void     resetCheckpointStats();
     double   convertToTime(const TimePoint& cur, const TimePoint& prev) const
     {
         auto duration = cur - prev;
@@ -22,12 +22,18 @@
 #include "graphics/camera.hpp"
 #include "graphics/irr_driver.hpp"
 #include "karts/kart_with_stats.hpp"
+#include "config/stk_config.hpp"
+#include "karts/controller/ai_base_controller.hpp"
 #include "karts/controller/controller.hpp"
 #include "tracks/track.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/string_utils.hpp"
 
 #include <ISceneManager.h>
 #include <IVideoDriver.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -35,6 +41,7 @@
 ProfileWorld::ProfileType ProfileWorld::m_profile_mode=PROFILE_NONE;
 int   ProfileWorld::m_num_laps    = 0;
 float ProfileWorld::m_time        = 0.0f;
+std::string ProfileWorld::m_report_file;
 
 //-----------------------------------------------------------------------------
 /** The constructor sets the number of (local) players to 0, since only AI
@@ -154,7 +161,11 @@ bool ProfileWorld::isRaceOver()
  */
 void ProfileWorld::update(int ticks)
 {
+    auto start = std::chrono::steady_clock::now();
     StandardRace::update(ticks);
+    auto duration = std::chrono::steady_clock::now() - start;
+    m_tick_times.push_back((float)std::chrono::duration_cast
+        <std::chrono::microseconds>(duration).count());
 
     m_frame_count++;
     video::IVideoDriver *driver = irr_driver->getVideoDriver();
@@ -169,6 +180,111 @@ void ProfileWorld::update(int ticks)
 
 }   // update
 
+//-----------------------------------------------------------------------------
+/** Records the lap time of a kart for the report.
+ *  \param kart_index Index of the kart that crossed the start line.
+ */
+void ProfileWorld::newLap(unsigned int kart_index)
+{
+    const auto &info     = m_kart_info[kart_index];
+    const int old_laps   = info.m_finished_laps;
+    const int old_ticks  = info.m_ticks_at_last_lap;
+    StandardRace::newLap(kart_index);
+
+    if (m_lap_times.size() <= kart_index)
+        m_lap_times.resize(kart_index + 1);
+    // The first crossing of the start line only starts lap 1
+    if (info.m_finished_laps > old_laps && old_laps >= 0 &&
+        old_ticks != INT_MAX)
+    {
+        m_lap_times[kart_index].push_back(
+            stk_config->ticks2Time(info.m_ticks_at_last_lap - old_ticks));
+    }
+}   // newLap
+
+//-----------------------------------------------------------------------------
+/** Writes the results of the race in json format to m_report_file, so that
+ *  many profile runs can be aggregated by a script (see
+ *  tools/ai_test/batch_profile.py).
+ *  \param runtime Real time the race took in seconds.
+ */
+void ProfileWorld::writeReport(float runtime)
+{
+    FILE *fd = FileUtils::fopenU8Path(m_report_file, "w");
+    if (!fd)
+    {
+        Log::error("profile", "Can't open '%s' for writing the report.",
+                   m_report_file.c_str());
+        return;
+    }
+
+    std::vector<float> sorted = m_tick_times;
+    std::sort(sorted.begin(), sorted.end());
+    float total = 0.0f;
+    for (float t : sorted)
+        total += t;
+    auto percentile = [&sorted](float p) -> float
+    {
+        if (sorted.empty())
+            return 0.0f;
+        size_t i = (size_t)(p * (sorted.size() - 1) + 0.5f);
+        return sorted[i];
+    };
+
+    std::ostringstream ss;
+    ss << "{\"track\":\""
+       << StringUtils::jsonEncode(Track::getCurrentTrack()->getIdent()) << "\","
+       << "\"reverse\":"
+       << (RaceManager::get()->getReverseTrack() ? "true" : "false") << ","
+       << "\"difficulty\":" << (int)RaceManager::get()->getDifficulty() << ","
+       << "\"mode\":\"" << (m_profile_mode == PROFILE_LAPS ? "laps" : "time")
+       << "\",\"laps\":" << RaceManager::get()->getNumLaps() << ","
+       << "\"race_time\":" << getTime() << ","
+       << "\"runtime\":" << runtime << ","
+       << "\"ticks\":" << sorted.size() << ","
+       << "\"tick_time_us\":{"
+       << "\"mean\":" << (sorted.empty() ? 0.0f : total / sorted.size())
+       << ",\"median\":" << percentile(0.5f)
+       << ",\"p95\":" << percentile(0.95f)
+       << ",\"p99\":" << percentile(0.99f)
+       << ",\"max\":" << (sorted.empty() ? 0.0f : sorted.back()) << "},"
+       << "\"karts\":[";
+
+    for (unsigned int i = 0; i < m_karts.size(); i++)
+    {
+        auto kart = std::dynamic_pointer_cast<KartWithStats>(m_karts[i]);
+        const AIBaseController *ai =
+            dynamic_cast<const AIBaseController*>(kart->getController());
+        if (i > 0)
+            ss << ",";
+        ss << "{\"ident\":\"" << StringUtils::jsonEncode(kart->getIdent())
+           << "\",\"controller\":\""
+           << StringUtils::jsonEncode(
+                  kart->getController()->getControllerName())
+           << "\","
+           << "\"start_position\":" << i + 1 << ","
+           << "\"end_position\":" << kart->getPosition() << ","
+           << "\"finish_time\":" << kart->getFinishTime() << ","
+           << "\"lap_times\":[";
+        if (i < m_lap_times.size())
+        {
+            for (unsigned int j = 0; j < m_lap_times[i].size(); j++)
+                ss << (j > 0 ? "," : "") << m_lap_times[i][j];
+        }
+        ss << "],\"top_speed\":" << kart->getTopSpeed() << ","
+           << "\"stuck_count\":" << (ai ? ai->getStuckCount() : 0) << ","
+           << "\"rescue_count\":" << kart->getRescueCount() << ","
+           << "\"rescue_time\":" << kart->getRescueTime() << ","
+           << "\"explosion_count\":" << kart->getExplosionCount() << ","
+           << "\"off_track_count\":" << kart->getOffTrackCount() << ","
+           << "\"skidding_time\":" << kart->getSkiddingTime() << "}";
+    }   // for i < m_karts.size()
+    ss << "]}\n";
+
+    fputs(ss.str().c_str(), fd);
+    fclose(fd);
+}   // writeReport
+
 //-----------------------------------------------------------------------------
 /** This function is called when the race is finished, but end-of-race
  *  animations have still to be played. In the case of profiling,
@@ -347,6 +463,9 @@ void ProfileWorld::enterRaceOverState()
                off_track_count, energy);
         Log::verbose("profile", "");
     }   // for it !=all_groups.end
+
+    if (!m_report_file.empty())
+        writeReport(runtime);
     delete this;
     main_loop->abort();
 }   // enterRaceOverState
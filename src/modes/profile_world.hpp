@@ -21,6 +21,9 @@
 
 #include "modes/standard_race.hpp"
 
+#include <string>
+#include <vector>
+
 class Kart;
 
 /**
@@ -63,6 +66,18 @@ private:
     /** Number of calls to draw. */
     long long    m_num_calls;
 
+    /** If not empty, a machine readable (json) report is written to this
+     *  file at the end of the race. */
+    static std::string m_report_file;
+
+    /** Real time used by each call to update, in microseconds. */
+    std::vector<float> m_tick_times;
+
+    /** The lap times of each kart. */
+    std::vector<std::vector<float> > m_lap_times;
+
+    void writeReport(float runtime);
+
 protected:
     /** In laps based profiling: number of laps to run. Also
      *  used by DemoWorld. */
@@ -81,10 +96,15 @@ public:
     virtual  void        update(int ticks);
     virtual  bool        isRaceOver();
     virtual  void        enterRaceOverState();
+    virtual  void        newLap(unsigned int kart_index) OVERRIDE;
 
     static   void setProfileModeTime(float time);
     static   void setProfileModeLaps(int laps);
     // ------------------------------------------------------------------------
+    /** Sets the file to which a json report of the race is written. */
+    static   void setReportFile(const std::string &file)
+                                                     { m_report_file = file; }
+    // ------------------------------------------------------------------------
     /** Returns true if profile mode was selected. */
     static   bool isProfileMode() {return m_profile_mode!=PROFILE_NONE; }
 };
@@ -35,6 +35,7 @@
 #include "io/file_manager.hpp"
 #include "input/device_manager.hpp"
 #include "input/keyboard_device.hpp"
+#include "items/item_manager.hpp"
 #include "items/projectile_manager.hpp"
 #include "karts/controller/battle_ai.hpp"
 #include "karts/ghost_kart.hpp"
@@ -56,6 +57,7 @@
 #include "network/protocols/client_lobby.hpp"
 #include "network/network_config.hpp"
 #include "network/rewind_manager.hpp"
+#include "network/state_hash.hpp"
 #include "network/stk_host.hpp"
 #include "physics/btKart.hpp"
 #include "physics/physics.hpp"
@@ -85,6 +87,7 @@
 #include <algorithm>
 #include <assert.h>
 #include <ctime>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 
@@ -483,7 +486,8 @@ std::shared_ptr<AbstractKart> World::createKart
 
     btTransform init_pos   = getStartTransform(index - gk);
     std::shared_ptr<AbstractKart> new_kart;
-    if (RewindManager::get()->isEnabled())
+    // History keyframes need to save and restore the kart state
+    if (RewindManager::get()->isEnabled() || history->needsKeyFrames())
     {
         auto kr = std::make_shared<KartRewinder>(kart_ident, index, position,
             init_pos, handicap, ri);
@@ -653,7 +657,14 @@ World::~World()
     if (m_process_type == PT_MAIN)
         Weather::kill();
 
+    // Keep the meshes of the karts of this race loaded, a server usually
+    // uses most of them again in the next race
+    std::set<std::string> used_karts;
+    for (auto& kart : m_karts)
+        used_karts.insert(kart->getIdent());
     m_karts.clear();
+    if (GUIEngine::isNoGraphics())
+        kart_properties_manager->unloadUnusedKartModels(used_karts);
     if(RaceManager::get()->hasGhostKarts() || RaceManager::get()->isRecordingRace())
     {
         // Destroy the old replay object, which also stored the ghost
@@ -1257,6 +1268,37 @@ void World::updateTrack(int ticks)
     Track::getCurrentTrack()->update(ticks);
 }   // update Track
 
+// ----------------------------------------------------------------------------
+/** Computes a hash of the authoritative world state: world time, kart
+ *  bodies, items and projectiles. It is used to detect desynchronisation
+ *  between server and clients, and non-determinism when replaying a
+ *  history.
+ */
+uint64_t World::computeStateHash() const
+{
+    StateHash hash;
+    hash.addInt(getTicksSinceStart());
+    for (auto& kart : m_karts)
+    {
+        if (kart->isGhostKart())
+            continue;
+        hash.addBody(kart->getBody());
+        hash.addFloat(kart->getEnergy());
+    }
+
+    const ItemManager* im = Track::getCurrentTrack()->getItemManager();
+    for (unsigned int i = 0; i < im->getNumberOfItems(); i++)
+    {
+        const ItemState* item = im->getItem(i);
+        if (!item)
+            continue;
+        hash.addInt(i).addInt(item->getType())
+            .addInt(item->getTicksTillReturn());
+    }
+    ProjectileManager::get()->addToStateHash(&hash);
+    return hash.get();
+}   // computeStateHash
+
 // ----------------------------------------------------------------------------
 Highscores* World::getHighscores() const
 {
@@ -1608,7 +1650,8 @@ std::shared_ptr<AbstractKart> World::createKartWithTeam
         std::make_shared<GE::GERenderInfo>(1.0f));
 
     std::shared_ptr<AbstractKart> new_kart;
-    if (RewindManager::get()->isEnabled())
+    // History keyframes need to save and restore the kart state
+    if (RewindManager::get()->isEnabled() || history->needsKeyFrames())
     {
         auto kr = std::make_shared<KartRewinder>(kart_ident, index, position,
             init_pos, handicap, ri);
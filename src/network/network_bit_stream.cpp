@@ -0,0 +1,105 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/network_bit_stream.hpp"
+
+// ============================================================================
+/** Unit testing function, round trips values through NetworkBitWriter and
+ *  NetworkBitReader.
+ */
+void NetworkBitWriter::unitTesting()
+{
+    // Values of different widths, including ones crossing byte boundaries
+    BareNetworkString bits;
+    NetworkBitWriter bw(&bits);
+    bw.addBits(1, 1).addBits(0x55, 7).addBits(0xa5, 8)
+      .addBits(0x7fffffff, 31).addBits(0xdeadbeef, 32)
+      // Bits above the width must be ignored
+      .addBits(0xff, 1);
+    bw.flush();
+    // 1 + 7 + 8 + 31 + 32 + 1 = 80 bits
+    assert(bits.size() == 10);
+    NetworkBitReader br(&bits);
+    assert(br.getBits(1) == 1);
+    assert(br.getBits(7) == 0x55);
+    assert(br.getBits(8) == 0xa5);
+    assert(br.getBits(31) == 0x7fffffff);
+    assert(br.getBits(32) == 0xdeadbeef);
+    assert(br.getBits(1) == 1);
+
+    // Variable length integers: 0 and 15 fit into one group of 4 bits, 16
+    // needs two, and the extreme values need all eight
+    BareNetworkString var;
+    NetworkBitWriter vw(&var);
+    vw.addVarUInt(0).addVarUInt(15).addVarUInt(16).addVarUInt(UINT32_MAX)
+      .addVarInt(0).addVarInt(-1).addVarInt(INT32_MIN).addVarInt(INT32_MAX);
+    vw.flush();
+    NetworkBitReader vr(&var);
+    assert(vr.getVarUInt() == 0);
+    assert(vr.getVarUInt() == 15);
+    assert(vr.getVarUInt() == 16);
+    assert(vr.getVarUInt() == UINT32_MAX);
+    assert(vr.getVarInt() == 0);
+    assert(vr.getVarInt() == -1);
+    assert(vr.getVarInt() == INT32_MIN);
+    assert(vr.getVarInt() == INT32_MAX);
+
+    // Byte aligned data after flush and align
+    BareNetworkString mixed;
+    NetworkBitWriter mw(&mixed);
+    mw.addBool(true).addBits(5, 3);
+    mw.addBits(3, 2);
+    mw.flush();
+    mixed.addUInt16(0x1234).addFloat(1.5f);
+    NetworkBitWriter mw2(&mixed);
+    mw2.addVarUInt(300);
+    mw2.flush();
+    mixed.addUInt8(0x42);
+    NetworkBitReader mr(&mixed);
+    assert(mr.getBool());
+    assert(mr.getBits(3) == 5);
+    assert(mr.getBits(2) == 3);
+    mr.align();
+    assert(mixed.getUInt16() == 0x1234);
+    assert(mixed.getFloat() == 1.5f);
+    NetworkBitReader mr2(&mixed);
+    assert(mr2.getVarUInt() == 300);
+    mr2.align();
+    assert(mixed.getUInt8() == 0x42);
+    assert(mixed.size() == 0);
+
+    // A varint with more than eight groups can only come from corrupted data
+    BareNetworkString too_long;
+    NetworkBitWriter tw(&too_long);
+    for (unsigned i = 0; i < 9; i++)
+        tw.addBits(15, 4).addBool(true);
+    tw.addBits(0, 4).addBool(false);
+    tw.flush();
+    NetworkBitReader tr(&too_long);
+    bool rejected = false;
+    try
+    {
+        tr.getVarUInt();
+    }
+    catch (std::out_of_range&)
+    {
+        rejected = true;
+    }
+    assert(rejected);
+    (void)rejected;  // avoid warning about unused variable
+}   // unitTesting
@@ -0,0 +1,222 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/*! \file network_bit_stream.hpp
+ *  \brief Bit level writer and reader on top of BareNetworkString.
+ */
+
+#ifndef HEADER_NETWORK_BIT_STREAM_HPP
+#define HEADER_NETWORK_BIT_STREAM_HPP
+
+#include "network/network_string.hpp"
+#include "utils/no_copy.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+/** \ingroup network
+ *  Writes values with arbitrary number of bits into a BareNetworkString,
+ *  used for game states where most values (flags, timers, ...) only need
+ *  a few bits. The bits written are appended to the string in whole bytes,
+ *  flush() must be called before adding byte aligned data again, any
+ *  remaining bits of the last byte are padded with zero.
+ */
+class NetworkBitWriter : public NoCopy
+{
+private:
+    BareNetworkString* m_bns;
+
+    /** Bits not yet written to the string, lowest bits are written first. */
+    uint64_t m_pending;
+
+    /** Number of bits in m_pending. */
+    unsigned m_pending_bits;
+
+public:
+    // ------------------------------------------------------------------------
+    NetworkBitWriter(BareNetworkString* bns)
+    {
+        m_bns = bns;
+        m_pending = 0;
+        m_pending_bits = 0;
+    }   // NetworkBitWriter
+    // ------------------------------------------------------------------------
+    ~NetworkBitWriter()                { assert(m_pending_bits == 0); }
+    // ------------------------------------------------------------------------
+    /** Adds the lowest bits of an unsigned value.
+     *  \param value The value to add.
+     *  \param bits Number of bits to use, maximum 32. */
+    NetworkBitWriter& addBits(uint32_t value, unsigned bits)
+    {
+        assert(bits <= 32);
+        if (bits == 0)
+            return *this;
+        if (bits < 32)
+            value &= (1u << bits) - 1;
+        m_pending |= (uint64_t)value << m_pending_bits;
+        m_pending_bits += bits;
+        while (m_pending_bits >= 8)
+        {
+            m_bns->addUInt8((uint8_t)(m_pending & 0xff));
+            m_pending >>= 8;
+            m_pending_bits -= 8;
+        }
+        return *this;
+    }   // addBits
+    // ------------------------------------------------------------------------
+    /** Adds a boolean value using 1 bit. */
+    NetworkBitWriter& addBool(bool b)              { return addBits(b, 1); }
+    // ------------------------------------------------------------------------
+    /** Adds a variable length unsigned value, using groups of 4 bits
+     *  followed by a continuation bit, so 0 takes 5 bits and values up to
+     *  255 take 10 bits. */
+    NetworkBitWriter& addVarUInt(uint32_t value)
+    {
+        do
+        {
+            addBits(value & 15, 4);
+            value >>= 4;
+            addBool(value != 0);
+        }
+        while (value != 0);
+        return *this;
+    }   // addVarUInt
+    // ------------------------------------------------------------------------
+    /** Adds a variable length signed value, small negative numbers are
+     *  mapped to small unsigned values (zigzag encoding). */
+    NetworkBitWriter& addVarInt(int32_t value)
+    {
+        uint32_t u = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+        return addVarUInt(u);
+    }   // addVarInt
+    // ------------------------------------------------------------------------
+    /** Adds a 4 byte floating point value without any loss. */
+    NetworkBitWriter& addFloat(float f)
+    {
+        uint32_t u;
+        memcpy(&u, &f, sizeof(float));
+        return addBits(u, 32);
+    }   // addFloat
+    // ------------------------------------------------------------------------
+    /** Writes the remaining bits to the string (padded with zeros), so byte
+     *  aligned data can be added after this. */
+    void flush()
+    {
+        if (m_pending_bits > 0)
+        {
+            m_bns->addUInt8((uint8_t)(m_pending & 0xff));
+            m_pending = 0;
+            m_pending_bits = 0;
+        }
+    }   // flush
+    // ------------------------------------------------------------------------
+    static void unitTesting();
+};   // class NetworkBitWriter
+
+// ============================================================================
+/** \ingroup network
+ *  Reads values written by NetworkBitWriter from a BareNetworkString. Bytes
+ *  are only consumed from the string when bits of them are needed, so after
+ *  all values are read the string is at the same offset as it was after
+ *  NetworkBitWriter::flush(), and byte aligned data can be read again after
+ *  calling align().
+ */
+class NetworkBitReader : public NoCopy
+{
+private:
+    const BareNetworkString* m_bns;
+
+    /** Bits read from the string but not used yet, lowest bits first. */
+    uint64_t m_pending;
+
+    /** Number of bits in m_pending. */
+    unsigned m_pending_bits;
+
+public:
+    // ------------------------------------------------------------------------
+    NetworkBitReader(const BareNetworkString* bns)
+    {
+        m_bns = bns;
+        m_pending = 0;
+        m_pending_bits = 0;
+    }   // NetworkBitReader
+    // ------------------------------------------------------------------------
+    /** Returns an unsigned value of the given number of bits, maximum 32. */
+    uint32_t getBits(unsigned bits)
+    {
+        assert(bits <= 32);
+        if (bits == 0)
+            return 0;
+        while (m_pending_bits < bits)
+        {
+            m_pending |= (uint64_t)m_bns->getUInt8() << m_pending_bits;
+            m_pending_bits += 8;
+        }
+        uint32_t value = (uint32_t)(m_pending &
+            (bits == 32 ? 0xffffffffu : (1u << bits) - 1));
+        m_pending >>= bits;
+        m_pending_bits -= bits;
+        return value;
+    }   // getBits
+    // ------------------------------------------------------------------------
+    bool getBool()                               { return getBits(1) == 1; }
+    // ------------------------------------------------------------------------
+    uint32_t getVarUInt()
+    {
+        uint32_t value = 0;
+        unsigned shift = 0;
+        bool more = true;
+        while (more)
+        {
+            uint32_t group = getBits(4);
+            if (shift < 32)
+                value |= group << shift;
+            shift += 4;
+            more = getBool();
+            // Corrupted data, a valid value never uses more than 8 groups
+            if (more && shift >= 32)
+                throw std::out_of_range("getVarUInt too long.");
+        }
+        return value;
+    }   // getVarUInt
+    // ------------------------------------------------------------------------
+    int32_t getVarInt()
+    {
+        uint32_t u = getVarUInt();
+        return (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+    }   // getVarInt
+    // ------------------------------------------------------------------------
+    float getFloat()
+    {
+        uint32_t u = getBits(32);
+        float f;
+        memcpy(&f, &u, sizeof(float));
+        return f;
+    }   // getFloat
+    // ------------------------------------------------------------------------
+    /** Discards the padding bits of the current byte, so byte aligned data
+     *  can be read from the string again. */
+    void align()
+    {
+        m_pending = 0;
+        m_pending_bits = 0;
+    }   // align
+};   // class NetworkBitReader
+
+#endif
@@ -23,16 +23,28 @@
 #include "network/stk_host.hpp"
 #include "network/stk_peer.hpp"
 #include "network/protocols/server_lobby.hpp"
+#include "utils/log.hpp"
 #include "utils/time.hpp"
 #include "utils/vs.hpp"
 #include "main_loop.hpp"
 
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
 #include <iostream>
 #include <limits>
+#include <sstream>
+#include <vector>
 
 #ifndef WIN32
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <poll.h>
 #  include <stdint.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
 #  include <sys/time.h>
+#  include <sys/un.h>
 #  include <unistd.h>
 #endif
 
@@ -42,19 +54,182 @@ namespace NetworkConsole
 std::string g_cmd_buffer;
 #endif
 // ----------------------------------------------------------------------------
-void showHelp()
+void showHelp(std::ostream& out)
 {
-    std::cout << "Available command:" << std::endl;
-    std::cout << "help, Print this." << std::endl;
-    std::cout << "quit, Shut down the server." << std::endl;
-    std::cout << "kickall, Kick all players out of STKHost." << std::endl;
-    std::cout << "kick #, kick # peer of STKHost." << std::endl;
-    std::cout << "kickban #, kick and ban # peer of STKHost." << std::endl;
-    std::cout << "listpeers, List all peers with host ID and IP." << std::endl;
-    std::cout << "listban, List IP ban list of server." << std::endl;
-    std::cout << "speedstats, Show upload and download speed." << std::endl;
+    out << "Available command:" << std::endl;
+    out << "help, Print this." << std::endl;
+    out << "quit, Shut down the server." << std::endl;
+    out << "kickall, Kick all players out of STKHost." << std::endl;
+    out << "kick #, kick # peer of STKHost." << std::endl;
+    out << "kickban #, kick and ban # peer of STKHost." << std::endl;
+    out << "listpeers, List all peers with host ID and IP." << std::endl;
+    out << "listplayers, List all players with host ID and name." << std::endl;
+    out << "listban, List IP ban list of server." << std::endl;
+    out << "speedstats, Show upload and download speed." << std::endl;
+    out << "status, Show the lobby state and player count." << std::endl;
+    out << "reloadconfig, Read settings which need no restart from the "
+        "server config file again." << std::endl;
 }   // showHelp
 
+// ----------------------------------------------------------------------------
+const char* getStateName(ServerLobby::ServerState state)
+{
+    switch (state)
+    {
+    case ServerLobby::SET_PUBLIC_ADDRESS:     return "set-public-address";
+    case ServerLobby::REGISTER_SELF_ADDRESS:  return "register-self-address";
+    case ServerLobby::WAITING_FOR_START_GAME: return "waiting-for-start-game";
+    case ServerLobby::SELECTING:              return "selecting";
+    case ServerLobby::LOAD_WORLD:             return "load-world";
+    case ServerLobby::WAIT_FOR_WORLD_LOADED:  return "wait-for-world-loaded";
+    case ServerLobby::WAIT_FOR_RACE_STARTED:  return "wait-for-race-started";
+    case ServerLobby::RACING:                 return "racing";
+    case ServerLobby::WAIT_FOR_RACE_STOPPED:  return "wait-for-race-stopped";
+    case ServerLobby::RESULT_DISPLAY:         return "result-display";
+    case ServerLobby::ERROR_LEAVE:            return "error-leave";
+    case ServerLobby::EXITING:                return "exiting";
+    }
+    return "unknown";
+}   // getStateName
+
+// ----------------------------------------------------------------------------
+/** Executes a command of the network console or control socket. It only
+ *  uses thread-safe functions of STKHost and ServerLobby, so it can be
+ *  called from any thread.
+ *  \param host The STKHost.
+ *  \param cmd The command line.
+ *  \param out The output of the command.
+ *  \return False if the command is unknown or failed.
+ */
+bool executeCommand(STKHost* host, const std::string& cmd, std::ostream& out)
+{
+    std::stringstream ss(cmd);
+    std::string str;
+    int number = -1;
+    ss >> str >> number;
+    if (str == "help")
+    {
+        showHelp(out);
+    }
+    else if (str == "quit")
+    {
+        host->requestShutdown();
+    }
+    else if (str == "kickall")
+    {
+        auto peers = host->getPeers();
+        for (unsigned int i = 0; i < peers.size(); i++)
+        {
+            peers[i]->kick();
+        }
+    }
+    else if (str == "kick" && number != -1 &&
+        NetworkConfig::get()->isServer())
+    {
+        std::shared_ptr<STKPeer> peer = host->findPeerByHostId(number);
+        if (peer)
+            peer->kick();
+        else
+        {
+            out << "Unknown host id: " << number << std::endl;
+            return false;
+        }
+    }
+    else if (str == "kickban" && number != -1 &&
+        NetworkConfig::get()->isServer())
+    {
+        std::shared_ptr<STKPeer> peer = host->findPeerByHostId(number);
+        if (peer)
+        {
+            peer->kick();
+            // ATM use permanently ban
+            auto sl = LobbyProtocol::get<ServerLobby>();
+            // We don't support banning IPv6 address atm
+            if (sl && !peer->getAddress().isIPv6())
+                sl->saveIPBanTable(peer->getAddress());
+        }
+        else
+        {
+            out << "Unknown host id: " << number << std::endl;
+            return false;
+        }
+    }
+    else if (str == "listpeers")
+    {
+        auto peers = host->getPeers();
+        if (peers.empty())
+            out << "No peers exist" << std::endl;
+        for (unsigned int i = 0; i < peers.size(); i++)
+        {
+            out << peers[i]->getHostId() << ": " <<
+                peers[i]->getAddress().toString() <<  " " <<
+                peers[i]->getUserVersion() << std::endl;
+        }
+    }
+    else if (str == "listplayers")
+    {
+        auto sl = LobbyProtocol::get<ServerLobby>();
+        if (!sl)
+        {
+            out << "No server lobby" << std::endl;
+            return false;
+        }
+        // The profiles of the peers are only used by the lobby, it keeps
+        // a copy of the names
+        for (auto& player : sl->getPlayerNames())
+            out << player.first << ": " << player.second << std::endl;
+    }
+    else if (str == "listban")
+    {
+        auto sl = LobbyProtocol::get<ServerLobby>();
+        if (sl)
+            sl->listBanTable(out);
+    }
+    else if (str == "speedstats")
+    {
+        out << "Upload speed (KBps): " <<
+            (float)host->getUploadSpeed() / 1024.0f <<
+            "   Download speed (KBps): " <<
+            (float)host->getDownloadSpeed() / 1024.0f  << std::endl;
+    }
+    else if (str == "status")
+    {
+        auto sl = LobbyProtocol::get<ServerLobby>();
+        if (!sl)
+        {
+            out << "No server lobby" << std::endl;
+            return false;
+        }
+        out << "state: " << getStateName(sl->getCurrentState()) << std::endl;
+        out << "game-mode: " << sl->getGameMode() << std::endl;
+        out << "difficulty: " << sl->getDifficulty() << std::endl;
+        out << "lobby-players: " << sl->getLobbyPlayers() << std::endl;
+        out << "peers: " << host->getPeerCount() << std::endl;
+        out << "max-players: " << ServerConfig::m_server_max_players
+            << std::endl;
+    }
+    else if (str == "reloadconfig")
+    {
+        auto sl = LobbyProtocol::get<ServerLobby>();
+        if (!sl)
+        {
+            out << "No server lobby" << std::endl;
+            return false;
+        }
+        // Applied by the game thread, see ServerLobby::update
+        sl->requestServerConfigReload();
+        out << "Server config will be reloaded when the lobby is waiting "
+            "for players. Only kick-idle-player-seconds, auto-end and "
+            "state-hash can be changed without a restart." << std::endl;
+    }
+    else
+    {
+        out << "Unknown command: " << str << std::endl;
+        return false;
+    }
+    return true;
+}   // executeCommand
+
 // ----------------------------------------------------------------------------
 #ifndef WIN32
 bool pollCommand()
@@ -93,7 +268,7 @@ void mainLoop(STKHost* host)
     g_cmd_buffer.clear();
 #endif
 
-    showHelp();
+    showHelp(std::cout);
     std::string str = "";
     while (!host->requestedShutdown())
     {
@@ -101,89 +276,293 @@ void mainLoop(STKHost* host)
         if (!pollCommand())
             continue;
 
-        std::stringstream ss(g_cmd_buffer);
         if (g_cmd_buffer.empty())
             continue;
+        str = g_cmd_buffer;
         g_cmd_buffer.clear();
 #else
         getline(std::cin, str);
-        std::stringstream ss(str);
 #endif
+        executeCommand(host, str, std::cout);
+    }   // while !stop
+    main_loop->requestAbort();
+}   // mainLoop
+
+#if !defined(WIN32) && defined(AF_UNIX)
+// ----------------------------------------------------------------------------
+/** A connection to the control socket. */
+struct ControlClient
+{
+    int m_fd;
+    /** Received data which is not a complete request yet. */
+    std::string m_input;
+    /** Responses which could not be sent yet. */
+    std::string m_output;
+};   // ControlClient
+
+// ----------------------------------------------------------------------------
+/** Removes the first complete line from the received data of a control
+ *  socket client.
+ *  \param input The received data.
+ *  \param request The line, without its line ending.
+ *  \return False if there is no complete line yet.
+ */
+bool popControlRequest(std::string* input, std::string* request)
+{
+    const size_t end = input->find('\n');
+    if (end == std::string::npos)
+        return false;
+    request->assign(*input, 0, end);
+    input->erase(0, end + 1);
+    if (!request->empty() && request->back() == '\r')
+        request->pop_back();
+    return true;
+}   // popControlRequest
+
+// ----------------------------------------------------------------------------
+/** Executes a request of the control socket and appends the response,
+ *  "OK" or "ERROR", followed by the (non-empty) output lines of the command
+ *  and an empty line.
+ */
+void handleControlRequest(STKHost* host, const std::string& request,
+                          std::string* response)
+{
+    std::stringstream out;
+    const bool ok = executeCommand(host, request, out);
+    *response += ok ? "OK\n" : "ERROR\n";
+    std::string line;
+    while (std::getline(out, line))
+    {
+        if (!line.empty())
+            *response += line + "\n";
+    }
+    *response += "\n";
+}   // handleControlRequest
 
-        int number = -1;
-        ss >> str >> number;
-        if (str == "help")
+// ----------------------------------------------------------------------------
+/** Opens the listening control socket at the given path.
+ *  \return The socket, or -1 on error.
+ */
+int openControlSocket(const std::string& path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        Log::error("NetworkConsole", "Control socket path %s is too long.",
+            path.c_str());
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+
+    // Remove the socket of a previous server which was not shut down
+    // properly, but never another kind of file
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
         {
-            showHelp();
+            Log::error("NetworkConsole", "%s exists and is not a socket.",
+                path.c_str());
+            return -1;
         }
-        else if (str == "quit")
+        unlink(path.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        Log::error("NetworkConsole", "Cannot create control socket: %s.",
+            strerror(errno));
+        return -1;
+    }
+    // The commands can kick and ban players, so only the user running the
+    // server can connect
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0 || listen(fd, 8) != 0 ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0)
+    {
+        Log::error("NetworkConsole", "Cannot listen on control socket %s: "
+            "%s.", path.c_str(), strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}   // openControlSocket
+
+#endif
+
+// ----------------------------------------------------------------------------
+/** Serves the commands of the network console to local tools (e.g. to
+ *  monitor or administrate many servers) on a Unix domain socket. A request
+ *  is one command line, see handleControlRequest for the response. Clients
+ *  are handled with non-blocking sockets in this thread, so they never
+ *  block the game thread.
+ *  \param host The STKHost.
+ *  \param path Path of the socket.
+ */
+void controlSocketLoop(STKHost* host, const std::string& path)
+{
+#if !defined(WIN32) && defined(AF_UNIX)
+    VS::setThreadName("ControlSocket");
+
+    const int listen_fd = openControlSocket(path);
+    if (listen_fd == -1)
+        return;
+    Log::info("NetworkConsole", "Listening on control socket %s.",
+        path.c_str());
+
+    const unsigned max_clients = 8;
+    const size_t max_request_size = 1024;
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#endif
+    std::vector<ControlClient> clients;
+    std::vector<struct pollfd> fds;
+    while (!host->requestedShutdown())
+    {
+        fds.resize(clients.size() + 1);
+        fds[0].fd = listen_fd;
+        fds[0].events = POLLIN;
+        for (unsigned i = 0; i < clients.size(); i++)
         {
-            host->requestShutdown();
+            fds[i + 1].fd = clients[i].m_fd;
+            fds[i + 1].events = POLLIN;
+            if (!clients[i].m_output.empty())
+                fds[i + 1].events |= POLLOUT;
         }
-        else if (str == "kickall")
+        if (poll(fds.data(), fds.size(), 100) <= 0)
+            continue;
+
+        for (unsigned i = 0; i < clients.size(); i++)
         {
-            auto peers = host->getPeers();
-            for (unsigned int i = 0; i < peers.size(); i++)
+            ControlClient& client = clients[i];
+            const short revents = fds[i + 1].revents;
+            bool close_client = (revents & (POLLERR | POLLNVAL)) != 0;
+            if (!close_client && (revents & (POLLIN | POLLHUP)) != 0)
             {
-                peers[i]->kick();
+                char buffer[1024];
+                ssize_t len = recv(client.m_fd, buffer, sizeof(buffer), 0);
+                if (len > 0)
+                    client.m_input.append(buffer, len);
+                else if (len == 0 || (errno != EAGAIN && errno != EINTR))
+                    close_client = true;
+
+                std::string request;
+                while (popControlRequest(&client.m_input, &request))
+                {
+                    if (!request.empty())
+                        handleControlRequest(host, request, &client.m_output);
+                }
+                if (client.m_input.size() > max_request_size)
+                    close_client = true;
             }
-        }
-        else if (str == "kick" && number != -1 &&
-            NetworkConfig::get()->isServer())
-        {
-            std::shared_ptr<STKPeer> peer = host->findPeerByHostId(number);
-            if (peer)
-                peer->kick();
-            else
-                std::cout << "Unknown host id: " << number << std::endl;
-        }
-        else if (str == "kickban" && number != -1 &&
-            NetworkConfig::get()->isServer())
-        {
-            std::shared_ptr<STKPeer> peer = host->findPeerByHostId(number);
-            if (peer)
+            if (!close_client && !client.m_output.empty())
             {
-                peer->kick();
-                // ATM use permanently ban
-                auto sl = LobbyProtocol::get<ServerLobby>();
-                // We don't support banning IPv6 address atm
-                if (sl && !peer->getAddress().isIPv6())
-                    sl->saveIPBanTable(peer->getAddress());
+                ssize_t len = send(client.m_fd, client.m_output.data(),
+                    client.m_output.size(), flags);
+                if (len > 0)
+                    client.m_output.erase(0, len);
+                else if (len < 0 && errno != EAGAIN && errno != EINTR)
+                    close_client = true;
             }
-            else
-                std::cout << "Unknown host id: " << number << std::endl;
-        }
-        else if (str == "listpeers")
-        {
-            auto peers = host->getPeers();
-            if (peers.empty())
-                std::cout << "No peers exist" << std::endl;
-            for (unsigned int i = 0; i < peers.size(); i++)
+            if (close_client)
             {
-                std::cout << peers[i]->getHostId() << ": " <<
-                    peers[i]->getAddress().toString() <<  " " <<
-                    peers[i]->getUserVersion() << std::endl;
+                close(client.m_fd);
+                client.m_fd = -1;
             }
         }
-        else if (str == "listban")
-        {
-            auto sl = LobbyProtocol::get<ServerLobby>();
-            if (sl)
-                sl->listBanTable();
-        }
-        else if (str == "speedstats")
-        {
-            std::cout << "Upload speed (KBps): " <<
-                (float)host->getUploadSpeed() / 1024.0f <<
-                "   Download speed (KBps): " <<
-                (float)host->getDownloadSpeed() / 1024.0f  << std::endl;
-        }
-        else
+        clients.erase(std::remove_if(clients.begin(), clients.end(),
+            [](const ControlClient& c) { return c.m_fd == -1; }),
+            clients.end());
+
+        if ((fds[0].revents & POLLIN) == 0)
+            continue;
+        int fd;
+        while ((fd = accept(listen_fd, NULL, NULL)) >= 0)
         {
-            std::cout << "Unknown command: " << str << std::endl;
+            if (clients.size() >= max_clients ||
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0)
+            {
+                close(fd);
+                continue;
+            }
+#ifdef SO_NOSIGPIPE
+            const int set = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &set, sizeof(set));
+#endif
+            ControlClient client;
+            client.m_fd = fd;
+            clients.push_back(client);
         }
     }   // while !stop
-    main_loop->requestAbort();
-}   // mainLoop
+
+    for (ControlClient& client : clients)
+        close(client.m_fd);
+    close(listen_fd);
+    unlink(path.c_str());
+#else
+    Log::warn("NetworkConsole", "Control socket is not supported on this "
+        "platform.");
+#endif
+}   // controlSocketLoop
+
+// ----------------------------------------------------------------------------
+/** Tests the parsing of console commands and control socket requests, with
+ *  commands which need no STKHost or lobby to run.
+ */
+void unitTesting()
+{
+    std::stringstream out;
+    bool ok = executeCommand(NULL, "help", out);
+    assert(ok && out.str().find("reloadconfig, ") != std::string::npos);
+
+    out.str("");
+    ok = executeCommand(NULL, "helpme 1", out);
+    assert(!ok && out.str() == "Unknown command: helpme\n");
+
+    // Without a host id the kick commands are unknown
+    out.str("");
+    ok = executeCommand(NULL, "kick", out);
+    assert(!ok && out.str() == "Unknown command: kick\n");
+    out.str("");
+    ok = executeCommand(NULL, "kickban x", out);
+    assert(!ok && out.str() == "Unknown command: kickban\n");
+
+    // No lobby exists in unit tests
+    out.str("");
+    ok = executeCommand(NULL, "  status  ", out);
+    assert(!ok && out.str() == "No server lobby\n");
+
+#if !defined(WIN32) && defined(AF_UNIX)
+    // Requests split across reads, with Unix and Windows line endings
+    std::string input = "sta";
+    std::string request;
+    ok = popControlRequest(&input, &request);
+    assert(!ok && input == "sta");
+    input += "tus\r\n\nlistplayers\nkick";
+    ok = popControlRequest(&input, &request);
+    assert(ok && request == "status");
+    ok = popControlRequest(&input, &request);
+    assert(ok && request.empty());
+    ok = popControlRequest(&input, &request);
+    assert(ok && request == "listplayers");
+    ok = popControlRequest(&input, &request);
+    assert(!ok && input == "kick");
+
+    std::string response;
+    handleControlRequest(NULL, "help", &response);
+    assert(response.compare(0, 3, "OK\n") == 0);
+    assert(response.find("\n\n") == response.size() - 2);
+    response.clear();
+    handleControlRequest(NULL, "listplayers", &response);
+    handleControlRequest(NULL, "unknown", &response);
+    assert(response == "ERROR\nNo server lobby\n\n"
+                       "ERROR\nUnknown command: unknown\n\n");
+#endif
+    (void)ok;  // avoid warning about unused variable
+}   // unitTesting
 
 }
@@ -19,11 +19,15 @@
 #ifndef HEADER_NETWORK_CONSOLE_HPP
 #define HEADER_NETWORK_CONSOLE_HPP
 
+#include <string>
+
 class STKHost;
 
 namespace NetworkConsole
 {
     void mainLoop(STKHost* host);
+    void controlSocketLoop(STKHost* host, const std::string& path);
+    void unitTesting();
 };   // class NetworkConsole
 
 #endif // SERVER_CONSOLE_HPP
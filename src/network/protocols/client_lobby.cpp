@@ -401,6 +401,7 @@ std::vector<std::shared_ptr<NetworkPlayerProfile> >
 //-----------------------------------------------------------------------------
 void ClientLobby::update(int ticks)
 {
+    preloadVotedTracks();
     switch (m_state.load())
     {
     case LINKED:
@@ -303,11 +303,17 @@ void GameProtocol::addState(BareNetworkString *buffer)
 }   // addState
 
 // ----------------------------------------------------------------------------
-/** Called by a server to finalize the current state, which add updated
- *  names of rewinder using to the beginning of state buffer
- *  \param cur_rewinder List of current rewinder using.
+/** Called by a server to finalize the current state, which add the rewinder
+ *  ids using to the beginning of state buffer, together with the unique
+ *  identity of the ids clients may not know yet.
+ *  \param cur_rewinder List of current rewinder ids using.
+ *  \param names List of rewinder ids to include the unique identity.
+ *  \param has_state_hash If the hash of the world state is included.
+ *  \param state_hash The hash of the world state.
  */
-void GameProtocol::finalizeState(std::vector<std::string>& cur_rewinder)
+void GameProtocol::finalizeState(const std::vector<uint8_t>& cur_rewinder,
+                                 const std::vector<uint8_t>& names,
+                                 bool has_state_hash, uint64_t state_hash)
 {
     assert(NetworkConfig::get()->isServer());
     auto& buffer = m_data_to_send->getBuffer();
@@ -315,15 +321,20 @@ void GameProtocol::finalizeState(std::vector<std::string>& cur_rewinder)
         4/*time*/;
 
     m_data_to_send->reset();
-    std::vector<uint8_t> names;
-    names.push_back((uint8_t)cur_rewinder.size());
-    for (std::string& name : cur_rewinder)
+    BareNetworkString header;
+    header.addUInt8((uint8_t)names.size());
+    for (uint8_t id : names)
     {
-        names.push_back((uint8_t)name.size());
-        std::vector<uint8_t> rewinder(name.begin(), name.end());
-        names.insert(names.end(), rewinder.begin(), rewinder.end());
+        header.addUInt8(id)
+            .encodeString(RewindManager::get()->getRewinderName(id));
     }
-    buffer.insert(pos, names.begin(), names.end());
+    header.addUInt8((uint8_t)cur_rewinder.size());
+    for (uint8_t id : cur_rewinder)
+        header.addUInt8(id);
+    header.addUInt8(has_state_hash ? 1 : 0);
+    if (has_state_hash)
+        header.addUInt64(state_hash);
+    buffer.insert(pos, header.getBuffer().begin(), header.getBuffer().end());
 }   // finalizeState
 
 // ----------------------------------------------------------------------------
@@ -346,19 +357,31 @@ void GameProtocol::handleState(Event *event)
     NetworkString &data = event->data();
     int ticks          = data.getUInt32();
 
-    // Check for updated rewinder using
-    unsigned rewinder_size = data.getUInt8();
-    std::vector<std::string> rewinder_using;
-    for (unsigned i = 0; i < rewinder_size; i++)
+    // Check for unique identity of new rewinder ids
+    unsigned names_size = data.getUInt8();
+    std::vector<std::pair<uint8_t, std::string> > rewinder_names;
+    for (unsigned i = 0; i < names_size; i++)
     {
+        uint8_t id = data.getUInt8();
         std::string name;
         data.decodeString(&name);
-        rewinder_using.push_back(name);
+        rewinder_names.emplace_back(id, name);
     }
 
+    // Check for updated rewinder using
+    unsigned rewinder_size = data.getUInt8();
+    std::vector<uint8_t> rewinder_using;
+    for (unsigned i = 0; i < rewinder_size; i++)
+        rewinder_using.push_back(data.getUInt8());
+
+    bool has_state_hash = data.getUInt8() == 1;
+    uint64_t state_hash = has_state_hash ? data.getUInt64() : 0;
+
     // The memory for bns will be handled in the RewindInfoState object
     RewindInfoState* ris = new RewindInfoState(ticks, data.getCurrentOffset(),
-        rewinder_using, data.getBuffer());
+        rewinder_names, rewinder_using, data.getBuffer());
+    if (has_state_hash)
+        ris->setStateHash(state_hash);
     RewindManager::get()->addNetworkRewindInfo(ris);
 }   // handleState
 
@@ -114,7 +114,9 @@ public:
     void startNewState();
     void addState(BareNetworkString *buffer);
     void sendState();
-    void finalizeState(std::vector<std::string>& cur_rewinder);
+    void finalizeState(const std::vector<uint8_t>& cur_rewinder,
+                       const std::vector<uint8_t>& names,
+                       bool has_state_hash, uint64_t state_hash);
     void sendItemEventConfirmation(int ticks);
 
     virtual void undo(BareNetworkString *buffer) OVERRIDE;
@@ -39,11 +39,14 @@
 #include "states_screens/online/networking_lobby.hpp"
 #include "states_screens/race_result_gui.hpp"
 #include "states_screens/state_manager.hpp"
+#include "tracks/track.hpp"
 #include "tracks/track_manager.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/time.hpp"
 #include "utils/translation.hpp"
 
+#include <algorithm>
+
 std::weak_ptr<LobbyProtocol> LobbyProtocol::m_lobby[PT_COUNT];
 
 LobbyProtocol::LobbyProtocol()
@@ -53,6 +56,7 @@ LobbyProtocol::LobbyProtocol()
     resetGameStartedProgress();
     m_game_setup = new GameSetup();
     m_end_voting_period.store(0);
+    m_preload_tracks_changed = false;
 }   // LobbyProtocol
 
 // ----------------------------------------------------------------------------
@@ -91,6 +95,26 @@ void LobbyProtocol::loadWorld()
     if (m_process_type == PT_MAIN)
         input_manager->getDeviceManager()->setSinglePlayer(ap);
 
+    // Keep reading the files of the winning track if they are being read,
+    // but don't let the other tracks slow down loading
+    const std::string& winner = RaceManager::get()->getTrackName();
+    Track* winner_track = track_manager->getTrack(winner);
+    if (winner_track &&
+        std::find(m_prefetched_tracks.begin(), m_prefetched_tracks.end(),
+                  winner) != m_prefetched_tracks.end())
+    {
+        std::vector<std::string> files;
+        winner_track->getPreloadFiles(&files);
+        m_track_prefetcher.keepOnly(files);
+    }
+    else
+        m_track_prefetcher.cancel();
+    m_prefetched_tracks.clear();
+    std::unique_lock<std::mutex> ul(m_preload_tracks_mutex);
+    m_preload_tracks.clear();
+    m_preload_tracks_changed = false;
+    ul.unlock();
+
     // Load the actual world.
     m_game_setup->loadWorld();
     World::getWorld()->setNetworkWorld(true);
@@ -175,6 +199,10 @@ void LobbyProtocol::setup()
     m_last_live_join_util_ticks = 0;
     resetVotingTime();
     m_peers_votes.clear();
+    std::unique_lock<std::mutex> ul_preload(m_preload_tracks_mutex);
+    m_preload_tracks.clear();
+    m_preload_tracks_changed = false;
+    ul_preload.unlock();
     m_game_setup->reset();
 }   // setupNewGame
 
@@ -214,8 +242,72 @@ bool LobbyProtocol::isVotingOver()
 void LobbyProtocol::addVote(uint32_t host_id, const PeerVote &vote)
 {
     m_peers_votes[host_id] = vote;
+    updatePreloadTracks();
 }   // addVote
 
+//-----------------------------------------------------------------------------
+/** Determines the most voted tracks after a vote was added. Their files are
+ *  read by preloadVotedTracks() in the main thread.
+ */
+void LobbyProtocol::updatePreloadTracks()
+{
+    // Only the main process reads the files, a server running in a thread
+    // of a client shares them with the client
+    if (m_process_type != PT_MAIN)
+        return;
+
+    std::map<std::string, unsigned> track_votes;
+    for (auto& p : m_peers_votes)
+        track_votes[p.second.m_track_name]++;
+    std::vector<std::pair<unsigned, std::string> > sorted;
+    for (auto& t : track_votes)
+        sorted.emplace_back(t.second, t.first);
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const std::pair<unsigned, std::string>& a,
+           const std::pair<unsigned, std::string>& b)
+        {
+            return a.first > b.first;
+        });
+
+    // Two candidates are enough for the usual close votes
+    std::vector<std::string> tracks;
+    for (unsigned i = 0; i < sorted.size() && i < 2; i++)
+        tracks.push_back(sorted[i].second);
+
+    std::lock_guard<std::mutex> lock(m_preload_tracks_mutex);
+    if (tracks != m_preload_tracks)
+    {
+        m_preload_tracks = tracks;
+        m_preload_tracks_changed = true;
+    }
+}   // updatePreloadTracks
+
+//-----------------------------------------------------------------------------
+/** Starts reading the files of the most voted tracks in a separate thread if
+ *  they changed, so they are in the file cache if one of them wins. Loading
+ *  the track itself can't be done in advance, since irrlicht and the
+ *  physics are not thread safe. Must be called from the main thread.
+ */
+void LobbyProtocol::preloadVotedTracks()
+{
+    std::unique_lock<std::mutex> ul(m_preload_tracks_mutex);
+    if (!m_preload_tracks_changed)
+        return;
+    m_preload_tracks_changed = false;
+    std::vector<std::string> tracks = m_preload_tracks;
+    ul.unlock();
+
+    std::vector<std::string> files;
+    for (const std::string& ident : tracks)
+    {
+        Track* t = track_manager->getTrack(ident);
+        if (t)
+            t->getPreloadFiles(&files);
+    }
+    m_track_prefetcher.prefetch(files);
+    m_prefetched_tracks = tracks;
+}   // preloadVotedTracks
+
 //-----------------------------------------------------------------------------
 /** Returns the voting data for one host. Returns NULL if the vote from
  *  the given host id has not yet arrived (or if it is an invalid host id).
@@ -19,6 +19,7 @@
 #ifndef LOBBY_PROTOCOL_HPP
 #define LOBBY_PROTOCOL_HPP
 
+#include "io/file_prefetcher.hpp"
 #include "network/protocol.hpp"
 #include "utils/stk_process.hpp"
 
@@ -140,6 +141,25 @@ protected:
     /** Stores data about the online game to play. */
     GameSetup* m_game_setup;
 
+    /** Reads the files of the most voted tracks during voting, so that
+     *  the winning track loads faster. */
+    FilePrefetcher m_track_prefetcher;
+
+    /** Mutex to protect m_preload_tracks, votes are received in the
+     *  network thread of a server. */
+    std::mutex m_preload_tracks_mutex;
+
+    /** The most voted tracks, the first one has most votes. */
+    std::vector<std::string> m_preload_tracks;
+
+    /** Set when m_preload_tracks changed, but the prefetcher was not yet
+     *  started for them. */
+    bool m_preload_tracks_changed;
+
+    /** The tracks whose files the prefetcher reads, only used in the main
+     *  thread. */
+    std::vector<std::string> m_prefetched_tracks;
+
     // ------------------------------------------------------------------------
     void configRemoteKart(
         const std::vector<std::shared_ptr<NetworkPlayerProfile> >& players,
@@ -155,6 +175,10 @@ protected:
                             int live_join_util_ticks) const;
     // ------------------------------------------------------------------------
     void exitGameState();
+    // ------------------------------------------------------------------------
+    void updatePreloadTracks();
+    // ------------------------------------------------------------------------
+    void preloadVotedTracks();
 public:
 
     /** Creates either a client or server lobby protocol as a singleton. */
@@ -228,8 +228,12 @@ ServerLobby::ServerLobby() : LobbyProtocol()
     updateAddons();
 
     m_rs_state.store(RS_NONE);
+    m_reload_server_config.store(false);
     m_last_success_poll_time.store(StkTime::getMonoTimeMs() + 30000);
     m_last_unsuccess_poll_time = StkTime::getMonoTimeMs();
+    m_voting_end_time = 0;
+    m_load_wait_count = 0;
+    m_load_wait_total = 0;
     m_server_owner_id.store(-1);
     m_registered_for_once_only = false;
     setHandleDisconnections(true);
@@ -1575,6 +1579,18 @@ void ServerLobby::asynchronousUpdate()
         // Reset for next state usage
         resetPeersReady();
         configPeersStartTime();
+        if (m_voting_end_time != 0)
+        {
+            uint64_t wait = StkTime::getMonoTimeMs() - m_voting_end_time;
+            m_load_wait_count++;
+            m_load_wait_total += wait;
+            m_voting_end_time = 0;
+            Log::info("ServerLobby", "Players waited %.2f seconds for the "
+                "world to be loaded after voting (average %.2f seconds in %u "
+                "games).", wait / 1000.0f,
+                m_load_wait_total / 1000.0f / m_load_wait_count,
+                m_load_wait_count);
+        }
         break;
     }
     case SELECTING:
@@ -1602,6 +1618,7 @@ void ServerLobby::asynchronousUpdate()
         }
         if (go_on_race)
         {
+            m_voting_end_time = StkTime::getMonoTimeMs();
             *m_default_vote = winner_vote;
             m_item_seed = (uint32_t)StkTime::getTimeSinceEpoch();
             ItemManager::updateRandomSeed(m_item_seed);
@@ -2089,6 +2106,13 @@ void ServerLobby::finishedLoadingLiveJoinClient(Event* event)
  */
 void ServerLobby::update(int ticks)
 {
+    preloadVotedTracks();
+    if (m_state.load() == WAITING_FOR_START_GAME &&
+        m_reload_server_config.exchange(false))
+    {
+        if (ServerConfig::reloadServerConfig())
+            Log::info("ServerLobby", "Server config reloaded.");
+    }
     World* w = World::getWorld();
     bool world_started = m_state.load() >= WAIT_FOR_WORLD_LOADED &&
         m_state.load() <= RACING && m_server_has_loaded_world.load();
@@ -4021,6 +4045,17 @@ void ServerLobby::updatePlayerList(bool update_when_reset_server)
 
     m_lobby_players.store((int)all_profiles.size());
 
+    std::vector<std::pair<uint32_t, std::string> > player_names;
+    for (auto& profile : all_profiles)
+    {
+        player_names.emplace_back(profile->getHostId(),
+            StringUtils::wideToUtf8(profile->getName()));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_player_names_mutex);
+        std::swap(m_player_names, player_names);
+    }
+
     // No need to update player list (for started grand prix currently)
     if (!allowJoinedPlayersWaiting() &&
         m_state.load() > WAITING_FOR_START_GAME && !update_when_reset_server)
@@ -5008,19 +5043,20 @@ void ServerLobby::testBannedForOnlineId(STKPeer* peer,
 }   // testBannedForOnlineId
 
 //-----------------------------------------------------------------------------
-void ServerLobby::listBanTable()
+void ServerLobby::listBanTable(std::ostream& out)
 {
 #ifdef ENABLE_SQLITE3
     if (!m_db)
         return;
     auto printer = [](void* data, int argc, char** argv, char** name)
         {
+            std::ostream& out = *(std::ostream*)data;
             for (int i = 0; i < argc; i++)
             {
-                std::cout << name[i] << " = " << (argv[i] ? argv[i] : "NULL")
+                out << name[i] << " = " << (argv[i] ? argv[i] : "NULL")
                     << "\n";
             }
-            std::cout << "\n";
+            out << "\n";
             return 0;
         };
     if (m_ip_ban_table_exists)
@@ -5028,16 +5064,16 @@ void ServerLobby::listBanTable()
         std::string query = "SELECT * FROM ";
         query += ServerConfig::m_ip_ban_table;
         query += ";";
-        std::cout << "IP ban list:\n";
-        sqlite3_exec(m_db, query.c_str(), printer, NULL, NULL);
+        out << "IP ban list:\n";
+        sqlite3_exec(m_db, query.c_str(), printer, &out, NULL);
     }
     if (m_online_id_ban_table_exists)
     {
         std::string query = "SELECT * FROM ";
         query += ServerConfig::m_online_id_ban_table;
         query += ";";
-        std::cout << "Online Id ban list:\n";
-        sqlite3_exec(m_db, query.c_str(), printer, NULL, NULL);
+        out << "Online Id ban list:\n";
+        sqlite3_exec(m_db, query.c_str(), printer, &out, NULL);
     }
 #endif
 }   // listBanTable
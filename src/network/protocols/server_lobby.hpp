@@ -29,6 +29,7 @@
 #include <array>
 #include <atomic>
 #include <functional>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -139,6 +140,16 @@ private:
 
     std::atomic<uint32_t> m_server_owner_id;
 
+    /** Set by the control socket, the server config is reloaded by the game
+     *  thread when the lobby is waiting for players. */
+    std::atomic<bool> m_reload_server_config;
+
+    /** Host id and name of the lobby players, updated with the player list
+     *  for the network console, which must not read the peers' profiles. */
+    std::vector<std::pair<uint32_t, std::string> > m_player_names;
+
+    mutable std::mutex m_player_names_mutex;
+
     /** Official karts and tracks available in server. */
     std::pair<std::set<std::string>, std::set<std::string> > m_official_kts;
 
@@ -254,6 +265,16 @@ private:
 
     uint64_t m_client_starting_time;
 
+    /** Time when the voting ended, used to measure how long players wait
+     *  for the world to be loaded after voting. */
+    uint64_t m_voting_end_time;
+
+    /** Number of games and the total time in milliseconds players waited
+     *  for the world to be loaded after voting. */
+    unsigned m_load_wait_count;
+
+    uint64_t m_load_wait_total;
+
     // Calculated before each game started
     unsigned m_ai_count;
 
@@ -404,9 +425,14 @@ public:
     int getDifficulty() const                   { return m_difficulty.load(); }
     int getGameMode() const                      { return m_game_mode.load(); }
     int getLobbyPlayers() const              { return m_lobby_players.load(); }
+    std::vector<std::pair<uint32_t, std::string> > getPlayerNames() const
+    {
+        std::lock_guard<std::mutex> lock(m_player_names_mutex);
+        return m_player_names;
+    }
     void saveInitialItems(std::shared_ptr<NetworkItemManager> nim);
     void saveIPBanTable(const SocketAddress& addr);
-    void listBanTable();
+    void listBanTable(std::ostream& out);
     void initServerStatsTable();
     bool isAIProfile(const std::shared_ptr<NetworkPlayerProfile>& npp) const
     {
@@ -415,6 +441,7 @@ public:
     }
     uint32_t getServerIdOnline() const           { return m_server_id_online; }
     void setClientServerHostId(uint32_t id)   { m_client_server_host_id = id; }
+    void requestServerConfigReload()     { m_reload_server_config.store(true); }
     static int m_fixed_laps;
 };   // class ServerLobby
 
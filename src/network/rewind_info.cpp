@@ -48,12 +48,17 @@ void RewindInfo::setTicks(int ticks)
 
 // ============================================================================
 RewindInfoState::RewindInfoState(int ticks, int start_offset,
-                                 std::vector<std::string>& rewinder_using,
+                                 std::vector<std::pair<uint8_t, std::string> >&
+                                 rewinder_names,
+                                 std::vector<uint8_t>& rewinder_using,
                                  std::vector<uint8_t>& buffer)
                : RewindInfo(ticks, true/*is_confirmed*/)
 {
+    std::swap(m_rewinder_names, rewinder_names);
     std::swap(m_rewinder_using, rewinder_using);
     m_start_offset = start_offset;
+    m_state_hash = 0;
+    m_has_state_hash = false;
     m_buffer = new BareNetworkString();
     std::swap(m_buffer->getBuffer(), buffer);
 }   // RewindInfoState
@@ -66,6 +71,8 @@ RewindInfoState::RewindInfoState(int ticks, BareNetworkString* buffer,
                : RewindInfo(ticks, is_confirmed)
 {
     m_start_offset = 0;
+    m_state_hash = 0;
+    m_has_state_hash = false;
     m_buffer = buffer;
 }   // RewindInfoState
 
@@ -78,14 +85,19 @@ void RewindInfoState::restore()
 {
     m_buffer->reset();
     m_buffer->skip(m_start_offset);
-    for (const std::string& name : m_rewinder_using)
+    RewindManager* rm = RewindManager::get();
+    for (auto& p : m_rewinder_names)
+        rm->setRewinderName(p.first, p.second);
+
+    for (uint8_t id : m_rewinder_using)
     {
         const uint16_t data_size = m_buffer->getUInt16();
         const unsigned current_offset_now = m_buffer->getCurrentOffset();
-        std::shared_ptr<Rewinder> r =
-            RewindManager::get()->getRewinder(name);
-
-        if (!r)
+        std::shared_ptr<Rewinder> r = rm->getRewinder(id);
+        // The unique identity may not be known yet if previous states with
+        // it were lost, it will be included in a later state
+        const std::string& name = rm->getRewinderName(id);
+        if (!r && !name.empty())
         {
             // For now we only need to get missing rewinder from
             // projectile_manager
@@ -93,11 +105,11 @@ void RewindInfoState::restore()
         }
         if (!r)
         {
-            if (!RewindManager::get()->hasMissingRewinder(name))
+            if (!name.empty() && !rm->hasMissingRewinder(name))
             {
                 Log::error("RewindInfoState", "Missing rewinder %s",
                     name.c_str());
-                RewindManager::get()->addMissingRewinder(name);
+                rm->addMissingRewinder(name);
             }
             m_buffer->skip(data_size);
             continue;
@@ -92,17 +92,28 @@ public:
 class RewindInfoState: public RewindInfo
 {
 private:
-    std::vector<std::string> m_rewinder_using;
+    /** Unique identity of rewinder ids which the server included in this
+     *  state. */
+    std::vector<std::pair<uint8_t, std::string> > m_rewinder_names;
+
+    std::vector<uint8_t> m_rewinder_using;
 
     int m_start_offset;
 
     /** Pointer to the buffer which stores all states. */
     BareNetworkString *m_buffer;
 
+    /** Hash of the world state computed by the server, only valid if
+     *  m_has_state_hash is true (see World::computeStateHash()). */
+    uint64_t m_state_hash;
+
+    bool m_has_state_hash;
+
 public:
     // ------------------------------------------------------------------------
     RewindInfoState(int ticks, int start_offset,
-                    std::vector<std::string>& rewinder_using,
+                    std::vector<std::pair<uint8_t, std::string> >&
+                    rewinder_names, std::vector<uint8_t>& rewinder_using,
                     std::vector<uint8_t>& buffer);
     // ------------------------------------------------------------------------
     RewindInfoState(int ticks, BareNetworkString *buffer, bool is_confirmed);
@@ -114,6 +125,16 @@ public:
     /** Returns a pointer to the state buffer. */
     BareNetworkString *getBuffer() const { return m_buffer; }
     // ------------------------------------------------------------------------
+    void setStateHash(uint64_t hash)
+    {
+        m_state_hash = hash;
+        m_has_state_hash = true;
+    }   // setStateHash
+    // ------------------------------------------------------------------------
+    bool hasStateHash() const                     { return m_has_state_hash; }
+    // ------------------------------------------------------------------------
+    uint64_t getStateHash() const                     { return m_state_hash; }
+    // ------------------------------------------------------------------------
     virtual bool isState() const { return true; }
     // ------------------------------------------------------------------------
     /** Called when going back in time to undo any rewind information.
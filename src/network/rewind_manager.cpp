@@ -25,6 +25,7 @@
 #include "network/protocols/game_protocol.hpp"
 #include "network/rewinder.hpp"
 #include "network/rewind_info.hpp"
+#include "network/server_config.hpp"
 #include "network/smooth_network_body.hpp"
 #include "physics/physics.hpp"
 #include "race/history.hpp"
@@ -64,6 +65,19 @@ void RewindManager::destroy()
  */
 RewindManager::RewindManager()
 {
+    // Rewinder ids are sent as one byte, 255 is never assigned
+    m_rewinder_by_id.resize(256);
+    m_rewinder_names.resize(256);
+    m_rewinder_id_state.resize(256, 0);
+    m_next_rewinder_id = 0;
+    m_state_count = 0;
+    m_total_state_size = 0;
+    m_check_state_hash = false;
+    m_state_hash_checked = 0;
+    m_state_hash_mismatches = 0;
+    m_smoothing_applied = 0;
+    m_smoothing_skipped = 0;
+    SmoothNetworkBody::resetCorrectionCounters();
     reset();
 }   // RewindManager
 
@@ -73,6 +87,25 @@ RewindManager::RewindManager()
  */
 RewindManager::~RewindManager()
 {
+    if (m_state_count > 0)
+    {
+        Log::info("RewindManager", "Sent %u states, average size %.1f bytes.",
+            m_state_count, (double)m_total_state_size / m_state_count);
+    }
+    if (m_state_hash_checked > 0)
+    {
+        Log::info("RewindManager", "%u of %u checked state hashes didn't "
+            "match the server.", m_state_hash_mismatches,
+            m_state_hash_checked);
+    }
+    m_smoothing_applied += SmoothNetworkBody::getCorrectionsApplied();
+    m_smoothing_skipped += SmoothNetworkBody::getCorrectionsSkipped();
+    if (m_smoothing_applied + m_smoothing_skipped > 0)
+    {
+        Log::info("RewindManager", "Applied %u smoothing corrections, "
+            "skipped %u negligible ones.", m_smoothing_applied,
+            m_smoothing_skipped);
+    }
     for (RewindInfoEventFunction* rief : m_pending_rief)
         delete rief;
     m_pending_rief.clear();
@@ -87,6 +120,7 @@ void RewindManager::reset()
     m_is_rewinding = false;
     m_not_rewound_ticks.store(0);
     m_overall_state_size = 0;
+    m_smoothing_report_ticks = 0;
     m_state_frequency = stk_config->getPhysicsFPS() /
         NetworkConfig::get()->getStateFrequency();
 
@@ -95,6 +129,7 @@ void RewindManager::reset()
     clearExpiredRewinder();
     m_rewind_queue.reset();
     m_missing_rewinders.clear();
+    m_local_state_hash.clear();
 }   // reset
 
 // ----------------------------------------------------------------------------    
@@ -161,7 +196,7 @@ void RewindManager::saveState()
     gp->startNewState();
 
     m_overall_state_size = 0;
-    std::vector<std::string> rewinder_using;
+    std::vector<uint8_t> rewinder_using;
 
     for (auto& p : m_all_rewinder)
     {
@@ -177,7 +212,27 @@ void RewindManager::saveState()
         }
         delete buffer;    // buffer can be freed
     }
-    gp->finalizeState(rewinder_using);
+
+    // Include the unique identity of rewinders added in the last second, and
+    // of all rewinders once per second, so clients which lost some states
+    // (or live joined later) can still map the rewinder ids.
+    const unsigned states_per_second =
+        (unsigned)NetworkConfig::get()->getStateFrequency();
+    const bool send_all_names = m_state_count % states_per_second == 0;
+    std::vector<uint8_t> rewinder_names;
+    for (uint8_t id : rewinder_using)
+    {
+        if (send_all_names ||
+            m_state_count - m_rewinder_id_state[id] < states_per_second)
+            rewinder_names.push_back(id);
+    }
+    m_state_count++;
+    // Computed after all rewinders saved their state, which rounds the
+    // values like clients do
+    const bool has_state_hash = ServerConfig::m_state_hash;
+    gp->finalizeState(rewinder_using, rewinder_names, has_state_hash,
+        has_state_hash ? World::getWorld()->computeStateHash() : 0);
+    m_total_state_size += gp->getState()->getTotalSize();
     PROFILER_POP_CPU_MARKER();
 }   // saveState
 
@@ -190,11 +245,21 @@ void RewindManager::update(int ticks_not_used)
 {
     // FIXME: rename ticks_not_used
     if (!m_enable_rewind_manager ||
-        m_all_rewinder.size() == 0 ||
-        m_is_rewinding)  return;
+        m_all_rewinder.size() == 0)  return;
 
     int ticks = World::getWorld()->getTicksSinceStart();
 
+    // Clients remember the hash of each state tick they simulate (also when
+    // replaying during a rewind), to compare it with the server hash later
+    if (m_check_state_hash && shouldSaveState(ticks) &&
+        NetworkConfig::get()->isClient())
+    {
+        m_local_state_hash[ticks] = World::getWorld()->computeStateHash();
+    }
+
+    if (m_is_rewinding)
+        return;
+
     m_not_rewound_ticks.store(ticks, std::memory_order_relaxed);
 
     if (!shouldSaveState(ticks))
@@ -273,13 +338,91 @@ void RewindManager::playEventsTill(int world_ticks, bool fast_forward)
 bool RewindManager::addRewinder(std::shared_ptr<Rewinder> rewinder)
 {
     if (!m_enable_rewind_manager) return false;
-    // Maximum 1 bit to store no of rewinder used
-    if (m_all_rewinder.size() == 255)
+    const std::string& name = rewinder->getUniqueIdentity();
+    auto it = m_all_rewinder.find(name);
+    std::shared_ptr<Rewinder> previous;
+    if (it != m_all_rewinder.end())
+        previous = it->second.lock();
+    // Maximum 1 byte to store no of rewinder used
+    else if (m_all_rewinder.size() == 255)
         return false;
-    m_all_rewinder[rewinder->getUniqueIdentity()] = rewinder;
+
+    if (NetworkConfig::get()->isServer())
+    {
+        // A re-created rewinder (for example re-firing a flyable during
+        // rewind) keeps the id of the previous one
+        int id = previous ? previous->getRewinderID() : findFreeRewinderID();
+        if (id == -1)
+            return false;
+        m_rewinder_by_id[id] = rewinder;
+        m_rewinder_names[id] = name;
+        m_rewinder_id_state[id] = m_state_count;
+        rewinder->setRewinderID(id);
+    }
+    else if (previous && previous->getRewinderID() != -1)
+    {
+        // Client, make sure the id is resolved to the new rewinder next time
+        m_rewinder_by_id[previous->getRewinderID()].reset();
+    }
+    m_all_rewinder[name] = rewinder;
     return true;
 }   // addRewinder
 
+// ----------------------------------------------------------------------------
+/** Returns a rewinder id which is not used by any alive rewinder, or -1 if
+ *  all ids are in use.
+ */
+int RewindManager::findFreeRewinderID()
+{
+    for (unsigned i = 0; i < 255; i++)
+    {
+        unsigned id = (m_next_rewinder_id + i) % 255;
+        if (m_rewinder_by_id[id].expired())
+        {
+            m_next_rewinder_id = (id + 1) % 255;
+            return (int)id;
+        }
+    }
+    return -1;
+}   // findFreeRewinderID
+
+// ----------------------------------------------------------------------------
+/** Returns the rewinder of the given rewinder id, used when restoring states
+ *  received from the server. The unique identity is only looked up the first
+ *  time, later it's returned directly using the id.
+ *  \param id Rewinder id received in state.
+ */
+std::shared_ptr<Rewinder> RewindManager::getRewinder(uint8_t id)
+{
+    if (auto r = m_rewinder_by_id[id].lock())
+        return r;
+    const std::string& name = m_rewinder_names[id];
+    if (name.empty())
+        return nullptr;
+    std::shared_ptr<Rewinder> r = getRewinder(name);
+    if (r)
+    {
+        m_rewinder_by_id[id] = r;
+        r->setRewinderID(id);
+    }
+    return r;
+}   // getRewinder
+
+// ----------------------------------------------------------------------------
+/** Sets the unique identity of a rewinder id received from the server. If
+ *  the server has re-assigned the id to another rewinder, the previously
+ *  resolved one is discarded.
+ *  \param id Rewinder id received in state.
+ *  \param name Unique identity of the rewinder with this id.
+ */
+void RewindManager::setRewinderName(uint8_t id, const std::string& name)
+{
+    if (m_rewinder_names[id] == name)
+        return;
+    m_rewinder_names[id] = name;
+    m_rewinder_by_id[id].reset();
+}   // setRewinderName
+
 // ----------------------------------------------------------------------------
 /** Rewinds to the specified time, then goes forward till the current
  *  World::getTime() is reached again: it will replay everything before
@@ -353,6 +496,27 @@ void RewindManager::rewindTo(int rewind_ticks, int now_ticks,
             exact_rewind_ticks);
     }
 
+    // Compare the hash of this state as simulated by the client with the
+    // one from the server, a difference shows a misprediction or a desync
+    RewindInfoState* ris = static_cast<RewindInfoState*>(current);
+    if (ris->hasStateHash())
+    {
+        m_check_state_hash = true;
+        auto hash = m_local_state_hash.find(exact_rewind_ticks);
+        if (hash != m_local_state_hash.end())
+        {
+            m_state_hash_checked++;
+            if (hash->second != ris->getStateHash())
+            {
+                m_state_hash_mismatches++;
+                Log::debug("RewindManager", "State hash mismatch at ticks "
+                    "%d.", exact_rewind_ticks);
+            }
+        }
+        m_local_state_hash.erase(m_local_state_hash.begin(),
+            m_local_state_hash.upper_bound(exact_rewind_ticks));
+    }
+
     // A loop in case that we should split states into several smaller ones:
     while (current && current->getTicks() == exact_rewind_ticks && 
            current->isState()                                        )
@@ -402,6 +566,22 @@ void RewindManager::rewindTo(int rewind_ticks, int now_ticks,
             r->computeError();
     }
 
+    // Report the rate of smoothing corrections every 10 seconds
+    const int report_ticks =
+        world->getTicksSinceStart() - m_smoothing_report_ticks;
+    if (report_ticks >= stk_config->time2Ticks(10.0f))
+    {
+        const unsigned applied = SmoothNetworkBody::getCorrectionsApplied();
+        const unsigned skipped = SmoothNetworkBody::getCorrectionsSkipped();
+        const float time = stk_config->ticks2Time(report_ticks);
+        Log::debug("RewindManager", "%.1f smoothing corrections per second, "
+            "%.1f skipped.", applied / time, skipped / time);
+        m_smoothing_applied += applied;
+        m_smoothing_skipped += skipped;
+        SmoothNetworkBody::resetCorrectionCounters();
+        m_smoothing_report_ticks = world->getTicksSinceStart();
+    }
+
     history->setReplayHistory(is_history);
     m_is_rewinding = false;
     mergeRewindInfoEventFunction();
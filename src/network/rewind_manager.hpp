@@ -96,12 +96,56 @@ private:
     /** A list of all objects that can be rewound. */
     std::map<std::string, std::weak_ptr<Rewinder> > m_all_rewinder;
 
+    /** All rewinders indexed by their rewinder id, which is used in state
+     *  packets instead of the unique identity. */
+    std::vector<std::weak_ptr<Rewinder> > m_rewinder_by_id;
+
+    /** The unique identity of each rewinder id. On the server it's set when
+     *  the id is assigned, on clients it's received from the states. */
+    std::vector<std::string> m_rewinder_names;
+
+    /** Server only: the number of states sent when each rewinder id was
+     *  assigned, the unique identity is included in states for one second
+     *  after that. */
+    std::vector<unsigned> m_rewinder_id_state;
+
+    /** Server only: next rewinder id to check for assigning, ids are
+     *  assigned round robin so freed ids are not reused immediately. */
+    unsigned m_next_rewinder_id;
+
+    /** Server only: number of states sent in this race. */
+    unsigned m_state_count;
+
     /** The queue that stores all rewind infos. */
     RewindQueue m_rewind_queue;
 
     /** Overall amount of memory allocated by states. */
     unsigned int m_overall_state_size;
 
+    /** Server only: sum of the sizes of all states sent in this race, used
+     *  to log the average state size. */
+    uint64_t m_total_state_size;
+
+    /** Client only: the hash of the world state of each state tick as
+     *  simulated last by this client, compared with the hash sent by the
+     *  server when the state is restored. */
+    std::map<int, uint64_t> m_local_state_hash;
+
+    /** Client only: true once the server sent a state with a hash. */
+    bool m_check_state_hash;
+
+    /** Client only: number of states whose hash was compared, and how many
+     *  of them didn't match. */
+    unsigned m_state_hash_checked, m_state_hash_mismatches;
+
+    /** Client only: world ticks when the rate of smoothing corrections was
+     *  last reported. */
+    int m_smoothing_report_ticks;
+
+    /** Client only: total number of smoothing corrections applied and
+     *  skipped (because they were too small) in previous reports. */
+    unsigned m_smoothing_applied, m_smoothing_skipped;
+
     /** Indicates if currently a rewind is happening. */
     bool m_is_rewinding;
 
@@ -136,6 +180,8 @@ private:
     }
     // ------------------------------------------------------------------------
     void mergeRewindInfoEventFunction();
+    // ------------------------------------------------------------------------
+    int findFreeRewinderID();
 
 public:
     // First static functions to manage rewinding.
@@ -188,6 +234,15 @@ public:
         return nullptr;
     }
     // ------------------------------------------------------------------------
+    std::shared_ptr<Rewinder> getRewinder(uint8_t id);
+    // ------------------------------------------------------------------------
+    /** Returns the unique identity of the rewinder id, or an empty string if
+     *  it's not known (yet). */
+    const std::string& getRewinderName(uint8_t id) const
+                                             { return m_rewinder_names[id]; }
+    // ------------------------------------------------------------------------
+    void setRewinderName(uint8_t id, const std::string& name);
+    // ------------------------------------------------------------------------
     bool addRewinder(std::shared_ptr<Rewinder> rewinder);
     // ------------------------------------------------------------------------
     /** Returns true if currently a rewind is happening. */
@@ -20,6 +20,7 @@
 #define HEADER_REWINDER_HPP
 
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <memory>
@@ -56,8 +57,18 @@ private:
     */
     std::string m_unique_identity;
 
+    /** Per-race numeric id of this rewinder, assigned by the server in
+     *  RewindManager::addRewinder (and learnt by clients from the states),
+     *  which is sent in state packets instead of the unique identity. -1 if
+     *  not assigned yet. */
+    int m_rewinder_id;
+
 public:
-    Rewinder(const std::string& ui = "")             { m_unique_identity = ui; }
+    Rewinder(const std::string& ui = "")
+    {
+        m_unique_identity = ui;
+        m_rewinder_id = -1;
+    }
 
     virtual ~Rewinder() {}
 
@@ -72,10 +83,10 @@ public:
 
     /** Provides a copy of the state of the object in one memory buffer.
      *  The memory is managed by the RewindManager.
-     *  \param[out] ru The unique identity of rewinder writing to.
+     *  \param[out] ru The rewinder id of rewinder writing to.
      *  \return The address of the memory buffer with the state.
      */
-    virtual BareNetworkString* saveState(std::vector<std::string>* ru) = 0;
+    virtual BareNetworkString* saveState(std::vector<uint8_t>* ru) = 0;
 
     /** Called when an event needs to be undone. This is called while going
      *  backwards for rewinding - all stored events will get an 'undo' call.
@@ -112,6 +123,10 @@ public:
         return m_unique_identity;
     }
     // -------------------------------------------------------------------------
+    void setRewinderID(int id)                        { m_rewinder_id = id; }
+    // -------------------------------------------------------------------------
+    int getRewinderID() const                     { return m_rewinder_id; }
+    // -------------------------------------------------------------------------
     bool rewinderAdd();
     // -------------------------------------------------------------------------
     template<typename T> std::shared_ptr<T> getShared()
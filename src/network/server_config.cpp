@@ -114,6 +114,21 @@ MapServerConfigParam<T, U>::MapServerConfigParam(const char* param_name,
     g_server_params.push_back(this);
 }   // MapServerConfigParam
 
+// ----------------------------------------------------------------------------
+/** The settings which reloadServerConfig changes. They are only read by the
+ *  game thread, which applies the reload, and are not copied when the server
+ *  starts. Others (like the password, game mode or motd) need a restart.
+ */
+static std::vector<UserConfigParam*> getReloadableParams()
+{
+    return { &m_kick_idle_player_seconds, &m_auto_end, &m_state_hash };
+}   // getReloadableParams
+
+// ----------------------------------------------------------------------------
+/** Values of getReloadableParams in the config file. A setting with another
+ *  value was changed on the command line, which stays in effect on reload. */
+static std::vector<std::string> g_reloadable_file_values;
+
 // ============================================================================
 void loadServerConfig(const std::string& path)
 {
@@ -133,6 +148,10 @@ void loadServerConfig(const std::string& path)
         StringUtils::getBasename(g_server_config_path));
     const XMLNode* root = file_manager->createXMLTree(g_server_config_path);
     loadServerConfigXML(root, default_config);
+
+    g_reloadable_file_values.clear();
+    for (UserConfigParam* param : getReloadableParams())
+        g_reloadable_file_values.push_back(param->toString().c_str());
 }   // loadServerConfig
 
 // ----------------------------------------------------------------------------
@@ -167,6 +186,40 @@ void loadServerConfigXML(const XMLNode* root, bool default_config)
     delete root;
 }   // loadServerConfigXML
 
+// ----------------------------------------------------------------------------
+/** Reads the settings of getReloadableParams from the server config file
+ *  used by loadServerConfig again, except the ones set on the command line.
+ *  Unlike loadServerConfigXML an invalid file is not replaced.
+ *  \return False if the file could not be read.
+ */
+bool reloadServerConfig()
+{
+    const XMLNode* root = file_manager->createXMLTree(g_server_config_path);
+    int config_file_version = -1;
+    if (!root || root->getName() != "server-config" ||
+        root->get("version", &config_file_version) < 1 ||
+        config_file_version < stk_config->m_min_server_version ||
+        config_file_version > stk_config->m_max_server_version)
+    {
+        Log::error("ServerConfig", "Could not reload server config file "
+            "'%s'.", g_server_config_path.c_str());
+        delete root;
+        return false;
+    }
+
+    std::vector<UserConfigParam*> params = getReloadableParams();
+    for (unsigned i = 0; i < params.size(); i++)
+    {
+        if (g_reloadable_file_values[i] != params[i]->toString().c_str())
+            continue;
+        params[i]->findYourDataInAChildOf(root);
+        g_reloadable_file_values[i] = params[i]->toString().c_str();
+    }
+
+    delete root;
+    return true;
+}   // reloadServerConfig
+
 // ----------------------------------------------------------------------------
 std::string getServerConfigXML()
 {
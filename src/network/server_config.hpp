@@ -129,6 +129,12 @@ namespace ServerConfig
         SERVER_CFG_DEFAULT(BoolServerConfigParam(false, "enable-console",
         "Enable network console, which can do for example kickban."));
 
+    SERVER_CFG_PREFIX StringServerConfigParam m_control_socket
+        SERVER_CFG_DEFAULT(StringServerConfigParam("", "control-socket",
+        "Path of a Unix domain socket on which local tools can run the "
+        "network console commands (like status, kickban or reloadconfig), "
+        "one command per line. Empty to disable, not supported on Windows."));
+
     SERVER_CFG_PREFIX IntServerConfigParam m_server_max_players
         SERVER_CFG_DEFAULT(IntServerConfigParam(8, "server-max-players",
         "Maximum number of players on the server, setting this to a value "
@@ -357,6 +363,18 @@ namespace ServerConfig
         "more rewind, which clients with slow device may have problem playing "
         "this server, use the default value is recommended."));
 
+    SERVER_CFG_PREFIX BoolServerConfigParam m_state_hash
+        SERVER_CFG_DEFAULT(BoolServerConfigParam(false, "state-hash",
+        "Include a hash of the world state in each state sent to clients "
+        "(8 bytes more per state), so clients can detect when their "
+        "simulation diverges from the server."));
+
+    SERVER_CFG_PREFIX BoolServerConfigParam m_keep_track_loaded
+        SERVER_CFG_DEFAULT(BoolServerConfigParam(false, "keep-track-loaded",
+        "Keep the models of the last played track in memory after a race, so "
+        "the next race on the same track starts faster. This uses more "
+        "memory, because the models are kept with their vertices."));
+
     SERVER_CFG_PREFIX BoolServerConfigParam m_sql_management
         SERVER_CFG_DEFAULT(BoolServerConfigParam(false,
         "sql-management",
@@ -451,7 +469,7 @@ namespace ServerConfig
 
     // ========================================================================
     /** Server version, will be advanced if there are protocol changes. */
-    static const uint32_t m_server_version = 6;
+    static const uint32_t m_server_version = 9;
     // ========================================================================
     /** Server database version, will be advanced if there are protocol
      *  changes. */
@@ -464,6 +482,8 @@ namespace ServerConfig
     // ------------------------------------------------------------------------
     void loadServerConfigXML(const XMLNode* root, bool default_config = false);
     // ------------------------------------------------------------------------
+    bool reloadServerConfig();
+    // ------------------------------------------------------------------------
     std::string getServerConfigXML();
     // ------------------------------------------------------------------------
     void writeServerConfigToDisk();
@@ -21,6 +21,9 @@
 
 #include <algorithm>
 
+unsigned int SmoothNetworkBody::m_corrections_applied = 0;
+unsigned int SmoothNetworkBody::m_corrections_skipped = 0;
+
 // ----------------------------------------------------------------------------
 SmoothNetworkBody::SmoothNetworkBody(bool enable)
 {
@@ -62,17 +65,26 @@ void SmoothNetworkBody::checkSmoothing(const btTransform& current_transform,
     //if (m_smoothing != SS_NONE)
     //    return;
 
-    float adjust_length = (current_transform.getOrigin() -
-        m_prev_position_data.first.getOrigin()).length();
-    if (adjust_length < m_min_adjust_length ||
-        adjust_length > m_max_adjust_length)
+    // This is called for every body after each rewind, and most errors are
+    // negligible, so compare squared values first to avoid the square roots
+    float adjust_length2 = (current_transform.getOrigin() -
+        m_prev_position_data.first.getOrigin()).length2();
+    if (adjust_length2 < m_min_adjust_length * m_min_adjust_length)
+    {
+        m_corrections_skipped++;
+        return;
+    }
+    if (adjust_length2 > m_max_adjust_length * m_max_adjust_length)
         return;
 
-    float speed = m_prev_position_data.second.length();
-    speed = std::max(speed, current_velocity.length());
-    if (speed < m_min_adjust_speed)
+    float speed2 = std::max(m_prev_position_data.second.length2(),
+        current_velocity.length2());
+    if (speed2 < m_min_adjust_speed * m_min_adjust_speed)
         return;
 
+    float adjust_length = sqrtf(adjust_length2);
+    float speed = sqrtf(speed2);
+
     float adjust_time = (adjust_length * m_adjust_length_threshold) / speed;
     if (adjust_time > m_max_adjust_time)
         return;
@@ -96,6 +108,7 @@ void SmoothNetworkBody::checkSmoothing(const btTransform& current_transform,
     m_adjust_position.first.setInterpolate3(m_adjust_control_point, p2, 0.5f);
     m_adjust_position.second = current_transform.getRotation();
     m_adjust_position.second.normalize();
+    m_corrections_applied++;
 #endif
 }   // checkSmoothing
 
@@ -105,37 +118,34 @@ void SmoothNetworkBody::updateSmoothedGraphics(
     float dt)
 {
 #ifndef SERVER_ONLY
-    Vec3 cur_xyz = current_transform.getOrigin();
-    btQuaternion cur_rot = current_transform.getRotation();
-
-    if (!m_enabled)
+    // Most bodies are not being smoothed, in which case the transform can be
+    // copied without converting the rotation to a quaternion and back
+    if (!m_enabled || m_smoothing == SS_NONE)
     {
-        m_smoothed_transform.setOrigin(cur_xyz);
-        m_smoothed_transform.setRotation(cur_rot);
+        m_smoothed_transform = current_transform;
         return;
     }
 
-    float ratio = 0.0f;
-    if (m_smoothing != SS_NONE)
+    Vec3 cur_xyz = current_transform.getOrigin();
+    btQuaternion cur_rot = current_transform.getRotation();
+
+    float adjust_time_dt = m_adjust_time_dt + dt;
+    float ratio = adjust_time_dt / m_adjust_time;
+    if (ratio > 1.0f)
     {
-        float adjust_time_dt = m_adjust_time_dt + dt;
-        ratio = adjust_time_dt / m_adjust_time;
-        if (ratio > 1.0f)
+        ratio -= 1.0f;
+        m_adjust_time_dt = adjust_time_dt - m_adjust_time;
+        if (m_smoothing == SS_TO_ADJUST)
         {
-            ratio -= 1.0f;
-            m_adjust_time_dt = adjust_time_dt - m_adjust_time;
-            if (m_smoothing == SS_TO_ADJUST)
-            {
-                m_smoothing = SS_TO_REAL;
-                m_adjust_control_point = m_adjust_position.first +
-                    current_velocity * m_adjust_time;
-            }
-            else
-                m_smoothing = SS_NONE;
+            m_smoothing = SS_TO_REAL;
+            m_adjust_control_point = m_adjust_position.first +
+                current_velocity * m_adjust_time;
         }
         else
-            m_adjust_time_dt = adjust_time_dt;
+            m_smoothing = SS_NONE;
     }
+    else
+        m_adjust_time_dt = adjust_time_dt;
 
     assert(m_adjust_time_dt >= 0.0f);
     assert(ratio >= 0.0f);
@@ -70,6 +70,14 @@ private:
     float m_min_adjust_length, m_max_adjust_length, m_min_adjust_speed,
         m_max_adjust_time, m_adjust_length_threshold;
 
+    /** Number of corrections which started a smoothing since the last call
+     *  of resetCorrectionCounters(). */
+    static unsigned int m_corrections_applied;
+
+    /** Number of corrections which were ignored because the error was below
+     *  m_min_adjust_length. */
+    static unsigned int m_corrections_skipped;
+
 public:
     SmoothNetworkBody(bool enable = false);
     // ------------------------------------------------------------------------
@@ -123,6 +131,15 @@ public:
     // ------------------------------------------------------------------------
     void setAdjustLengthThreshold(float val)
                                            { m_adjust_length_threshold = val; }
+    // ------------------------------------------------------------------------
+    static unsigned int getCorrectionsApplied()
+                                                { return m_corrections_applied; }
+    // ------------------------------------------------------------------------
+    static unsigned int getCorrectionsSkipped()
+                                                { return m_corrections_skipped; }
+    // ------------------------------------------------------------------------
+    static void resetCorrectionCounters()
+                          { m_corrections_applied = m_corrections_skipped = 0; }
 
 };
 
@@ -0,0 +1,84 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2026 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_STATE_HASH_HPP
+#define HEADER_STATE_HASH_HPP
+
+#include "mini_glm.hpp"
+
+#include "btBulletDynamicsCommon.h"
+
+#include <cstdint>
+#include <cstring>
+
+/** \ingroup network
+ *  A 64-bit FNV-1a hash of (authoritative) world state, used to detect
+ *  desynchronisation between server and clients, and non-determinism when
+ *  replaying a history. Floating point values are hashed bitwise, so only
+ *  values which are expected to be exactly identical must be added.
+ */
+class StateHash
+{
+private:
+    uint64_t m_hash;
+
+public:
+    // ------------------------------------------------------------------------
+    StateHash()                       { m_hash = 14695981039346656037ULL; }
+    // ------------------------------------------------------------------------
+    StateHash& add(const void* data, size_t size)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            m_hash ^= p[i];
+            m_hash *= 1099511628211ULL;
+        }
+        return *this;
+    }   // add
+    // ------------------------------------------------------------------------
+    StateHash& addUInt32(uint32_t v)           { return add(&v, sizeof(v)); }
+    // ------------------------------------------------------------------------
+    StateHash& addInt(int v)                   { return add(&v, sizeof(v)); }
+    // ------------------------------------------------------------------------
+    StateHash& addFloat(float f)               { return add(&f, sizeof(f)); }
+    // ------------------------------------------------------------------------
+    /** Adds the transform and velocities of a physical body, using the same
+     *  precision as CompressNetworkBody, so a client which rounds the values
+     *  locally gets the same hash as the server which sends them. */
+    StateHash& addBody(const btRigidBody* body)
+    {
+        const btTransform& t = body->getWorldTransform();
+        addFloat(t.getOrigin().x()).addFloat(t.getOrigin().y())
+            .addFloat(t.getOrigin().z());
+        addUInt32(MiniGLM::compressQuaternion(t.getRotation()));
+        const btVector3& lv = body->getLinearVelocity();
+        const btVector3& av = body->getAngularVelocity();
+        short v[6] =
+        {
+            MiniGLM::toFloat16(lv.x()), MiniGLM::toFloat16(lv.y()),
+            MiniGLM::toFloat16(lv.z()), MiniGLM::toFloat16(av.x()),
+            MiniGLM::toFloat16(av.y()), MiniGLM::toFloat16(av.z())
+        };
+        return add(v, sizeof(v));
+    }   // addBody
+    // ------------------------------------------------------------------------
+    uint64_t get() const                                    { return m_hash; }
+};   // class StateHash
+
+#endif
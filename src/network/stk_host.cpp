@@ -48,7 +48,10 @@
 #else
 #  include <arpa/inet.h>
 #  include <errno.h>
+#  include <fcntl.h>
+#  include <poll.h>
 #  include <sys/socket.h>
+#  include <unistd.h>
 #endif
 
 #ifdef __MINGW32__
@@ -321,6 +324,20 @@ void STKHost::init()
     m_network          = NULL;
     m_exit_timeout.store(std::numeric_limits<uint64_t>::max());
     m_client_ping.store(0);
+    memset(m_enet_cmd_latency, 0, sizeof(m_enet_cmd_latency));
+#ifndef WIN32
+    if (pipe(m_wakeup_pipe) == 0)
+    {
+        fcntl(m_wakeup_pipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(m_wakeup_pipe[1], F_SETFL, O_NONBLOCK);
+    }
+    else
+    {
+        Log::warn("STKHost", "Cannot create wake up pipe, packets will be "
+            "sent with a delay.");
+        m_wakeup_pipe[0] = m_wakeup_pipe[1] = -1;
+    }
+#endif
 
     // Start with initialising ENet
     // ============================
@@ -340,6 +357,13 @@ void STKHost::init()
         m_network_console = std::thread(std::bind(&NetworkConsole::mainLoop,
             this));
     }
+    // Optional: start the control socket for local server tools
+    const std::string control_socket = ServerConfig::m_control_socket;
+    if (NetworkConfig::get()->isServer() && !control_socket.empty())
+    {
+        m_control_socket = std::thread(std::bind(
+            &NetworkConsole::controlSocketLoop, this, control_socket));
+    }
 }  // STKHost
 
 // ----------------------------------------------------------------------------
@@ -357,6 +381,8 @@ STKHost::~STKHost()
     requestShutdown();
     if (m_network_console.joinable())
         m_network_console.join();
+    if (m_control_socket.joinable())
+        m_control_socket.join();
 
     disconnectAllPeers(true/*timeout_waiting*/);
     Network::closeLog();
@@ -373,6 +399,13 @@ STKHost::~STKHost()
     }
     delete m_network;
     enet_deinitialize();
+#ifndef WIN32
+    if (m_wakeup_pipe[0] != -1)
+    {
+        close(m_wakeup_pipe[0]);
+        close(m_wakeup_pipe[1]);
+    }
+#endif
     if (m_client_loop)
     {
         m_client_loop_thread.join();
@@ -380,6 +413,30 @@ STKHost::~STKHost()
     }
 }   // ~STKHost
 
+//-----------------------------------------------------------------------------
+/** Adds a command (like sending a packet) to be executed by enet in the
+ *  listening thread, and wakes up the listening thread if it is waiting for
+ *  network packets.
+ */
+void STKHost::addEnetCommand(ENetPeer* peer, ENetPacket* packet, uint32_t i,
+                             ENetCommandType ect, ENetAddress ea)
+{
+    std::lock_guard<std::mutex> lock(m_enet_cmd_mutex);
+    m_enet_cmd.emplace_back(peer, packet, i, ect, ea);
+    if (m_enet_cmd.size() != 1)
+        return;
+    m_enet_cmd_time = std::chrono::steady_clock::now();
+#ifndef WIN32
+    // Only the first command needs to wake up the listening thread, it
+    // takes all commands at once
+    if (m_wakeup_pipe[1] != -1)
+    {
+        char c = 0;
+        if (write(m_wakeup_pipe[1], &c, 1) < 0) {}
+    }
+#endif
+}   // addEnetCommand
+
 //-----------------------------------------------------------------------------
 /** Called from the main thread when the network infrastructure is to be shut
  *  down.
@@ -823,6 +880,7 @@ void STKHost::mainLoop(ProcessType pt)
     uint64_t last_ping_time = StkTime::getMonoTimeMs();
     uint64_t last_update_speed_time = StkTime::getMonoTimeMs();
     uint64_t last_ping_time_update_for_client = StkTime::getMonoTimeMs();
+    uint64_t last_latency_log_time = StkTime::getMonoTimeMs() + 10000;
     std::map<std::string, uint64_t> ctp;
     while (m_exit_timeout.load() > StkTime::getMonoTimeMs())
     {
@@ -998,7 +1056,22 @@ void STKHost::mainLoop(ProcessType pt)
             ENetCommandType, ENetAddress> > copied_list;
         std::unique_lock<std::mutex> lock(m_enet_cmd_mutex);
         std::swap(copied_list, m_enet_cmd);
+        const std::chrono::steady_clock::time_point cmd_time =
+            m_enet_cmd_time;
         lock.unlock();
+        if (!copied_list.empty())
+        {
+            const int64_t us =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - cmd_time).count();
+            m_enet_cmd_latency[us < 100 ? 0 : us < 1000 ? 1 :
+                us < 5000 ? 2 : us < 10000 ? 3 : 4]++;
+        }
+        if (last_latency_log_time < StkTime::getMonoTimeMs())
+        {
+            last_latency_log_time = StkTime::getMonoTimeMs() + 10000;
+            logEnetCommandLatency();
+        }
         for (auto& p : copied_list)
         {
             ENetPeer* peer = std::get<0>(p);
@@ -1048,7 +1121,7 @@ void STKHost::mainLoop(ProcessType pt)
         }
 
         bool need_ping_update = false;
-        while (enet_host_service(host, &event, 10) != 0)
+        while (serviceHost(host, &event) != 0)
         {
             auto lp = LobbyProtocol::get<LobbyProtocol>();
             if (!is_server &&
@@ -1217,12 +1290,77 @@ void STKHost::mainLoop(ProcessType pt)
                 pm->propagateEvent(stk_event);
             else
                 delete stk_event;
-        }   // while enet_host_service
+        }   // while serviceHost
     }   // while m_exit_timeout.load() > StkTime::getMonoTimeMs()
+    logEnetCommandLatency();
     delete direct_socket;
     Log::info("STKHost", "Listening has been stopped.");
 }   // mainLoop
 
+// ----------------------------------------------------------------------------
+/** Works like enet_host_service with a timeout of 10ms, but also returns 0
+ *  as soon as a command is added with addEnetCommand, so that packets are
+ *  sent without waiting for the timeout.
+ *  \return 1 if an event was received, 0 if none, negative on error.
+ */
+int STKHost::serviceHost(ENetHost* host, ENetEvent* event)
+{
+#ifdef WIN32
+    return enet_host_service(host, event, 10);
+#else
+    if (m_wakeup_pipe[0] == -1)
+        return enet_host_service(host, event, 10);
+
+    const uint64_t timeout = StkTime::getMonoTimeMs() + 10;
+    while (true)
+    {
+        int ret = enet_host_service(host, event, 0);
+        if (ret != 0)
+            return ret;
+
+        const uint64_t now = StkTime::getMonoTimeMs();
+        if (now >= timeout)
+            return 0;
+        struct pollfd fds[2];
+        fds[0].fd = host->socket;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = m_wakeup_pipe[0];
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+        ret = poll(fds, 2, (int)(timeout - now));
+        if (ret < 0 && errno != EINTR)
+            return ret;
+        if (ret <= 0)
+            continue;
+        if (fds[1].revents != 0)
+        {
+            char buf[64];
+            while (read(m_wakeup_pipe[0], buf, sizeof(buf)) > 0) {}
+            return 0;
+        }
+    }
+#endif
+}   // serviceHost
+
+// ----------------------------------------------------------------------------
+/** Logs how long commands (like sending packets) waited for the listening
+ *  thread, and resets the counts.
+ */
+void STKHost::logEnetCommandLatency()
+{
+    uint32_t total = 0;
+    for (uint32_t n : m_enet_cmd_latency)
+        total += n;
+    if (total == 0)
+        return;
+    Log::debug("STKHost", "Network command latency: %u below 0.1ms, %u below "
+        "1ms, %u below 5ms, %u below 10ms, %u longer.",
+        m_enet_cmd_latency[0], m_enet_cmd_latency[1], m_enet_cmd_latency[2],
+        m_enet_cmd_latency[3], m_enet_cmd_latency[4]);
+    memset(m_enet_cmd_latency, 0, sizeof(m_enet_cmd_latency));
+}   // logEnetCommandLatency
+
 // ----------------------------------------------------------------------------
 /** Handles a direct request given to a socket. This is typically a LAN 
  *  request, but can also be used if the server is public (i.e. not behind
@@ -36,6 +36,7 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <list>
 #include <functional>
@@ -86,6 +87,9 @@ private:
     /** Network console thread */
     std::thread m_network_console;
 
+    /** Control socket thread, see NetworkConsole::controlSocketLoop. */
+    std::thread m_control_socket;
+
     /** Make sure the removing or adding a peer is thread-safe. */
     mutable std::mutex m_peers_mutex;
 
@@ -98,6 +102,21 @@ private:
     /** Protect \ref m_enet_cmd from multiple threads usage. */
     std::mutex m_enet_cmd_mutex;
 
+    /** When the first command was added to an empty \ref m_enet_cmd, to
+     *  measure how long commands wait for the listening thread. */
+    std::chrono::steady_clock::time_point m_enet_cmd_time;
+
+    /** Number of command lists processed by the listening thread, counted
+     *  by the time they waited: below 0.1ms, 1ms, 5ms, 10ms and longer. */
+    uint32_t m_enet_cmd_latency[5];
+
+#ifndef WIN32
+    /** A pipe written to when a command is added to an empty
+     *  \ref m_enet_cmd, so that the listening thread waiting for packets
+     *  wakes up and sends it immediately. */
+    int m_wakeup_pipe[2];
+#endif
+
     /** The list of peers connected to this instance. */
     std::map<ENetPeer*, std::shared_ptr<STKPeer> > m_peers;
 
@@ -170,6 +189,10 @@ private:
     // ------------------------------------------------------------------------
     void mainLoop(ProcessType pt);
     // ------------------------------------------------------------------------
+    int serviceHost(ENetHost* host, ENetEvent* event);
+    // ------------------------------------------------------------------------
+    void logEnetCommandLatency();
+    // ------------------------------------------------------------------------
     void getIPFromStun(int socket, const std::string& stun_address,
                        short family, SocketAddress* result);
 public:
@@ -287,11 +310,7 @@ public:
     void setErrorMessage(const irr::core::stringw &message);
     // ------------------------------------------------------------------------
     void addEnetCommand(ENetPeer* peer, ENetPacket* packet, uint32_t i,
-                        ENetCommandType ect, ENetAddress ea)
-    {
-        std::lock_guard<std::mutex> lock(m_enet_cmd_mutex);
-        m_enet_cmd.emplace_back(peer, packet, i, ect, ea);
-    }
+                        ENetCommandType ect, ENetAddress ea);
     // ------------------------------------------------------------------------
     /** Returns the last error (or "" if no error has happened). */
     const irr::core::stringw& getErrorMessage() const
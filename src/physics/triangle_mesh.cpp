@@ -19,15 +19,45 @@
 #include "physics/triangle_mesh.hpp"
 
 #include "config/stk_config.hpp"
+#include "io/file_manager.hpp"
 #include "main_loop.hpp"
+#include "network/state_hash.hpp"
 #include "physics/physics.hpp"
 #include "utils/constants.hpp"
+#include "utils/file_utils.hpp"
 #include "utils/log.hpp"
+#include "utils/string_utils.hpp"
 #include "utils/time.hpp"
 
 #include "btBulletDynamicsCommon.h"
 
+#include <assert.h>
+#include <chrono>
 #include <fstream>
+#include <set>
+
+#ifndef WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace
+{
+    /** Header of a BVH cache file, it is followed by the serialized BVH at
+     *  offset BVH_CACHE_DATA_OFFSET (which keeps the 16 byte alignment
+     *  needed by bullet). */
+    struct BvhCacheHeader
+    {
+        char     m_magic[8];
+        uint64_t m_mesh_hash;
+        uint32_t m_triangle_count;
+        uint32_t m_bvh_size;
+    };
+    const char BVH_CACHE_MAGIC[8] = { 'S', 'T', 'K', 'B', 'V', 'H', '0', '1' };
+    const size_t BVH_CACHE_DATA_OFFSET = 32;
+}   // anonymous namespace
 
 // -----------------------------------------------------------------------------
 /** Constructor: Initialises all data structures with zero.
@@ -45,6 +75,9 @@ TriangleMesh::TriangleMesh(bool can_be_transformed) : m_mesh()
     // (and m_mesh->m_weldingThreshold at m_normals
     m_collision_shape  = NULL;
     m_collision_object = NULL;
+    m_bvh_memory        = NULL;
+    m_bvh_memory_size   = 0;
+    m_bvh_memory_mapped = false;
     m_user_pointer.set(this);
 }   // TriangleMesh
 
@@ -87,13 +120,177 @@ void TriangleMesh::addTriangle(const btVector3 &t1, const btVector3 &t2,
     m_p1p2p3.push_back(edge1.cross(edge2).length2());
 }   // addTriangle
 
+// -----------------------------------------------------------------------------
+/** Computes a hash of the triangles of this mesh (and of the layout of the
+ *  bullet data structures), which identifies the mesh a cached BVH was
+ *  built for.
+ */
+uint64_t TriangleMesh::computeMeshHash() const
+{
+    StateHash hash;
+    hash.addUInt32((uint32_t)sizeof(btQuantizedBvh))
+        .addUInt32((uint32_t)sizeof(btOptimizedBvhNode))
+        .addUInt32((uint32_t)sizeof(void*));
+    const IndexedMeshArray &m = m_mesh.getIndexedMeshArray();
+    if (m.size() > 0)
+    {
+        hash.addInt(m[0].m_numVertices);
+        hash.add(m[0].m_vertexBase,
+                 (size_t)m[0].m_numVertices * m[0].m_vertexStride);
+    }
+    return hash.get();
+}   // computeMeshHash
+
+// -----------------------------------------------------------------------------
+/** Loads a BVH saved by saveBvhCache. On most platforms the file is memory
+ *  mapped copy-on-write: bullet only writes to the header of the BVH when
+ *  deserializing it in place, so the nodes stay in the page cache and are
+ *  shared by all processes (e.g. several servers) using the same track.
+ *  \param file Name of the cache file.
+ *  \param hash Hash of this mesh, see computeMeshHash.
+ *  \return The BVH, or NULL if the file does not exist or does not match.
+ */
+btOptimizedBvh* TriangleMesh::loadBvhCache(const std::string &file,
+                                           uint64_t hash)
+{
+    size_t size = 0;
+#ifdef WIN32
+    FILE *f = FileUtils::fopenU8Path(file, "rb");
+    if (!f)
+        return NULL;
+    fseek(f, 0, SEEK_END);
+    long pos = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (pos <= (long)BVH_CACHE_DATA_OFFSET)
+    {
+        fclose(f);
+        return NULL;
+    }
+    size = (size_t)pos;
+    m_bvh_memory = btAlignedAlloc(size, 16);
+    m_bvh_memory_size = size;
+    m_bvh_memory_mapped = false;
+    bool read_ok = fread(m_bvh_memory, size, 1, f) == 1;
+    fclose(f);
+    if (!read_ok)
+    {
+        freeBvhMemory();
+        return NULL;
+    }
+#else
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd == -1)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= (off_t)BVH_CACHE_DATA_OFFSET)
+    {
+        close(fd);
+        return NULL;
+    }
+    size = (size_t)st.st_size;
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                        fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+        return NULL;
+    m_bvh_memory = memory;
+    m_bvh_memory_size = size;
+    m_bvh_memory_mapped = true;
+#endif
+
+    BvhCacheHeader header;
+    memcpy(&header, m_bvh_memory, sizeof(header));
+    if (memcmp(header.m_magic, BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC)) != 0 ||
+        header.m_mesh_hash != hash ||
+        header.m_triangle_count != m_triangleIndex2Material.size() ||
+        header.m_bvh_size > size - BVH_CACHE_DATA_OFFSET)
+    {
+        freeBvhMemory();
+        return NULL;
+    }
+
+    btOptimizedBvh *bvh = btOptimizedBvh::deSerializeInPlace(
+        (char*)m_bvh_memory + BVH_CACHE_DATA_OFFSET, header.m_bvh_size,
+        !IS_LITTLE_ENDIAN);
+    if (!bvh)
+        freeBvhMemory();
+    return bvh;
+}   // loadBvhCache
+
+// -----------------------------------------------------------------------------
+/** Saves the BVH of this mesh so that it can be loaded by loadBvhCache.
+ *  The file is written under a temporary name and then renamed, so
+ *  processes which load the same track at the same time never see a
+ *  partially written cache.
+ *  \param file Name of the cache file.
+ *  \param hash Hash of this mesh, see computeMeshHash.
+ *  \param bvh The BVH to save.
+ */
+void TriangleMesh::saveBvhCache(const std::string &file, uint64_t hash,
+                                const btOptimizedBvh *bvh) const
+{
+    unsigned int bvh_size = bvh->calculateSerializeBufferSize();
+    char *buffer = (char*)btAlignedAlloc(bvh_size, 16);
+    if (!bvh->serializeInPlace(buffer, bvh_size, !IS_LITTLE_ENDIAN))
+    {
+        btAlignedFree(buffer);
+        return;
+    }
+
+    BvhCacheHeader header;
+    memcpy(header.m_magic, BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC));
+    header.m_mesh_hash      = hash;
+    header.m_triangle_count = (uint32_t)m_triangleIndex2Material.size();
+    header.m_bvh_size       = bvh_size;
+
+    const std::string tmp = file + "." + StringUtils::toString(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+    FILE *f = FileUtils::fopenU8Path(tmp, "wb");
+    if (!f)
+    {
+        btAlignedFree(buffer);
+        return;
+    }
+    char padding[BVH_CACHE_DATA_OFFSET] = {};
+    bool write_ok =
+        fwrite(&header, sizeof(header), 1, f) == 1 &&
+        fwrite(padding, BVH_CACHE_DATA_OFFSET - sizeof(header), 1, f) == 1 &&
+        fwrite(buffer, bvh_size, 1, f) == 1;
+    write_ok = fclose(f) == 0 && write_ok;
+    btAlignedFree(buffer);
+
+    // Another process might have written the same cache in the meantime
+    if (!write_ok || FileUtils::renameU8Path(tmp, file) != 0)
+        file_manager->removeFile(tmp);
+}   // saveBvhCache
+
+// -----------------------------------------------------------------------------
+/** Frees the memory of a BVH loaded by loadBvhCache.
+ */
+void TriangleMesh::freeBvhMemory()
+{
+    if (!m_bvh_memory)
+        return;
+#ifndef WIN32
+    if (m_bvh_memory_mapped)
+        munmap(m_bvh_memory, m_bvh_memory_size);
+    else
+#endif
+        btAlignedFree(m_bvh_memory);
+    m_bvh_memory        = NULL;
+    m_bvh_memory_size   = 0;
+    m_bvh_memory_mapped = false;
+}   // freeBvhMemory
+
 // -----------------------------------------------------------------------------
 /** Creates a collision body only, which can be used for raycasting, but
  *  has no physical properties.
- *  @param serialized_bhv if non-null, load the serialized bhv from file instead
- *                        of builing it on the fly
+ *  \param bvh_cache_file If not NULL, the BVH of the mesh is loaded from
+ *         this file if it was saved there for identical triangles before,
+ *         otherwise the BVH is built and saved to the file.
  */
-void TriangleMesh::createCollisionShape(bool create_collision_object, const char* serialized_bhv)
+void TriangleMesh::createCollisionShape(bool create_collision_object,
+                                        const char* bvh_cache_file)
 {
     if(m_triangleIndex2Material.size()==0)
     {
@@ -106,53 +303,29 @@ void TriangleMesh::createCollisionShape(bool create_collision_object, const char
     // Now convert the triangle mesh into a static rigid body
     btBvhTriangleMeshShape* bhv_triangle_mesh;
 
-    if (serialized_bhv != NULL)
+    btOptimizedBvh *bvh = NULL;
+    uint64_t hash = 0;
+    if (bvh_cache_file != NULL)
     {
-        FILE *f = fopen(serialized_bhv, "rb");
-        fseek(f, 0, SEEK_END);
-        long pos = ftell(f);
-        assert(pos != -1L);
-        fseek(f, 0, SEEK_SET);
-
-        void* bytes = btAlignedAlloc(pos, 16);
-        fread(bytes, pos, 1, f);
-        fclose(f);
-
-        btOptimizedBvh* bhv = btOptimizedBvh::deSerializeInPlace(bytes, pos, !IS_LITTLE_ENDIAN);
-        if (bhv == NULL)
-        {
-            Log::warn("TriangleMesh", "Failed to load serialized BHV");
-            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */);
-        }
-        else
-        {
-            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */,
-                                                           false /* buildBvh */);
-            bhv_triangle_mesh->setOptimizedBvh( bhv );
-        }
-        // Do *NOT* free the bytes, 'deSerializeInPlace' makes the btOptimizedBvh object
-        // directly at this memory location
-        //free(bytes);
+        hash = computeMeshHash();
+        bvh = loadBvhCache(bvh_cache_file, hash);
+    }
 
+    if (bvh != NULL)
+    {
+        bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh,
+            false /* useQuantizedAabbCompression */, false /* buildBvh */);
+        bhv_triangle_mesh->setOptimizedBvh(bvh);
     }
     else
     {
-        bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */);
-
-        /*
-         // code to serialize triangle mesh
-        btOptimizedBvh* bvh = bhv_triangle_mesh->getOptimizedBvh();
-        unsigned int ssize = bvh->calculateSerializeBufferSize();
-        char* buffer = (char*)btAlignedAlloc(ssize, 16);
-        bool success = bvh->serialize(buffer, ssize, !IS_LITTLE_ENDIAN);
-        printf("serialization success = %i\n", success);
-
-        std::ofstream fileout("/tmp/btOptimizedBvh");
-        fileout.write(buffer, ssize);
-        fileout.close();
-
-        btAlignedFree(buffer);
-         */
+        bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh,
+            false /* useQuantizedAabbCompression */);
+        if (bvh_cache_file != NULL)
+        {
+            saveBvhCache(bvh_cache_file, hash,
+                         bhv_triangle_mesh->getOptimizedBvh());
+        }
     }
 
     m_collision_shape = bhv_triangle_mesh;
@@ -179,16 +352,16 @@ void TriangleMesh::createCollisionShape(bool create_collision_object, const char
  *  for height of terrain detection).
  *  \param friction Friction to be used for this TriangleMesh.
  *  \param flags Additional collision flags (default 0).
- *  \param serializedBhv if non-NULL, the bhv is deserialized instead of
- *                       being calculated on the fly
+ *  \param bvh_cache_file If not NULL, file to load the BVH from or save it
+ *         to, see createCollisionShape.
  */
 void TriangleMesh::createPhysicalBody(float friction,
                                       btCollisionObject::CollisionFlags flags,
-                                      const char* serializedBhv)
+                                      const char* bvh_cache_file)
 {
     // We need the collision shape, but not the collision object (since
     // this will be created when the dynamics body is anyway).
-    createCollisionShape(/*create_collision_object*/false, serializedBhv);
+    createCollisionShape(/*create_collision_object*/false, bvh_cache_file);
     main_loop->renderGUI(5583);
 
     btTransform startTransform;
@@ -233,6 +406,15 @@ void TriangleMesh::removeAll()
     }
     delete m_collision_shape;
     m_collision_shape = NULL;
+    // The shape does not own a BVH loaded from a cache file, which was
+    // constructed in place in m_bvh_memory
+    if (m_bvh_memory)
+    {
+        btOptimizedBvh *bvh = (btOptimizedBvh*)
+            ((char*)m_bvh_memory + BVH_CACHE_DATA_OFFSET);
+        bvh->~btOptimizedBvh();
+        freeBvhMemory();
+    }
 }   // removeAll
 
 // -----------------------------------------------------------------------------
@@ -408,3 +590,97 @@ bool TriangleMesh::castRay(const btVector3 &from, const btVector3 &to,
     return ray_callback.hasHit();
 
 }   // castRay
+
+// ----------------------------------------------------------------------------
+/** Tests that a BVH saved to a cache file is loaded again for the same
+ *  triangles, gives the same raycast results as the BVH built by bullet,
+ *  and is rejected for different triangles or a damaged file.
+ */
+void TriangleMesh::unitTesting()
+{
+    // Creates a bumpy grid of n*n quads
+    auto create_mesh = [](int n, float bump)
+    {
+        TriangleMesh *tm = new TriangleMesh(/*can_be_transformed*/false);
+        const btVector3 up(0, 1, 0);
+        for (int x = 0; x < n; x++)
+        {
+            for (int z = 0; z < n; z++)
+            {
+                btVector3 p[4];
+                for (int i = 0; i < 4; i++)
+                {
+                    const int px = x + (i & 1), pz = z + (i >> 1);
+                    p[i] = btVector3((float)px, bump * ((px * pz) % 3),
+                                     (float)pz);
+                }
+                tm->addTriangle(p[0], p[1], p[2], up, up, up, NULL);
+                tm->addTriangle(p[1], p[3], p[2], up, up, up, NULL);
+            }
+        }
+        return tm;
+    };
+    // Returns the indices of all triangles hit by some vertical rays
+    struct HitCallback : public btTriangleCallback
+    {
+        std::set<int> m_hits;
+        virtual void processTriangle(btVector3 *triangle, int part_id,
+                                     int triangle_index)
+        {
+            m_hits.insert(triangle_index);
+        }
+    };
+    auto cast_rays = [](TriangleMesh *tm)
+    {
+        HitCallback callback;
+        btBvhTriangleMeshShape *shape =
+            (btBvhTriangleMeshShape*)tm->m_collision_shape;
+        for (float x = 0.25f; x < 20.0f; x += 1.5f)
+        {
+            for (float z = 0.5f; z < 20.0f; z += 1.25f)
+            {
+                shape->performRaycast(&callback, btVector3(x, 10.0f, z),
+                                      btVector3(x, -10.0f, z));
+            }
+        }
+        return callback.m_hits;
+    };
+
+    const std::string file =
+        file_manager->getCachedTexturesDir() + "physics-unit-test.bvh";
+    file_manager->removeFile(file);
+
+    // Build the BVH and save it
+    TriangleMesh *built = create_mesh(20, 0.5f);
+    built->createCollisionShape(/*create_collision_object*/false,
+                                file.c_str());
+    assert(!built->m_bvh_memory);
+    assert(file_manager->fileExists(file));
+    std::set<int> built_hits = cast_rays(built);
+    assert(!built_hits.empty());
+
+    // The same triangles load the BVH from the file
+    TriangleMesh *cached = create_mesh(20, 0.5f);
+    cached->createCollisionShape(/*create_collision_object*/false,
+                                 file.c_str());
+    assert(cached->m_bvh_memory);
+    assert(cast_rays(cached) == built_hits);
+    delete cached;
+    delete built;
+
+    // Different triangles must not use the cache
+    TriangleMesh *other = create_mesh(20, 0.75f);
+    other->createCollisionShape(/*create_collision_object*/false,
+                                file.c_str());
+    assert(!other->m_bvh_memory);
+    delete other;
+
+    // A truncated file is rejected
+    FILE *f = FileUtils::fopenU8Path(file, "wb");
+    fwrite(BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC), 1, f);
+    fclose(f);
+    TriangleMesh *truncated = create_mesh(20, 0.5f);
+    assert(!truncated->loadBvhCache(file, truncated->computeMeshHash()));
+    delete truncated;
+    file_manager->removeFile(file);
+}   // unitTesting
@@ -19,6 +19,8 @@
 #ifndef HEADER_TRIANGLE_MESH_HPP
 #define HEADER_TRIANGLE_MESH_HPP
 
+#include <cstdint>
+#include <string>
 #include <vector>
 #include "btBulletDynamicsCommon.h"
 
@@ -57,6 +59,19 @@ private:
      *  to the current transform of the body. */
     bool m_can_be_transformed;
 
+    /** The content of a BVH cache file if the BVH was loaded from it. The
+     *  BVH is used in place, so this memory is kept until removeAll. */
+    void                        *m_bvh_memory;
+    size_t                       m_bvh_memory_size;
+    /** True if m_bvh_memory is memory mapped (otherwise it's allocated). */
+    bool                         m_bvh_memory_mapped;
+
+    uint64_t        computeMeshHash() const;
+    btOptimizedBvh* loadBvhCache(const std::string &file, uint64_t hash);
+    void            saveBvhCache(const std::string &file, uint64_t hash,
+                                 const btOptimizedBvh *bvh) const;
+    void            freeBvhMemory();
+
 public:
     class RigidBodyTriangleMesh : public btRigidBody
     {
@@ -76,13 +91,15 @@ public:
                      const btVector3 &t3, const btVector3 &n1,
                      const btVector3 &n2, const btVector3 &n3,
                      const Material* m);
-    void createCollisionShape(bool create_collision_object=true, const char* serialized_bhv=NULL);
+    void createCollisionShape(bool create_collision_object=true,
+                              const char* bvh_cache_file=NULL);
     void createPhysicalBody(float friction,
                             btCollisionObject::CollisionFlags flags=
                                (btCollisionObject::CollisionFlags)0,
-                            const char* serializedBhv = NULL);
+                            const char* bvh_cache_file = NULL);
     void removeAll();
     void removeCollisionObject();
+    static void unitTesting();
     btVector3 getInterpolatedNormal(unsigned int index,
                                     const btVector3 &position) const;
     // ------------------------------------------------------------------------
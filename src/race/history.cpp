@@ -18,20 +18,38 @@
 
 #include "race/history.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
 #include <stdio.h>
 
+#include "config/stk_config.hpp"
+#include "config/user_config.hpp"
 #include "io/file_manager.hpp"
+#include "items/item_manager.hpp"
+#include "items/projectile_manager.hpp"
 #include "modes/world.hpp"
 #include "karts/abstract_kart.hpp"
 #include "karts/controller/controller.hpp"
+#include "karts/kart_rewinder.hpp"
+#include "network/network_bit_stream.hpp"
 #include "network/network_config.hpp"
 #include "network/rewind_manager.hpp"
 #include "physics/physics.hpp"
 #include "race/race_manager.hpp"
+#include "tracks/check_manager.hpp"
 #include "tracks/track.hpp"
+#include "tracks/track_object_manager.hpp"
 #include "utils/constants.hpp"
 #include "utils/file_utils.hpp"
 
+/** Version of the binary history format. Version 1 was a text file,
+ *  version 2 had no keyframes. */
+static const uint8_t HISTORY_BINARY_VERSION = 3;
+
+/** Time between two keyframes in seconds. */
+static const float HISTORY_KEYFRAME_INTERVAL = 1.0f;
+
 History* history = 0;
 bool History::m_online_history_replay = false;
 //-----------------------------------------------------------------------------
@@ -40,6 +58,9 @@ bool History::m_online_history_replay = false;
 History::History()
 {
     m_replay_history = false;
+    m_hash_index = 0;
+    m_first_diverging_tick = -1;
+    m_seek_ticks = -1;
 }   // History
 
 //-----------------------------------------------------------------------------
@@ -51,6 +72,8 @@ void History::initRecording()
     allocateMemory();
     m_event_index = 0;
     m_all_input_events.clear();
+    m_state_hashes.clear();
+    m_keyframes.clear();
 }   // initRecording
 
 //-----------------------------------------------------------------------------
@@ -88,11 +111,240 @@ void History::addEvent(int kart_id, PlayerAction pa, int value)
 }   // addEvent
 
 //-----------------------------------------------------------------------------
-/** Sets the kart position and controls to the recorded history value.
- *  \param world_ticks WOrld time in ticks.
- *  \param ticks Number of time steps.
+/** Returns true if updateStateHash needs to be called after each tick: when
+ *  recording with --history-hashes, or when replaying a history which
+ *  contains state hashes. Computing the hash costs time every tick, so it
+ *  is not done in normal races.
  */
-void History::updateReplay(int world_ticks)
+bool History::needsStateHash() const
+{
+    if (m_replay_history)
+        return !m_state_hashes.empty();
+    return UserConfigParams::m_history_state_hashes;
+}   // needsStateHash
+
+//-----------------------------------------------------------------------------
+/** Called after each world tick. When recording it stores the hash of the
+ *  world state, when replaying it compares the hash with the recorded one,
+ *  and logs the first tick at which they differ (which shows
+ *  non-determinism, e.g. after physics or AI changes).
+ *  \param world_ticks World time in ticks.
+ */
+void History::updateStateHash(int world_ticks)
+{
+    if (!m_replay_history)
+    {
+        // Ticks don't increase e.g. while the game is paused
+        if (m_state_hashes.empty() ||
+            m_state_hashes.back().first < world_ticks)
+        {
+            m_state_hashes.emplace_back(world_ticks,
+                (uint32_t)World::getWorld()->computeStateHash());
+        }
+        return;
+    }
+
+    while (m_hash_index < m_state_hashes.size() &&
+           m_state_hashes[m_hash_index].first < world_ticks)
+        m_hash_index++;
+    if (m_first_diverging_tick != -1 ||
+        m_hash_index >= m_state_hashes.size() ||
+        m_state_hashes[m_hash_index].first != world_ticks)
+        return;
+
+    if (m_state_hashes[m_hash_index].second !=
+        (uint32_t)World::getWorld()->computeStateHash())
+    {
+        m_first_diverging_tick = world_ticks;
+        Log::error("History", "State diverges from the recording at ticks "
+            "%d (time %f).", world_ticks,
+            stk_config->ticks2Time(world_ticks));
+    }
+}   // updateStateHash
+
+//-----------------------------------------------------------------------------
+/** Returns true if updateKeyFrame needs to be called after each tick: when
+ *  recording with --history-keyframes, or when replaying a history which
+ *  contains keyframes. The karts are then created as KartRewinder, which
+ *  can save and restore their state. Only linear races can restore the
+ *  state of the world (see World::restoreCompleteState()) for a keyframe.
+ */
+bool History::needsKeyFrames() const
+{
+    if (NetworkConfig::get()->isNetworking() ||
+        !RaceManager::get()->isLinearRaceMode())
+        return false;
+    if (m_replay_history)
+        return !m_keyframes.empty();
+    return UserConfigParams::m_history_keyframes;
+}   // needsKeyFrames
+
+//-----------------------------------------------------------------------------
+/** Called after each world tick. While racing, every
+ *  HISTORY_KEYFRAME_INTERVAL seconds a keyframe is saved. When replaying it
+ *  is discarded again: saving the state rounds the physics values of karts
+ *  and projectiles (see CompressNetworkBody::compress), so a replay must do
+ *  the same at the same ticks as the recording to get the same results.
+ *  \param world_ticks World time in ticks.
+ */
+void History::updateKeyFrame(int world_ticks)
+{
+    if (World::getWorld()->getPhase() != WorldStatus::RACE_PHASE ||
+        world_ticks % stk_config->time2Ticks(HISTORY_KEYFRAME_INTERVAL) != 0)
+        return;
+    // Ticks don't increase e.g. while the game is paused
+    if (!m_replay_history && !m_keyframes.empty() &&
+        m_keyframes.back().m_world_ticks >= world_ticks)
+        return;
+
+    BareNetworkString bns(4 * 1024);
+    saveKeyFrame(&bns);
+    if (m_replay_history)
+        return;
+    KeyFrame keyframe;
+    keyframe.m_world_ticks = world_ticks;
+    keyframe.m_state.assign(bns.getData(), bns.getTotalSize());
+    m_keyframes.push_back(keyframe);
+}   // updateKeyFrame
+
+//-----------------------------------------------------------------------------
+/** Saves the state of the world, the items, all karts and projectiles.
+ *  \param buffer The buffer to write the state to.
+ */
+void History::saveKeyFrame(BareNetworkString* buffer) const
+{
+    World* world = World::getWorld();
+    world->saveCompleteState(buffer, NULL);
+    Track::getCurrentTrack()->getItemManager()->saveKeyFrame(buffer);
+    for (unsigned int i = 0; i < world->getNumKarts(); i++)
+    {
+        KartRewinder* kart = dynamic_cast<KartRewinder*>(world->getKart(i));
+        assert(kart);
+        kart->saveKeyFrame(buffer);
+    }
+    ProjectileManager::get()->saveKeyFrame(buffer);
+}   // saveKeyFrame
+
+//-----------------------------------------------------------------------------
+/** Restores the world from a keyframe, so that the next world update is
+ *  the one for the tick after the keyframe.
+ *  \param keyframe The keyframe to restore.
+ */
+void History::restoreKeyFrame(const KeyFrame& keyframe)
+{
+    World* world = World::getWorld();
+    const int ticks = keyframe.m_world_ticks;
+    world->setTicksForRewind(ticks);
+    BareNetworkString bns(keyframe.m_state.data(),
+                          (int)keyframe.m_state.size());
+    try
+    {
+        world->restoreCompleteState(bns);
+        Track::getCurrentTrack()->getItemManager()->restoreKeyFrame(bns);
+        for (unsigned int i = 0; i < world->getNumKarts(); i++)
+        {
+            KartRewinder* kart =
+                dynamic_cast<KartRewinder*>(world->getKart(i));
+            assert(kart);
+            kart->restoreKeyFrame(&bns);
+        }
+        ProjectileManager::get()->restoreKeyFrame(&bns);
+    }
+    catch (std::exception& e)
+    {
+        Log::error("History", "Can't restore keyframe at ticks %d: %s",
+                   ticks, e.what());
+    }
+
+    // Same as after a rewind, see RewindManager::rewindTo
+    Track::getCurrentTrack()->getCheckManager()->resetAfterRewind();
+    if (ticks >= 1)
+    {
+        world->setTicksForRewind(ticks - 1);
+        Track::getCurrentTrack()->getTrackObjectManager()->resetAfterRewind();
+        world->setTicksForRewind(ticks);
+        Track::getCurrentTrack()->getTrackObjectManager()->resetAfterRewind();
+    }
+    world->setTicksForRewind(ticks + 1);
+
+    // Events and hashes up to the keyframe have been used already
+    m_event_index = 0;
+    while (m_event_index < m_all_input_events.size() &&
+           m_all_input_events[m_event_index].m_world_ticks <= ticks)
+        m_event_index++;
+    m_hash_index = 0;
+    while (m_hash_index < m_state_hashes.size() &&
+           m_state_hashes[m_hash_index].first <= ticks)
+        m_hash_index++;
+    if (m_first_diverging_tick > ticks)
+        m_first_diverging_tick = -1;
+}   // restoreKeyFrame
+
+//-----------------------------------------------------------------------------
+/** Jumps to the given time while replaying a race. The world is restored
+ *  from the last keyframe before that time, unless the replay is already
+ *  past that keyframe (and before the given time), and then the race is
+ *  simulated with the recorded input events till the time is reached.
+ *  Without keyframes only jumping forward is possible. The AI karts are not
+ *  part of a keyframe except for their kart state, so after a jump they can
+ *  act differently than in the recording (which the state hashes show).
+ *  \param world_ticks World time in ticks to jump to.
+ *  \return False if it was not possible to jump to the given time.
+ */
+bool History::seekReplay(int world_ticks)
+{
+    World* world = World::getWorld();
+    if (world->getPhase() != WorldStatus::RACE_PHASE)
+    {
+        Log::warn("History", "Can only jump to another time while racing.");
+        return false;
+    }
+
+    const int now = world->getTicksSinceStart();
+    auto keyframe = std::lower_bound(m_keyframes.begin(), m_keyframes.end(),
+        world_ticks, [](const KeyFrame& kf, int ticks)
+                     { return kf.m_world_ticks < ticks; });
+    if (keyframe != m_keyframes.begin() &&
+        ((keyframe - 1)->m_world_ticks >= now || world_ticks < now))
+    {
+        restoreKeyFrame(*(keyframe - 1));
+    }
+    else if (world_ticks < now)
+    {
+        Log::warn("History", "No keyframe to jump back to ticks %d.",
+                  world_ticks);
+        return false;
+    }
+
+    while (world->getTicksSinceStart() < world_ticks &&
+           world->getPhase() == WorldStatus::RACE_PHASE)
+        replayTick();
+    return true;
+}   // seekReplay
+
+//-----------------------------------------------------------------------------
+/** Simulates one world tick with the recorded input events, the same as the
+ *  main loop does (without graphics), used when jumping to another time.
+ */
+void History::replayTick()
+{
+    World* world = World::getWorld();
+    const int world_ticks = world->getTicksSinceStart();
+    replayEvents(world_ticks);
+    world->updateWorld(1);
+    if (needsStateHash())
+        updateStateHash(world_ticks);
+    if (needsKeyFrames())
+        updateKeyFrame(world_ticks);
+    world->updateTime(1);
+}   // replayTick
+
+//-----------------------------------------------------------------------------
+/** Sets the controls of the karts to all recorded input events up to the
+ *  given time.
+ *  \param world_ticks World time in ticks.
+ */
+void History::replayEvents(int world_ticks)
 {
     World *world = World::getWorld();
 
@@ -107,12 +359,48 @@ void History::updateReplay(int world_ticks)
         kart->getController()->action(ie.m_action, ie.m_value);
         m_event_index++;
     }   // while we have events for current time step.
+}   // replayEvents
+
+//-----------------------------------------------------------------------------
+/** Sets the kart position and controls to the recorded history value.
+ *  \param world_ticks WOrld time in ticks.
+ *  \param ticks Number of time steps.
+ */
+void History::updateReplay(int world_ticks)
+{
+    World *world = World::getWorld();
+
+    // Jump to the time given with --history-seek once the race has started
+    if (m_seek_ticks >= 0 && world->getPhase() == WorldStatus::RACE_PHASE)
+    {
+        if (seekReplay(m_seek_ticks))
+        {
+            Log::info("History", "Jumped to ticks %d.",
+                      world->getTicksSinceStart());
+        }
+        m_seek_ticks = -1;
+        world_ticks = world->getTicksSinceStart();
+    }
+
+    replayEvents(world_ticks);
 
     // Check if we have reached the end of the buffer
     if(m_event_index >= m_all_input_events.size())
     {
         Log::info("History", "Replay finished");
+        if (m_first_diverging_tick != -1)
+        {
+            Log::info("History", "First diverging tick: %d.",
+                      m_first_diverging_tick);
+        }
+        else if (!m_state_hashes.empty())
+        {
+            Log::info("History", "No divergence found in %u state hashes.",
+                      m_hash_index);
+        }
         m_event_index= 0;
+        m_hash_index = 0;
+        m_first_diverging_tick = -1;
         // This is useful to use a reproducable rewind problem:
         // replay it with history, for debugging only
 #undef DO_REWIND_AT_END_OF_HISTORY
@@ -127,21 +415,23 @@ void History::updateReplay(int world_ticks)
 }   // updateReplay
 
 //-----------------------------------------------------------------------------
-/** Saves the history stored in the internal data structures into a file called
- *  history.dat.
+/** Saves the history stored in the internal data structures into a binary
+ *  file called history.dat. Input events and state hashes are bit packed
+ *  (see NetworkBitWriter), with ticks stored relative to the previous
+ *  record. They are followed by the keyframes.
  */
 void History::Save()
 {
     World *world   = World::getWorld();
     if (!world)
         return;
-    FILE *fd = fopen("history.dat","w");
+    FILE *fd = fopen("history.dat","wb");
     if(fd)
         Log::info("History", "Saved in ./history.dat.");
     else
     {
         std::string fn = file_manager->getUserConfigFile("history.dat");
-        fd = FileUtils::fopenU8Path(fn, "w");
+        fd = FileUtils::fopenU8Path(fn, "wb");
         if(fd)
             Log::info("History", "Saved in '%s'.", fn.c_str());
     }
@@ -154,58 +444,220 @@ void History::Save()
     }
 
     const int num_karts = world->getNumKarts();
-    fprintf(fd, "STK-version:      %s\n",   STK_VERSION);
-    fprintf(fd, "History-version:  %d\n",   1);
-    fprintf(fd, "numkarts:         %d\n",   num_karts);
-    fprintf(fd, "numplayers:       %d\n", RaceManager::get()->getNumPlayers());
-    fprintf(fd, "difficulty:       %d\n", RaceManager::get()->getDifficulty());
-    fprintf(fd, "reverse: %c\n", RaceManager::get()->getReverseTrack() ? 'y' : 'n');
-
-    fprintf(fd, "track: %s\n", Track::getCurrentTrack()->getIdent().c_str());
-
     assert(num_karts > 0);
 
-    int k;
-    for(k=0; k<num_karts; k++)
+    BareNetworkString bns(64 * 1024);
+    bns.addUInt8('S').addUInt8('T').addUInt8('K').addUInt8('H')
+        .addUInt8(HISTORY_BINARY_VERSION).encodeString(std::string(STK_VERSION))
+        .addUInt8(num_karts)
+        .addUInt8(RaceManager::get()->getNumPlayers())
+        .addUInt8(RaceManager::get()->getDifficulty())
+        .addUInt8(RaceManager::get()->getReverseTrack() ? 1 : 0)
+        .encodeString(Track::getCurrentTrack()->getIdent())
+        .addUInt32(ItemManager::getRandomSeed());
+    for (int k = 0; k < num_karts; k++)
+        bns.encodeString(world->getKart(k)->getIdent());
+    bns.addUInt32((uint32_t)m_all_input_events.size())
+        .addUInt32((uint32_t)m_state_hashes.size());
+
+    // Ticks are stored relative to the previous event or hash
+    NetworkBitWriter writer(&bns);
+    int prev_ticks = 0;
+    for (const InputEvent &ie : m_all_input_events)
     {
-        fprintf(fd, "model %d: %s\n",k, world->getKart(k)->getIdent().c_str());
-    }
-    fprintf(fd, "count:     %zu\n", m_all_input_events.size());
+        assert(ie.m_action >= 0 && ie.m_action < 16);
+        writer.addVarInt(ie.m_world_ticks - prev_ticks)
+            .addVarUInt(ie.m_kart_index).addBits(ie.m_action, 4);
+        prev_ticks = ie.m_world_ticks;
+        // Most values are either released or fully pressed
+        if (ie.m_value == 0)
+            writer.addBits(0, 2);
+        else if (ie.m_value == Input::MAX_VALUE)
+            writer.addBits(1, 2);
+        else
+            writer.addBits(2, 2).addVarInt(ie.m_value);
+    }   // for ie in m_all_input_events
+    prev_ticks = 0;
+    for (const std::pair<int, uint32_t>& h : m_state_hashes)
+    {
+        writer.addVarInt(h.first - prev_ticks).addBits(h.second, 32);
+        prev_ticks = h.first;
+    }   // for h in m_state_hashes
+    writer.flush();
 
-    for (unsigned int i = 0; i < m_all_input_events.size(); i++)
+    bns.addUInt32((uint32_t)m_keyframes.size());
+    for (const KeyFrame& kf : m_keyframes)
     {
-        fprintf(fd, "%d %d %d %d\n",
-                m_all_input_events[i].m_world_ticks,
-                m_all_input_events[i].m_kart_index,
-                m_all_input_events[i].m_action,
-                m_all_input_events[i].m_value      );
-    }   // for i
+        bns.addUInt32(kf.m_world_ticks)
+            .addUInt32((uint32_t)kf.m_state.size());
+        bns += BareNetworkString(kf.m_state.data(), (int)kf.m_state.size());
+    }
 
-    fprintf(fd, "History file end.\n");
+    if (fwrite(bns.getData(), 1, bns.getBuffer().size(), fd) !=
+        bns.getBuffer().size())
+        Log::error("History", "Could not write history.dat.");
     fclose(fd);
 }   // Save
 
 //-----------------------------------------------------------------------------
-/** Loads a history from history.dat in the current directory.
+/** Loads a history from history.dat in the current directory (or the config
+ *  directory). Both the binary format and the old text format are supported.
  */
 void History::Load()
 {
-    char s[1024], s1[1024];
-    int  n;
-
-    FILE *fd = fopen("history.dat","r");
+    FILE *fd = fopen("history.dat","rb");
     if(fd)
         Log::info("History", "Reading ./history.dat");
     else
     {
         std::string fn = file_manager->getUserConfigFile("history.dat");
-        fd = FileUtils::fopenU8Path(fn, "r");
+        fd = FileUtils::fopenU8Path(fn, "rb");
         if(fd)
             Log::info("History", "Reading '%s'.", fn.c_str());
     }
     if(!fd)
         Log::fatal("History", "Could not open history.dat");
 
+    m_state_hashes.clear();
+    m_keyframes.clear();
+    m_hash_index = 0;
+    m_first_diverging_tick = -1;
+
+    char magic[4];
+    if (fread(magic, 1, 4, fd) == 4 && memcmp(magic, "STKH", 4) == 0)
+        loadBinary(fd);
+    else
+    {
+        rewind(fd);
+        loadText(fd);
+    }
+    fclose(fd);
+}   // Load
+
+//-----------------------------------------------------------------------------
+/** Loads a binary history file (see Save()).
+ *  \param fd The history file.
+ */
+void History::loadBinary(FILE *fd)
+{
+    std::vector<char> data;
+    char buffer[16 * 1024];
+    size_t n;
+    rewind(fd);
+    while ((n = fread(buffer, 1, sizeof(buffer), fd)) > 0)
+        data.insert(data.end(), buffer, buffer + n);
+    BareNetworkString bns(data.data(), (int)data.size());
+    bns.skip(4);   // magic number
+
+    // We need to disable the rewind manager here (otherwise setting the
+    // KartControl data would access the rewind manager).
+    bool rewind_manager_was_enabled = RewindManager::isEnabled();
+    RewindManager::setEnable(false);
+    try
+    {
+        uint8_t version = bns.getUInt8();
+        if (version < 2 || version > HISTORY_BINARY_VERSION)
+        {
+            Log::fatal("History", "Unsupported binary history version %d.",
+                       version);
+        }
+        std::string s;
+        bns.decodeString(&s);
+        if (s != STK_VERSION)
+        {
+            Log::warn("History", "History is version '%s', STK version is "
+                      "'%s'.", s.c_str(), STK_VERSION);
+        }
+        unsigned int num_karts = bns.getUInt8();
+        RaceManager::get()->setNumKarts(num_karts);
+        RaceManager::get()->setNumPlayers(bns.getUInt8());
+        RaceManager::get()->setDifficulty(
+            (RaceManager::Difficulty)bns.getUInt8());
+        RaceManager::get()->setReverseTrack(bns.getUInt8() == 1);
+        bns.decodeString(&s);
+        RaceManager::get()->setTrack(s);
+        // This value doesn't really matter, but should be defined, otherwise
+        // the racing phase can switch to 'ending'
+        RaceManager::get()->setNumLaps(100);
+        // Use the same random seed for items (and rand()) as the recording
+        uint32_t seed = bns.getUInt32();
+        srand(seed);
+        UserConfigParams::m_random_seed = (int)seed;
+
+        m_kart_ident.clear();
+        for (unsigned int i = 0; i < num_karts; i++)
+        {
+            bns.decodeString(&s);
+            m_kart_ident.push_back(s);
+            if (i < RaceManager::get()->getNumPlayers() &&
+                !m_online_history_replay)
+            {
+                RaceManager::get()->setPlayerKart(i, s);
+            }
+        }   // for i < num_karts
+
+        // Each record takes at least one bit, so a corrupted count is
+        // detected before allocating memory for it
+        const uint32_t num_events = bns.getUInt32();
+        const uint32_t num_hashes = bns.getUInt32();
+        if ((uint64_t)num_events + num_hashes > (uint64_t)bns.size() * 8)
+            throw std::out_of_range("Too many history records.");
+        allocateMemory(num_events);
+        m_state_hashes.resize(num_hashes);
+        m_event_index = 0;
+
+        NetworkBitReader reader(&bns);
+        int prev_ticks = 0;
+        for (InputEvent &ie : m_all_input_events)
+        {
+            ie.m_world_ticks = prev_ticks + reader.getVarInt();
+            ie.m_kart_index  = reader.getVarUInt();
+            ie.m_action      = (PlayerAction)reader.getBits(4);
+            switch (reader.getBits(2))
+            {
+            case 0:  ie.m_value = 0;                     break;
+            case 1:  ie.m_value = Input::MAX_VALUE;      break;
+            default: ie.m_value = reader.getVarInt();    break;
+            }
+            prev_ticks = ie.m_world_ticks;
+        }   // for ie in m_all_input_events
+        prev_ticks = 0;
+        for (std::pair<int, uint32_t>& h : m_state_hashes)
+        {
+            h.first  = prev_ticks + reader.getVarInt();
+            h.second = reader.getBits(32);
+            prev_ticks = h.first;
+        }   // for h in m_state_hashes
+        reader.align();
+
+        const uint32_t num_keyframes = version >= 3 ? bns.getUInt32() : 0;
+        for (uint32_t i = 0; i < num_keyframes; i++)
+        {
+            KeyFrame kf;
+            kf.m_world_ticks = bns.getUInt32();
+            const uint32_t size = bns.getUInt32();
+            if (size > bns.size())
+                throw std::out_of_range("Keyframe is too large.");
+            kf.m_state.assign(bns.getCurrentData(), size);
+            bns.skip(size);
+            m_keyframes.push_back(kf);
+        }   // for i < num_keyframes
+        if (bns.size() != 0)
+            throw std::out_of_range("Unexpected data after history records.");
+    }
+    catch (std::out_of_range&)
+    {
+        Log::fatal("History", "history.dat is corrupted.");
+    }
+    RewindManager::setEnable(rewind_manager_was_enabled);
+}   // loadBinary
+
+//-----------------------------------------------------------------------------
+void History::loadText(FILE *fd)
+{
+    char s[1024], s1[1024];
+    int  n;
+
     if (fgets(s, 1023, fd) == NULL)
         Log::fatal("History", "Could not read history.dat.");
 
@@ -307,7 +759,5 @@ void History::Load()
         ie.m_action = (PlayerAction)action;
     }   // for i
     RewindManager::setEnable(rewind_manager_was_enabled);
-
-    fclose(fd);
-}   // Load
+}   // loadText
 
@@ -23,9 +23,13 @@
 #include "input/input.hpp"
 #include "karts/controller/kart_control.hpp"
 
+#include <cstdint>
+#include <cstdio>
 #include <string>
+#include <utility>
 #include <vector>
 
+class BareNetworkString;
 class Kart;
 
 /**
@@ -60,7 +64,44 @@ private:
     /** All input events. */
     std::vector<InputEvent> m_all_input_events;
 
+    /** The hash of the world state (see World::computeStateHash(), only the
+     *  lower 32 bits are stored) for each world tick, used to find the first
+     *  tick at which a replay diverges from the recording. */
+    std::vector<std::pair<int, uint32_t> > m_state_hashes;
+
+    /** Replay only: index of the next state hash to compare. */
+    unsigned int m_hash_index;
+
+    /** Replay only: the first tick at which the state diverged from the
+     *  recording, or -1. */
+    int m_first_diverging_tick;
+
+    // ------------------------------------------------------------------------
+    struct KeyFrame
+    {
+        /** World ticks after whose update the state was saved. */
+        int m_world_ticks;
+        /** The state of the world, items, karts and projectiles. */
+        std::string m_state;
+    };   // KeyFrame
+    // ------------------------------------------------------------------------
+
+    /** Snapshots of the world state (see saveKeyFrame()), which allow a
+     *  replay to jump to any tick without simulating the race from the
+     *  start. */
+    std::vector<KeyFrame> m_keyframes;
+
+    /** Replay only: world ticks to jump to at the next replay update, or
+     *  -1. */
+    int m_seek_ticks;
+
     void  allocateMemory(int size=-1);
+    void  loadBinary(FILE *fd);
+    void  loadText(FILE *fd);
+    void  replayEvents(int world_ticks);
+    void  replayTick();
+    void  saveKeyFrame(BareNetworkString* buffer) const;
+    void  restoreKeyFrame(const KeyFrame& keyframe);
 public:
     static bool m_online_history_replay;
           History        ();
@@ -68,7 +109,12 @@ public:
     void  Save           ();
     void  Load           ();
     void  updateReplay(int world_ticks);
+    bool  seekReplay(int world_ticks);
     void  addEvent(int kart_id, PlayerAction pa, int value);
+    void  updateStateHash(int world_ticks);
+    bool  needsStateHash() const;
+    void  updateKeyFrame(int world_ticks);
+    bool  needsKeyFrames() const;
 
     // -------------------I-----------------------------------------------------
     /** Returns the identifier of the n-th kart. */
@@ -82,6 +128,9 @@ public:
     // ------------------------------------------------------------------------
     /** Set if replay is enabled or not. */
     void  setReplayHistory(bool b) { m_replay_history=b;  }
+    // ------------------------------------------------------------------------
+    /** Sets the world ticks to jump to once the replay has started. */
+    void  setSeekTicks(int ticks) { m_seek_ticks = ticks; }
 };
 
 extern History* history;
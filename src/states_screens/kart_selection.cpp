@@ -23,6 +23,7 @@
 #include "config/player_manager.hpp"
 #include "config/user_config.hpp"
 #include "graphics/irr_driver.hpp"
+#include "graphics/stk_tex_manager.hpp"
 #include <ge_render_info.hpp>
 #include "guiengine/message_queue.hpp"
 #include "guiengine/widgets/bubble_widget.hpp"
@@ -1589,6 +1590,12 @@ void KartSelectionScreen::setKartsFromCurrentGroup()
         tabs->select(DEFAULT_GROUP_NAME, PLAYER_ID_GAME_MASTER);
     }
 
+    // Decode all kart icons in parallel before the ribbon loads them
+    std::vector<std::string> icons;
+    for (unsigned int i = 0; i < karts.size(); i++)
+        icons.push_back(karts.get(i)->getAbsoluteIconFile());
+    STKTexManager::getInstance()->prefetchTextures(icons);
+
     for(unsigned int i=0; i<karts.size(); i++)
     {
         const KartProperties* prop = karts.get(i);
@@ -1617,6 +1624,7 @@ void KartSelectionScreen::setKartsFromCurrentGroup()
     }
 
     w->updateItemDisplay();
+    STKTexManager::getInstance()->clearPrefetchedTextures();
 }
 
 // ----------------------------------------------------------------------------
@@ -286,6 +286,13 @@ void TracksAndGPScreen::buildTrackList()
     }   // for n<track_amount
 
     tracks.insertionSort();
+
+    // Decode all screenshots in parallel before the ribbon loads them
+    std::vector<std::string> screenshots;
+    for (unsigned int i = 0; i < tracks.size(); i++)
+        screenshots.push_back(tracks.get(i)->getScreenshotFile());
+    STKTexManager::getInstance()->prefetchTextures(screenshots);
+
     for (unsigned int i = 0; i < tracks.size(); i++)
     {
         Track *curr = tracks.get(i);
@@ -312,6 +319,7 @@ void TracksAndGPScreen::buildTrackList()
                            IconButtonWidget::ICON_PATH_TYPE_RELATIVE);
 
     tracks_widget->updateItemDisplay();
+    STKTexManager::getInstance()->clearPrefetchedTextures();
     std::random_shuffle( m_random_track_list.begin(), m_random_track_list.end() );
 }   // buildTrackList
 
@@ -25,19 +25,27 @@
 #include "graphics/material_manager.hpp"
 #include "graphics/sp/sp_mesh.hpp"
 #include "graphics/sp/sp_mesh_buffer.hpp"
+#include "graphics/stk_tex_manager.hpp"
 #include "guiengine/engine.hpp"
+#include "io/file_manager.hpp"
 #include "race/race_manager.hpp"
 #include "tracks/arena_node_3d.hpp"
 #include "tracks/drive_node_2d.hpp"
 #include "tracks/drive_node_3d.hpp"
 #include "tracks/track.hpp"
 #include "utils/log.hpp"
+#include "utils/string_utils.hpp"
 
 #include <ICameraSceneNode.h>
+#include <IImage.h>
 #include <ISceneManager.h>
+#include <IVideoDriver.h>
+
+#include <cstring>
 
 #ifndef SERVER_ONLY
 #include <ge_main.hpp>
+#include <ge_texture.hpp>
 #endif
 
 const int Graph::UNKNOWN_SECTOR = -1;
@@ -52,6 +60,7 @@ Graph::Graph()
     m_mesh        = NULL;
     m_mesh_buffer = NULL;
     m_render_target = NULL;
+    m_minimap_from_cache = false;
     m_bb_min      = Vec3( 99999,  99999,  99999);
     m_bb_max      = Vec3(-99999, -99999, -99999);
     memset(m_bb_nodes, 0, 4 * sizeof(int));
@@ -434,6 +443,50 @@ RenderTarget* Graph::makeMiniMap(const core::dimension2du &dimension,
     if (GUIEngine::isNoGraphics()) return NULL;
 #endif
 
+    // Adjust bounding boxes for flags in CTF
+    if (Track::getCurrentTrack()->isCTF() &&
+        RaceManager::get()->getMinorMode() == RaceManager::MINOR_MODE_CAPTURE_THE_FLAG)
+    {
+        Vec3 red_flag = Track::getCurrentTrack()->getRedFlag().getOrigin();
+        Vec3 blue_flag = Track::getCurrentTrack()->getBlueFlag().getOrigin();
+        // In case the flag is placed outside of the graph, we scale it a bit
+        red_flag *= 1.1f;
+        blue_flag *= 1.1f;
+        m_bb_max.max(red_flag);
+        m_bb_max.max(blue_flag);
+        m_bb_min.min(red_flag);
+        m_bb_min.min(blue_flag);
+    }
+
+    // Use a minimap rendered in a previous race if the graph didn't change
+    m_minimap_from_cache = false;
+    std::string cache_file;
+#ifndef SERVER_ONLY
+    cache_file = getMiniMapCacheFile(dimension, fill_color, invert_x_z);
+    if (file_manager->fileExists(cache_file))
+    {
+        // The image is not loaded by STKTexManager, which would resize it
+        // to the maximum texture size (and then it would never match)
+        video::IImage* image = irr_driver->getVideoDriver()
+            ->createImageFromFile(cache_file.c_str());
+        if (image && image->getDimension() == dimension &&
+            image->getColorFormat() == video::ECF_A8R8G8B8)
+        {
+            // GE::createTexture drops the image
+            video::ITexture* texture = STKTexManager::getInstance()
+                ->addTexture(GE::createTexture(image, name));
+            float dx = m_bb_max.getX() - m_bb_min.getX();
+            float dz = m_bb_max.getZ() - m_bb_min.getZ();
+            m_scaling = dimension.Width / (dz > dx ? dz : dx);
+            m_render_target.reset(new TextureRenderTarget(texture));
+            m_minimap_from_cache = true;
+            return m_render_target.get();
+        }
+        if (image)
+            image->drop();
+    }
+#endif
+
     const video::SColor oldClearColor = irr_driver->getClearColor();
     irr_driver->setClearbackBufferColor(video::SColor(0, 255, 255, 255));
     Track::getCurrentTrack()->forceFogDisabled(true);
@@ -458,21 +511,6 @@ RenderTarget* Graph::makeMiniMap(const core::dimension2du &dimension,
     }
 #endif
 
-    // Adjust bounding boxes for flags in CTF
-    if (Track::getCurrentTrack()->isCTF() &&
-        RaceManager::get()->getMinorMode() == RaceManager::MINOR_MODE_CAPTURE_THE_FLAG)
-    {
-        Vec3 red_flag = Track::getCurrentTrack()->getRedFlag().getOrigin();
-        Vec3 blue_flag = Track::getCurrentTrack()->getBlueFlag().getOrigin();
-        // In case the flag is placed outside of the graph, we scale it a bit
-        red_flag *= 1.1f;
-        blue_flag *= 1.1f;
-        m_bb_max.max(red_flag);
-        m_bb_max.max(blue_flag);
-        m_bb_min.min(red_flag);
-        m_bb_min.min(blue_flag);
-    }
-
     Vec3 bb_min = m_bb_min;
     Vec3 bb_max = m_bb_max;
 #ifndef SERVER_ONLY
@@ -564,6 +602,13 @@ RenderTarget* Graph::makeMiniMap(const core::dimension2du &dimension,
     camera->updateAbsolutePosition();
 
     m_render_target->renderToTexture(camera, GUIEngine::getLatestDt());
+    video::IImage* image = m_render_target->createImage();
+    if (image)
+    {
+        irr_driver->getVideoDriver()->writeImageToFile(image,
+            cache_file.c_str());
+        image->drop();
+    }
 
     cleanupDebugMesh();
     irr_driver->removeCameraSceneNode(camera);
@@ -580,6 +625,55 @@ RenderTarget* Graph::makeMiniMap(const core::dimension2du &dimension,
 
 }   // makeMiniMap
 
+// -----------------------------------------------------------------------------
+#ifndef SERVER_ONLY
+/** Returns the file name in the cache directory of a minimap. It contains a
+ *  hash of everything the minimap image depends on, so a changed graph (e.g.
+ *  a new version of the track) or minimap size uses a new file.
+ */
+std::string Graph::getMiniMapCacheFile(const core::dimension2du &dimension,
+                                       const video::SColor &fill_color,
+                                       bool invert_x_z) const
+{
+    std::vector<uint32_t> key =
+    {
+        MINIMAP_CACHE_VERSION, dimension.Width, dimension.Height,
+        fill_color.color, invert_x_z, CVS->isGLSL()
+    };
+    auto add_float = [&key](float f)
+    {
+        uint32_t u;
+        memcpy(&u, &f, sizeof(u));
+        key.push_back(u);
+    };
+    for (unsigned i = 0; i < 3; i++)
+    {
+        add_float(m_bb_min[i]);
+        add_float(m_bb_max[i]);
+    }
+    for (unsigned i = 0; i < m_all_nodes.size(); i++)
+    {
+        if (m_all_nodes[i]->isInvisible())
+            continue;
+        key.push_back(i);
+        for (unsigned j = 0; j < 4; j++)
+        {
+            const Vec3& p = (*m_all_nodes[i])[j];
+            add_float(p.x());
+            add_float(p.y());
+            add_float(p.z());
+        }
+    }
+    // 64-bit FNV-1a of all values
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint32_t value : key)
+        hash = (hash ^ value) * 1099511628211ULL;
+    return file_manager->getCachedTexturesDir() + "minimap-" +
+        Track::getCurrentTrack()->getIdent() + "-" +
+        StringUtils::toString(hash) + ".png";
+}   // getMiniMapCacheFile
+#endif
+
 // -----------------------------------------------------------------------------
 /** Returns the 2d coordinates of a point when drawn on the mini map
  *  texture.
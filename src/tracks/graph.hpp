@@ -90,6 +90,14 @@ private:
     /** The render target used for drawing the minimap. */
     std::unique_ptr<RenderTarget> m_render_target;
 
+    /** True if the minimap was loaded from the cache directory instead of
+     *  being rendered. */
+    bool m_minimap_from_cache;
+
+    /** Increase this if the way minimaps are rendered changes, so that old
+     *  cached minimaps are not used anymore. */
+    static const uint32_t MINIMAP_CACHE_VERSION = 1;
+
     // ------------------------------------------------------------------------
     void createMesh(bool show_invisible=true,
                     bool enable_transparency=false,
@@ -103,6 +111,10 @@ private:
     // ------------------------------------------------------------------------
     void cleanupDebugMesh();
     // ------------------------------------------------------------------------
+    std::string getMiniMapCacheFile(const core::dimension2du &dimension,
+                                    const video::SColor &fill_color,
+                                    bool invert_x_z) const;
+    // ------------------------------------------------------------------------
     virtual bool hasLapLine() const = 0;
     // ------------------------------------------------------------------------
     virtual void differentNodeColor(int n, video::SColor* c) const = 0;
@@ -148,6 +160,9 @@ public:
                               const video::SColor &fill_color,
                               bool invert_x_z);
     // ------------------------------------------------------------------------
+    /** Returns true if the last minimap was loaded from the cache. */
+    bool isMiniMapFromCache() const             { return m_minimap_from_cache; }
+    // ------------------------------------------------------------------------
     void mapPoint2MiniMap(const Vec3 &xyz, Vec3 *out) const;
     // ------------------------------------------------------------------------
     Quad* getQuad(unsigned int i) const
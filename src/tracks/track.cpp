@@ -63,6 +63,7 @@
 #include "network/network_config.hpp"
 #include "network/protocols/game_protocol.hpp"
 #include "network/protocols/server_lobby.hpp"
+#include "network/server_config.hpp"
 #include "physics/physical_object.hpp"
 #include "physics/physics.hpp"
 #include "physics/triangle_mesh.hpp"
@@ -95,6 +96,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <set>
 #include <stdexcept>
 #include <sstream>
 #include <wchar.h>
@@ -110,6 +112,7 @@ using namespace irr;
 const float Track::NOHIT               = -99999.9f;
 bool        Track::m_dont_load_navmesh = false;
 std::atomic<Track*> Track::m_current_track[PT_COUNT];
+Track*      Track::m_kept_track        = NULL;
 
 // ----------------------------------------------------------------------------
 Track::Track(const std::string &filename)
@@ -201,6 +204,7 @@ Track::~Track()
     assert(m_magic_number == 0x17AC3802);
     m_magic_number = 0xDEADBEEF;
 #endif
+    releaseKeptMeshes();
 }   // ~Track
 
 //-----------------------------------------------------------------------------
@@ -314,6 +318,12 @@ void Track::reset()
  */
 void Track::cleanup()
 {
+    // Grab the meshes of this track before the track objects and the
+    // scene nodes drop them, so they stay in irrlicht's mesh cache
+    if (keepMeshesLoaded())
+        keepLoadedMeshes();
+    m_loaded_meshes.clear();
+
     irr_driver->resetSceneComplexity();
     m_physical_object_uid = 0;
 #ifdef USE_RESIZE_CACHE
@@ -420,7 +430,9 @@ void Track::cleanup()
     for (unsigned int i = 0; i < m_detached_cached_meshes.size(); i++)
     {
         irr_driver->dropAllTextures(m_detached_cached_meshes[i]);
-        irr_driver->removeMeshFromCache(m_detached_cached_meshes[i]);
+        if (!keepMeshesLoaded() ||
+            m_detached_cached_meshes[i]->getReferenceCount() == 1)
+            irr_driver->removeMeshFromCache(m_detached_cached_meshes[i]);
     }
     m_detached_cached_meshes.clear();
 
@@ -925,7 +937,11 @@ void Track::createPhysicsModel(unsigned int main_track_count,
     if (for_height_map)
         m_track_mesh->createCollisionShape();
     else
-        m_track_mesh->createPhysicalBody(m_friction);
+    {
+        m_track_mesh->createPhysicalBody(m_friction,
+            (btCollisionObject::CollisionFlags)0,
+            getPhysicsCacheFile().c_str());
+    }
     main_loop->renderGUI(5585);
     if (m_gfx_effect_mesh)
         m_gfx_effect_mesh->createCollisionShape();
@@ -933,6 +949,47 @@ void Track::createPhysicsModel(unsigned int main_track_count,
 
 }   // createPhysicsModel
 
+// -----------------------------------------------------------------------------
+/** Returns the name of the file in which the BVH of the track mesh is
+ *  cached. Building the BVH is one of the most expensive parts of loading a
+ *  track, and the cached one is memory mapped, so it's shared by all
+ *  processes using this track (e.g. several servers on one host). The file
+ *  is validated against the triangles of the track, see TriangleMesh.
+ */
+std::string Track::getPhysicsCacheFile() const
+{
+    return file_manager->getCachedTexturesDir() + "physics-" + m_ident +
+        ".bvh";
+}   // getPhysicsCacheFile
+
+// -----------------------------------------------------------------------------
+/** Appends the files which are read when this track is loaded, so they can
+ *  be read into the file cache before (see FilePrefetcher). This is the asset
+ *  pack of the track if it has one, otherwise all files in the track
+ *  directory, and the cached BVH of the track mesh. This uses irrlicht's
+ *  file system, so it must be called from the main thread.
+ *  \param files The list the files are added to.
+ */
+void Track::getPreloadFiles(std::vector<std::string>* files) const
+{
+    const std::string pack = file_manager->getAssetPack(m_root);
+    if (file_manager->fileExists(pack))
+        files->push_back(pack);
+    else
+    {
+        std::set<std::string> all_files;
+        file_manager->listFiles(all_files, m_root, /*make_full_path*/true);
+        for (const std::string& f : all_files)
+        {
+            if (!file_manager->isDirectory(f))
+                files->push_back(f);
+        }
+    }
+    const std::string bvh = getPhysicsCacheFile();
+    if (file_manager->fileExists(bvh))
+        files->push_back(bvh);
+}   // getPreloadFiles
+
 // -----------------------------------------------------------------------------
 
 
@@ -1203,9 +1260,13 @@ void Track::loadMinimap()
     core::dimension2du mini_map_size = World::getWorld()->getRaceGUI()->getMiniMapSize();
 
     //Use twice the size of the rendered minimap to reduce significantly aliasing
+    uint64_t start = StkTime::getMonoTimeMs();
     m_render_target = Graph::get()->makeMiniMap(mini_map_size * 2,
         "minimap::" + m_ident, video::SColor(127, 255, 255, 255),
         m_minimap_invert_x_z);
+    Log::info("Track", "Minimap %s in %d ms.",
+        Graph::get()->isMiniMapFromCache() ? "loaded from cache" : "rendered",
+        (int)(StkTime::getMonoTimeMs() - start));
 
     updateMiniMapScale();
 #endif
@@ -1319,6 +1380,7 @@ bool Track::loadMainTrack(const XMLNode &root)
     track_node->getHPR(&hpr);
     scene_node->setPosition(xyz);
     scene_node->setRotation(hpr);
+    scene_node->setStatic(true);
     handleAnimatedTextures(scene_node, *track_node);
     m_all_nodes.push_back(scene_node);
 
@@ -1512,6 +1574,7 @@ bool Track::loadMainTrack(const XMLNode &root)
             }
             else
             {
+                scene_node->setStatic(true);
                 if(interaction=="physics-only")
                     m_static_physics_only_nodes.push_back(scene_node);
                 else
@@ -1532,7 +1595,7 @@ bool Track::loadMainTrack(const XMLNode &root)
     }
 
     // Free the tangent (track mesh) after converting to physics
-    if (GUIEngine::isNoGraphics())
+    if (GUIEngine::isNoGraphics() && !keepMeshesLoaded())
         tangent_mesh->freeMeshVertexBuffer();
 
     if (m_track_mesh == NULL)
@@ -1551,13 +1614,61 @@ bool Track::loadMainTrack(const XMLNode &root)
 // ----------------------------------------------------------------------------
 void Track::freeCachedMeshVertexBuffer()
 {
-    if (GUIEngine::isNoGraphics())
+    // Kept meshes are converted to physics again in the next race
+    if (GUIEngine::isNoGraphics() && !keepMeshesLoaded())
     {
         for (unsigned i = 0; i < m_all_cached_meshes.size(); i++)
             m_all_cached_meshes[i]->freeMeshVertexBuffer();
     }
 }   // freeCachedMeshVertexBuffer
 
+// ----------------------------------------------------------------------------
+/** Returns true if the meshes of a track should stay loaded after a race.
+ *  This is used by servers, which often play the same track again (e.g.
+ *  soccer or battle servers), so the next race on it doesn't have to load
+ *  and parse all its models again.
+ */
+bool Track::keepMeshesLoaded()
+{
+    return GUIEngine::isNoGraphics() && ServerConfig::m_keep_track_loaded;
+}   // keepMeshesLoaded
+
+// ----------------------------------------------------------------------------
+/** Grabs all meshes that were loaded for this track, so that they are kept
+ *  in irrlicht's mesh cache till another track is loaded. Meshes kept from
+ *  a previous race on this track were found in the cache, so they are not
+ *  in m_loaded_meshes and are not grabbed again.
+ */
+void Track::keepLoadedMeshes()
+{
+    for (scene::IMesh* mesh : m_loaded_meshes)
+    {
+        mesh->grab();
+        irr_driver->grabAllTextures(mesh);
+        m_kept_meshes.push_back(mesh);
+    }
+    if (!m_kept_meshes.empty())
+        m_kept_track = this;
+}   // keepLoadedMeshes
+
+// ----------------------------------------------------------------------------
+/** Releases the meshes kept by keepLoadedMeshes(), and removes them from
+ *  irrlicht's mesh cache if they are not used anymore.
+ */
+void Track::releaseKeptMeshes()
+{
+    for (scene::IMesh* mesh : m_kept_meshes)
+    {
+        irr_driver->dropAllTextures(mesh);
+        mesh->drop();
+        if (mesh->getReferenceCount() == 1)
+            irr_driver->removeMeshFromCache(mesh);
+    }
+    m_kept_meshes.clear();
+    if (m_kept_track == this)
+        m_kept_track = NULL;
+}   // releaseKeptMeshes
+
 // ----------------------------------------------------------------------------
 /** Handles animated textures.
  *  \param node The scene node for which animated textures are handled.
@@ -1846,6 +1957,18 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
     main_loop->renderGUI(3000);
     m_check_manager = new CheckManager();
     assert(m_all_cached_meshes.size()==0);
+
+    // Only the meshes of one track are kept loaded at a time
+    if (m_kept_track && m_kept_track != this)
+        m_kept_track->releaseKeptMeshes();
+    std::set<scene::IMesh*> meshes_before_loading;
+    scene::IMeshCache* mesh_cache =
+        irr_driver->getSceneManager()->getMeshCache();
+    if (keepMeshesLoaded())
+    {
+        for (unsigned int i = 0; i < mesh_cache->getMeshCount(); i++)
+            meshes_before_loading.insert(mesh_cache->getMeshByIndex(i));
+    }
     if(UserConfigParams::logMemory())
     {
         Log::debug("[memory] Before loading '%s': mesh cache %d "
@@ -1969,8 +2092,11 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
     }
     else
     {
-        // Seed random engine locally
-        uint32_t seed = (uint32_t)StkTime::getTimeSinceEpoch();
+        // Seed random engine locally, or with the command line seed to
+        // make races reproducible
+        uint32_t seed = UserConfigParams::m_random_seed >= 0 ?
+            (uint32_t)UserConfigParams::m_random_seed :
+            (uint32_t)StkTime::getTimeSinceEpoch();
         ItemManager::updateRandomSeed(seed);
         m_item_manager = std::make_shared<ItemManager>();
         powerup_manager->setRandomSeed(seed);
@@ -2114,6 +2240,9 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
 
     // Init all track objects
     m_track_object_manager->init();
+    Log::info("Track", "%u of %u track objects are active.",
+        m_track_object_manager->getNumActiveObjects(),
+        m_track_object_manager->getObjects().size());
     main_loop->renderGUI(5300);
 
 
@@ -2298,6 +2427,20 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
                   "positions might be incorrect.");
     }
 
+    // Karts are loaded after the track, so all new meshes in the cache
+    // belong to this track
+    m_loaded_meshes.clear();
+    if (keepMeshesLoaded())
+    {
+        for (unsigned int i = 0; i < mesh_cache->getMeshCount(); i++)
+        {
+            scene::IMesh* mesh = mesh_cache->getMeshByIndex(i);
+            if (meshes_before_loading.find(mesh) ==
+                meshes_before_loading.end())
+                m_loaded_meshes.push_back(mesh);
+        }
+    }
+
     if (UserConfigParams::logMemory())
     {
         Log::debug("track", "[memory] After loading  '%s': mesh cache %d "
@@ -2938,6 +3081,10 @@ void Track::copyFromMainProcess()
     m_all_cached_meshes.shrink_to_fit();
     m_detached_cached_meshes.clear();
     m_detached_cached_meshes.shrink_to_fit();
+    m_loaded_meshes.clear();
+    m_loaded_meshes.shrink_to_fit();
+    m_kept_meshes.clear();
+    m_kept_meshes.shrink_to_fit();
     m_sky_textures.clear();
     m_sky_textures.shrink_to_fit();
     m_spherical_harmonics_textures.clear();
@@ -2997,7 +3144,8 @@ void Track::initChildTrack()
 
     // We call physics init in child process too
     Physics::get()->init(m_aabb_min, m_aabb_max);
-    m_track_mesh->createPhysicalBody(m_friction);
+    m_track_mesh->createPhysicalBody(m_friction,
+        (btCollisionObject::CollisionFlags)0, getPhysicsCacheFile().c_str());
     m_gfx_effect_mesh->createCollisionShape();
 
     // All child track objects are only cloned if they have physical objects
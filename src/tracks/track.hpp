@@ -178,6 +178,18 @@ private:
       */
     std::vector<scene::IMesh*>      m_detached_cached_meshes;
 
+    /** Meshes which were added to irrlicht's mesh cache while loading this
+     *  track. They are not grabbed, see m_kept_meshes. */
+    std::vector<scene::IMesh*>      m_loaded_meshes;
+
+    /** Meshes of this track which are kept in irrlicht's mesh cache after
+     *  a race, so that the next race on this track does not have to load
+     *  them again. Each mesh is grabbed once. */
+    std::vector<scene::IMesh*>      m_kept_meshes;
+
+    /** The track whose meshes are kept loaded, or NULL. */
+    static Track*                   m_kept_track;
+
     /** A list of all textures loaded by the track, so that they can
      *  be removed from the cache at cleanup time. */
     std::vector<video::ITexture*>   m_all_cached_textures;
@@ -422,6 +434,9 @@ private:
     void loadCurves(const XMLNode &node);
     void handleSky(const XMLNode &root, const std::string &filename);
     void freeCachedMeshVertexBuffer();
+    void keepLoadedMeshes();
+    void releaseKeptMeshes();
+    static bool keepMeshesLoaded();
     void copyFromMainProcess();
     video::IImage* getSkyTexture(std::string path) const;
 public:
@@ -745,6 +760,10 @@ public:
     // ------------------------------------------------------------------------
     void convertTrackToBullet(scene::ISceneNode *node);
     // ------------------------------------------------------------------------
+    std::string getPhysicsCacheFile() const;
+    // ------------------------------------------------------------------------
+    void getPreloadFiles(std::vector<std::string>* files) const;
+    // ------------------------------------------------------------------------
     CheckManager* getCheckManager() const           { return m_check_manager; }
     // ------------------------------------------------------------------------
     ItemManager* getItemManager() const        { return m_item_manager.get(); }
@@ -544,6 +544,43 @@ void TrackObject::update(float dt)
     if (m_animator) m_animator->updateWithWorldTicks(true/*has_physics*/);
 }   // update
 
+// ----------------------------------------------------------------------------
+/** Returns true if update() has any effect on this object, i.e. it has an
+ *  animated or dynamic physical object, or a presentation which needs to be
+ *  updated once per physics time step (e.g. a scripted library node).
+ */
+bool TrackObject::needsUpdate() const
+{
+    if (m_presentation && m_presentation->needsUpdate())
+        return true;
+    if (m_physical_object && (m_animator || m_physical_object->isDynamic()))
+        return true;
+    return false;
+}   // needsUpdate
+
+// ----------------------------------------------------------------------------
+/** Returns true if updateGraphics() has any effect on this object.
+ */
+bool TrackObject::needsUpdateGraphics() const
+{
+    if (m_presentation && m_presentation->needsUpdateGraphics())
+        return true;
+    if (m_physical_object)
+        return m_physical_object->isDynamic();
+    return m_animator != NULL;
+}   // needsUpdateGraphics
+
+// ----------------------------------------------------------------------------
+/** Returns true if the only thing updateGraphics() does for this object is
+ *  moving its scene node with an IPO animation. Such objects can be updated
+ *  less often when they are far away from all cameras.
+ */
+bool TrackObject::hasGraphicalAnimationOnly() const
+{
+    return m_animator && !m_physical_object &&
+        !(m_presentation && m_presentation->needsUpdateGraphics());
+}   // hasGraphicalAnimationOnly
+
 
 // ----------------------------------------------------------------------------
 /** This reset all physical object moved by 3d animation back to current ticks
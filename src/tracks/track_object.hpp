@@ -250,6 +250,12 @@ public:
         return m_parent_library->hasAnimatorRecursively();
     }
     // ------------------------------------------------------------------------
+    bool needsUpdate() const;
+    // ------------------------------------------------------------------------
+    bool needsUpdateGraphics() const;
+    // ------------------------------------------------------------------------
+    bool hasGraphicalAnimationOnly() const;
+    // ------------------------------------------------------------------------
     void setPaused(bool mode){ m_animator->setPaused(mode); }
     // ------------------------------------------------------------------------
     void setInitiallyVisible(bool val)           { m_initially_visible = val; }
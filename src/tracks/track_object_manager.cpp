@@ -21,6 +21,7 @@
 #include "animations/ipo.hpp"
 #include "animations/three_d_animation.hpp"
 #include "config/stk_config.hpp"
+#include "graphics/camera.hpp"
 #include "graphics/lod_node.hpp"
 #include "graphics/material_manager.hpp"
 #include "io/xml_node.hpp"
@@ -32,8 +33,16 @@
 #include <IMeshSceneNode.h>
 #include <ISceneManager.h>
 
+#include <algorithm>
+
+/** Animations further away than this from all cameras are only updated
+ *  every FAR_ANIMATION_UPDATE_RATE frames. */
+static const float FAR_ANIMATION_DISTANCE = 150.0f;
+static const unsigned int FAR_ANIMATION_UPDATE_RATE = 4;
+
 TrackObjectManager::TrackObjectManager()
 {
+    m_graphics_frame = 0;
 }   // TrackObjectManager
 
 // ----------------------------------------------------------------------------
@@ -53,6 +62,7 @@ void TrackObjectManager::add(const XMLNode &xml_node, scene::ISceneNode* parent,
     {
         TrackObject *obj = new TrackObject(xml_node, parent, model_def_loader, parent_library);
         m_all_objects.push_back(obj);
+        addToUpdateLists(obj);
         if(obj->isDriveable())
             m_driveable_objects.push_back(obj);
     }
@@ -63,6 +73,49 @@ void TrackObjectManager::add(const XMLNode &xml_node, scene::ISceneNode* parent,
     }
 }   // add
 
+// ----------------------------------------------------------------------------
+/** Classifies a new object, and adds it to the lists of objects which need
+ *  to be updated each time step and/or each frame. Objects which are in
+ *  neither list (e.g. static meshes) are never updated.
+ *  \param object The new track object.
+ */
+void TrackObjectManager::addToUpdateLists(TrackObject* object)
+{
+    if (object->needsUpdate())
+        m_update_objects.push_back(object);
+    if (object->hasGraphicalAnimationOnly())
+        m_graphical_animations.push_back(object);
+    else if (object->needsUpdateGraphics())
+        m_update_graphics_objects.push_back(object);
+}   // addToUpdateLists
+
+// ----------------------------------------------------------------------------
+void TrackObjectManager::removeFromUpdateLists(TrackObject* object)
+{
+    for (std::vector<TrackObject*>* list :
+        { &m_update_objects, &m_update_graphics_objects,
+          &m_graphical_animations })
+    {
+        list->erase(std::remove(list->begin(), list->end(), object),
+            list->end());
+    }
+}   // removeFromUpdateLists
+
+// ----------------------------------------------------------------------------
+/** Returns the number of track objects which are updated each time step or
+ *  each frame, i.e. which are not static.
+ */
+unsigned int TrackObjectManager::getNumActiveObjects() const
+{
+    unsigned int count = 0;
+    for (const TrackObject* curr : m_all_objects.m_contents_vector)
+    {
+        if (curr->needsUpdate() || curr->needsUpdateGraphics())
+            count++;
+    }
+    return count;
+}   // getNumActiveObjects
+
 // ----------------------------------------------------------------------------
 /** Initialises all track objects.
  */
@@ -175,24 +228,52 @@ void TrackObjectManager::handleExplosion(const Vec3 &pos, const PhysicalObject *
  */
 void TrackObjectManager::updateGraphics(float dt)
 {
-    TrackObject* curr;
-    for_in(curr, m_all_objects)
+    for (TrackObject* curr : m_update_graphics_objects)
+        curr->updateGraphics(dt);
+
+    // Animations use the world time, so skipping frames for far away ones
+    // only makes them less smooth. The updates are spread over the frames.
+    m_graphics_frame++;
+    for (unsigned int i = 0; i < m_graphical_animations.size(); i++)
     {
+        TrackObject* curr = m_graphical_animations[i];
+        if ((m_graphics_frame + i) % FAR_ANIMATION_UPDATE_RATE != 0 &&
+            isFarFromCameras(curr))
+            continue;
         curr->updateGraphics(dt);
     }
 }   // updateGraphics
 
+// ----------------------------------------------------------------------------
+/** Returns true if the object is further away than FAR_ANIMATION_DISTANCE
+ *  from all cameras.
+ */
+bool TrackObjectManager::isFarFromCameras(const TrackObject* object) const
+{
+#ifdef SERVER_ONLY
+    return false;
+#else
+    if (Camera::getNumCameras() == 0)
+        return false;
+    const Vec3 xyz(object->getAbsolutePosition());
+    for (unsigned int i = 0; i < Camera::getNumCameras(); i++)
+    {
+        if ((Camera::getCamera(i)->getXYZ() - xyz).length2() <
+            FAR_ANIMATION_DISTANCE * FAR_ANIMATION_DISTANCE)
+            return false;
+    }
+    return true;
+#endif
+}   // isFarFromCameras
+
 // ----------------------------------------------------------------------------
 /** Updates all track objects.
  *  \param dt Time step size.
  */
 void TrackObjectManager::update(float dt)
 {
-    TrackObject* curr;
-    for_in (curr, m_all_objects)
-    {
+    for (TrackObject* curr : m_update_objects)
         curr->update(dt);
-    }
 }   // update
 
 // ----------------------------------------------------------------------------
@@ -271,6 +352,7 @@ bool TrackObjectManager::castRay(const btVector3 &from,
 void TrackObjectManager::insertObject(TrackObject* object)
 {
     m_all_objects.push_back(object);
+    addToUpdateLists(object);
 }
 
 // ----------------------------------------------------------------------------
@@ -288,5 +370,6 @@ void TrackObjectManager::insertDriveableObject(TrackObject* object)
 void TrackObjectManager::removeObject(TrackObject* obj)
 {
     m_all_objects.remove(obj);
+    removeFromUpdateLists(obj);
     delete obj;
 }   // removeObject
@@ -51,6 +51,26 @@ protected:
     /** A second list which holds all objects that karts can drive on. */
     PtrVector<TrackObject, REF> m_driveable_objects;
 
+    /** Objects which need update() once per physics time step: dynamic or
+     *  animated physical objects and scripted library nodes. Most track
+     *  objects are static decoration and are not in this list. */
+    std::vector<TrackObject*> m_update_objects;
+
+    /** Objects which need updateGraphics() every frame. */
+    std::vector<TrackObject*> m_update_graphics_objects;
+
+    /** Objects whose only per-frame work is a graphical IPO animation. They
+     *  are updated less often when far away from all cameras. */
+    std::vector<TrackObject*> m_graphical_animations;
+
+    /** Counts calls of updateGraphics(), used to spread the updates of far
+     *  away animations over several frames. */
+    unsigned int m_graphics_frame;
+
+    void addToUpdateLists(TrackObject* object);
+    void removeFromUpdateLists(TrackObject* object);
+    bool isFarFromCameras(const TrackObject* object) const;
+
 public:
          TrackObjectManager();
         ~TrackObjectManager();
@@ -74,6 +94,7 @@ public:
     void removeObject(TrackObject* who);
     void removeDriveableObject(TrackObject* obj) { m_driveable_objects.remove(obj); }
     TrackObject* getTrackObject(const std::string& libraryInstance, const std::string& name);
+    unsigned int getNumActiveObjects() const;
 
           PtrVector<TrackObject>& getObjects()       { return m_all_objects; }
     const PtrVector<TrackObject>& getObjects() const { return m_all_objects; }
@@ -599,6 +599,15 @@ void TrackObjectPresentationMesh::init(const XMLNode* xml_node,
         if (track && xml_node)
             track->handleAnimatedTextures(m_node, *xml_node);
         Track::uploadNodeVertexBuffer(m_node);
+
+        // Objects which are neither movable nor animated don't need to be
+        // visited by the scene graph animation pass every frame
+        std::string type;
+        if (xml_node)
+            xml_node->get("type", &type);
+        if (type != "movable" && type != "animation" &&
+            (!xml_node || !xml_node->hasChildNamed("curve")))
+            m_node->setStatic(true);
     }
 
     if(!enabled)
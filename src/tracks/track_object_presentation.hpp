@@ -90,6 +90,13 @@ public:
     }
     virtual void updateGraphics(float dt) {}
     virtual void update(float dt) {}
+    // ------------------------------------------------------------------------
+    /** Returns true if update() does anything for this presentation. */
+    virtual bool needsUpdate() const                          { return false; }
+    // ------------------------------------------------------------------------
+    /** Returns true if updateGraphics() does anything for this presentation.*/
+    virtual bool needsUpdateGraphics() const                  { return false; }
+    // ------------------------------------------------------------------------
     virtual void move(const core::vector3df& xyz, const core::vector3df& hpr,
         const core::vector3df& scale, bool isAbsoluteCoord) {}
 
@@ -200,6 +207,7 @@ public:
         ModelDefinitionLoader& model_def_loader);
     virtual ~TrackObjectPresentationLibraryNode();
     virtual void update(float dt) OVERRIDE;
+    virtual bool needsUpdate() const OVERRIDE                  { return true; }
     virtual void reset() OVERRIDE
     {
         m_reset_executed = false;
@@ -295,6 +303,7 @@ public:
     virtual ~TrackObjectPresentationSound();
     void onTriggerItemApproached(int kart_id);
     virtual void updateGraphics(float dt) OVERRIDE;
+    virtual bool needsUpdateGraphics() const OVERRIDE          { return true; }
     virtual void move(const core::vector3df& xyz, const core::vector3df& hpr,
         const core::vector3df& scale, bool isAbsoluteCoord) OVERRIDE;
     void triggerSound(bool loop);
@@ -325,6 +334,7 @@ public:
                                      scene::ISceneNode* parent);
     virtual ~TrackObjectPresentationBillboard();
     virtual void updateGraphics(float dt) OVERRIDE;
+    virtual bool needsUpdateGraphics() const OVERRIDE          { return true; }
 };   // TrackObjectPresentationBillboard
 
 
@@ -347,6 +357,7 @@ public:
     virtual ~TrackObjectPresentationParticles();
 
     virtual void updateGraphics(float dt) OVERRIDE;
+    virtual bool needsUpdateGraphics() const OVERRIDE          { return true; }
     void triggerParticles();
     void stop();
     void stopIn(double delay);
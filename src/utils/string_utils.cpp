@@ -844,6 +844,40 @@ namespace StringUtils
         return output.str();
     }   // xmlEncode
 
+    // ------------------------------------------------------------------------
+    /** Escapes a (utf8) string to be used as a JSON string value, i.e.
+     *  quotes, backslashes and control characters are escaped.
+     *  \param s The input string which should be encoded.
+     *  \return The string without the enclosing quotes.
+     */
+    std::string jsonEncode(const std::string &s)
+    {
+        std::string output;
+        output.reserve(s.size());
+        for (unsigned i = 0; i < s.size(); i++)
+        {
+            const unsigned char c = s[i];
+            if (c == '"' || c == '\\')
+            {
+                output += '\\';
+                output += c;
+            }
+            else if (c == '\n')
+                output += "\\n";
+            else if (c == '\t')
+                output += "\\t";
+            else if (c < 0x20)
+            {
+                char code[8];
+                snprintf(code, sizeof(code), "\\u%04x", c);
+                output += code;
+            }
+            else
+                output += c;
+        }
+        return output;
+    }   // jsonEncode
+
     // ------------------------------------------------------------------------
 
     std::string wideToUtf8(const wchar_t* input)
@@ -1185,6 +1219,11 @@ namespace StringUtils
         assert(versionToInt("1-beta8"         ) ==  10000018);
         assert(versionToInt("1-rc9"           ) ==  10000029);
         assert(versionToInt("1.0-rc1"         ) ==  10000021);   // same as 1-rc1
+
+        assert(jsonEncode("abc") == "abc");
+        assert(jsonEncode("a\"b\\c") == "a\\\"b\\\\c");
+        assert(jsonEncode("a\nb\x01") == "a\\nb\\u0001");
+        assert(jsonEncode("\xc3\xa9") == "\xc3\xa9");
     }   // unitTesting
     // ------------------------------------------------------------------------
     std::pair<std::string, std::string> extractVersionOS(
@@ -68,6 +68,7 @@ namespace StringUtils
     irr::core::stringw xmlDecode(const std::string& input);
 
     std::string xmlEncode(const irr::core::stringw &output);
+    std::string jsonEncode(const std::string &s);
 
     // ------------------------------------------------------------------------
     template <class T>
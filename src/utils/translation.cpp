@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cerrno>
+#include <chrono>
 #include <clocale>
 #include <cstdio>
 #include <cstdlib>
@@ -591,8 +592,14 @@ Translations::~Translations()
  */
 irr::core::stringw Translations::w_gettext(const wchar_t* original, const char* context)
 {
+#ifdef SERVER_ONLY
+    return L"";
+#else
+    // The converted string is a temporary, so it is not cached
     std::string in = StringUtils::wideToUtf8(original);
-    return w_gettext(in.c_str(), context);
+    if (in.empty()) return L"";
+    return translateToWide(in.c_str(), context);
+#endif
 }   // w_gettext
 
 // ----------------------------------------------------------------------------
@@ -610,6 +617,42 @@ irr::core::stringw Translations::w_gettext(const char* original, const char* con
 
     if (original[0] == '\0') return L"";
 
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    auto it = m_cache.find(std::make_pair(original, context));
+    if (it != m_cache.end())
+    {
+        // The address can be reused by a different (non literal) string
+        const CachedTranslation& ct = it->second;
+        if (ct.m_original == original &&
+            ct.m_has_context == (context != NULL) &&
+            (context == NULL || ct.m_context == context))
+            return ct.m_translation;
+    }
+    else if (m_cache.size() >= 4096)
+    {
+        // Only happens with many temporary strings, keep the memory bounded
+        m_cache.clear();
+    }
+
+    CachedTranslation& ct = m_cache[std::make_pair(original, context)];
+    ct.m_original = original;
+    ct.m_has_context = context != NULL;
+    ct.m_context = context ? context : "";
+    ct.m_translation = translateToWide(original, context);
+    return ct.m_translation;
+#endif
+
+}   // w_gettext
+
+#ifndef SERVER_ONLY
+// ----------------------------------------------------------------------------
+/** Translates a string without using the cache of w_gettext.
+ *  \param original Message to translate, not empty.
+ *  \param context Optional context of the message.
+ */
+irr::core::stringw Translations::translateToWide(const char* original,
+                                                 const char* context)
+{
 #if TRANSLATE_VERBOSE
     Log::info("Translations", "Translating %s", original);
 #endif
@@ -617,8 +660,6 @@ irr::core::stringw Translations::w_gettext(const char* original, const char* con
     const std::string& original_t = (context == NULL ?
                                      m_dictionary->translate(original) :
                                      m_dictionary->translate_ctxt(context, original));
-    // print
-    //for (int n=0;; n+=4)
     const irr::core::stringw wide = StringUtils::utf8ToWide(original_t);
     const wchar_t* out_ptr = wide.c_str();
     if (REMOVE_BOM) out_ptr++;
@@ -628,9 +669,93 @@ irr::core::stringw Translations::w_gettext(const char* original, const char* con
 #endif
 
     return wide;
+}   // translateToWide
 #endif
 
-}   // w_gettext
+// ----------------------------------------------------------------------------
+/** Tests the cache of w_gettext with a temporary dictionary.
+ */
+void Translations::unitTesting()
+{
+#ifndef SERVER_ONLY
+    tinygettext::Dictionary dictionary;
+    dictionary.add_translation("Start", "Starten");
+    dictionary.add_translation("Menu", "Start", "Anfang");
+    tinygettext::Dictionary* saved_dictionary = m_dictionary;
+    m_dictionary = &dictionary;
+    m_cache.clear();
+
+    // A cached translation is returned again
+    const char* start = "Start";
+    assert(w_gettext(start) == L"Starten");
+    assert(w_gettext(start) == L"Starten");
+    assert(m_cache.size() == 1);
+
+    // The context is part of the key
+    assert(w_gettext(start, "Menu") == L"Anfang");
+    assert(w_gettext(start) == L"Starten");
+    assert(m_cache.size() == 2);
+
+    // A different string or context at a reused address is translated again
+    char original[16];
+    strcpy(original, "Start");
+    assert(w_gettext(original) == L"Starten");
+    strcpy(original, "Quit");
+    assert(w_gettext(original) == L"Quit");
+    char context[16];
+    strcpy(context, "Menu");
+    assert(w_gettext(start, context) == L"Anfang");
+    strcpy(context, "Other");
+    assert(w_gettext(start, context) == L"Start");
+
+    // The wide string overload translates without the cache
+    size_t cache_size = m_cache.size();
+    assert(w_gettext(L"Start") == L"Starten");
+    assert(m_cache.size() == cache_size);
+    (void)cache_size;
+    assert(w_gettext("") == L"");
+
+    // The cache stays bounded with many different strings
+    std::vector<std::string> originals;
+    for (int i = 0; i < 5000; i++)
+        originals.push_back(StringUtils::toString(i));
+    for (const std::string& s : originals)
+        w_gettext(s.c_str());
+    assert(m_cache.size() <= 4096);
+    assert(w_gettext(start) == L"Starten");
+    (void)start;
+
+    // Microbenchmark: the strings the race HUD translates each frame, with
+    // and without the cache
+    const char* hud[] = { "Start", "Lap", "Rank", "Ready!", "Set!",
+                          "Go!", "Final lap!", "Race finished",
+                          "Not the best lap time", "New best lap time" };
+    const int frames = 10000;
+    m_cache.clear();
+    auto t0 = std::chrono::steady_clock::now();
+    size_t length = 0;
+    for (int f = 0; f < frames; f++)
+    {
+        for (const char* h : hud)
+            length += w_gettext(h).size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++)
+    {
+        for (const char* h : hud)
+            length += translateToWide(h, NULL).size();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    Log::info("Translations", "HUD strings per frame: %.2f us cached, "
+        "%.2f us uncached (%zu characters).",
+        std::chrono::duration<double, std::micro>(t1 - t0).count() / frames,
+        std::chrono::duration<double, std::micro>(t2 - t1).count() / frames,
+        length);
+
+    m_dictionary = saved_dictionary;
+    m_cache.clear();
+#endif
+}   // unitTesting
 
 // ----------------------------------------------------------------------------
 /**
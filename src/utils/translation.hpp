@@ -21,9 +21,11 @@
 
 #include <irrString.h>
 #include <map>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -64,6 +66,39 @@ private:
     std::string m_current_language_name;
     std::string m_current_language_name_code;
     std::string m_current_language_tag;
+
+    /** A translation cached by w_gettext. The original string and context
+     *  are kept to detect a different string at a reused address. */
+    struct CachedTranslation
+    {
+        std::string        m_original;
+        std::string        m_context;
+        bool               m_has_context;
+        irr::core::stringw m_translation;
+    };
+
+    struct CacheKeyHash
+    {
+        size_t operator()(const std::pair<const char*, const char*>& k) const
+        {
+            return std::hash<const char*>()(k.first) * 31 +
+                   std::hash<const char*>()(k.second);
+        }
+    };
+
+    /** Translated strings indexed by the address of the original string and
+     *  context. _() is nearly always called with string literals, so this
+     *  avoids looking up and converting the same strings each frame. The
+     *  cache belongs to this object, which is recreated when the language
+     *  changes. */
+    std::unordered_map<std::pair<const char*, const char*>,
+                       CachedTranslation, CacheKeyHash> m_cache;
+
+    /** _() is also used from the network threads. */
+    std::mutex m_cache_mutex;
+
+    irr::core::stringw translateToWide(const char* original,
+                                       const char* context);
 #endif
 
 public:
@@ -78,6 +113,8 @@ public:
     irr::core::stringw w_ngettext(const char* singular, const char* plural, int num, const char* context=NULL);
     std::string ngettext(const char* singular, const char* plural, int num, const char* context=NULL);
 
+    void unitTesting();
+
 #ifndef SERVER_ONLY
     const std::vector<std::string>* getLanguageList() const;
 
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+#
+#  SuperTuxKart - a fun racing game with go-kart
+#  Copyright (C) 2026 SuperTuxKart-Team
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 3
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software
+#  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+# Runs many profile races (--profile-laps, --no-graphics) in parallel, one
+# process per core, across tracks, kart sets and random seeds, and combines
+# the json report of each race (--profile-report) into one json file.
+#
+# Example:
+#   batch_profile.py ./supertuxkart --tracks=lighthouse,zengarden \
+#       --karts=nolok*8 --karts=tux,gnu,pidgin --seeds=1-4 --laps=3 \
+#       --output=report.json
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+from concurrent.futures import ThreadPoolExecutor
+
+DEFAULT_TRACKS = ["abyss", "candela_city", "cocoa_temple",
+                  "cornfield_crossing", "fortmagma", "gran_paradiso_island",
+                  "greenvalley", "hacienda", "lighthouse", "mansion", "mines",
+                  "minigolf", "olivermath", "sandtrack", "scotland",
+                  "snowmountain", "snowtuxpeak", "stk_enterprise",
+                  "volcano_island", "xr591", "zengarden"]
+
+# -----------------------------------------------------------------------------
+def parse_karts(s):
+    """Converts 'a,b*3' to 'a,b,b,b' (the format of --aiNP)."""
+    result = []
+    for k in s.split(","):
+        if "*" in k:
+            name, count = k.split("*")
+            result += [name] * int(count)
+        else:
+            result.append(k)
+    return ",".join(result)
+
+# -----------------------------------------------------------------------------
+def parse_seeds(s):
+    """Converts '1-3,7' to [1, 2, 3, 7]."""
+    result = []
+    for part in s.split(","):
+        if "-" in part:
+            first, last = part.split("-")
+            result += range(int(first), int(last) + 1)
+        else:
+            result.append(int(part))
+    return result
+
+# -----------------------------------------------------------------------------
+def run_race(args, track, karts, seed, tmp_dir, index):
+    report = os.path.join(tmp_dir, "report.%d.json" % index)
+    cmd = [args.stk, "--log=0", "-R", "--aiNP=%s" % karts,
+           "--track=%s" % track, "--difficulty=%d" % args.difficulty,
+           "--seed=%d" % seed, "--no-graphics",
+           "--profile-laps=%d" % args.laps, "--profile-report=%s" % report]
+    if args.test_ai:
+        cmd.append("--test-ai=%d" % args.test_ai)
+    result = {"track": track, "karts": karts, "seed": seed}
+    with open(os.path.join(tmp_dir, "stdout.%d" % index), "w") as out:
+        ret = subprocess.call(cmd, stdout=out, stderr=subprocess.STDOUT)
+    try:
+        with open(report) as f:
+            result["report"] = json.load(f)
+    except (IOError, ValueError):
+        result["error"] = "no report, exit code %d" % ret
+    print("%-22s seed %-4d %s" % (track, seed,
+                                  result.get("error", "done")))
+    sys.stdout.flush()
+    return result
+
+# -----------------------------------------------------------------------------
+def summarize(runs):
+    """Combines all races of one track and kart set."""
+    reports = [r["report"] for r in runs if "report" in r]
+    if not reports:
+        return {"races": 0, "failed": len(runs)}
+    lap_times = [t for r in reports for k in r["karts"]
+                 for t in k["lap_times"]]
+    finish_times = [k["finish_time"] for r in reports for k in r["karts"]]
+    return {
+        "races": len(reports),
+        "failed": len(runs) - len(reports),
+        "finish_time_mean": statistics.mean(finish_times),
+        "lap_time_mean": statistics.mean(lap_times) if lap_times else 0,
+        "lap_time_min": min(lap_times) if lap_times else 0,
+        "lap_time_stdev": statistics.pstdev(lap_times) if lap_times else 0,
+        "stuck_count": sum(k["stuck_count"] for r in reports
+                           for k in r["karts"]),
+        "rescue_count": sum(k["rescue_count"] for r in reports
+                            for k in r["karts"]),
+        "tick_time_us_mean": statistics.mean(r["tick_time_us"]["mean"]
+                                             for r in reports),
+        "tick_time_us_p99": max(r["tick_time_us"]["p99"] for r in reports),
+        "tick_time_us_max": max(r["tick_time_us"]["max"] for r in reports),
+    }
+
+# -----------------------------------------------------------------------------
+def main():
+    parser = argparse.ArgumentParser(
+        description="Run AI profile races in parallel and aggregate the "
+                    "results into one json report.")
+    parser.add_argument("stk", help="Path to the supertuxkart executable.")
+    parser.add_argument("--tracks", default=",".join(DEFAULT_TRACKS),
+                        help="Comma separated list of tracks.")
+    parser.add_argument("--karts", action="append",
+                        help="Kart set, e.g. 'nolok*15' or 'tux,gnu'. Can "
+                             "be given several times.")
+    parser.add_argument("--seeds", default="1",
+                        help="Random seeds, e.g. '1-5,10'.")
+    parser.add_argument("--laps", type=int, default=3)
+    parser.add_argument("--difficulty", type=int, default=3)
+    parser.add_argument("--test-ai", type=int, default=0,
+                        help="Passed as --test-ai to supertuxkart.")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(),
+                        help="Number of races to run at the same time.")
+    parser.add_argument("-o", "--output", default="profile_report.json")
+    args = parser.parse_args()
+
+    kart_sets = [parse_karts(k) for k in (args.karts or ["nolok*15"])]
+    tracks = args.tracks.split(",")
+    jobs = [(track, karts, seed) for track in tracks for karts in kart_sets
+            for seed in parse_seeds(args.seeds)]
+
+    with tempfile.TemporaryDirectory(prefix="stk_profile_") as tmp_dir:
+        with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+            futures = [pool.submit(run_race, args, track, karts, seed,
+                                   tmp_dir, i)
+                       for i, (track, karts, seed) in enumerate(jobs)]
+            runs = [f.result() for f in futures]
+
+    summary = []
+    for track in tracks:
+        for karts in kart_sets:
+            s = summarize([r for r in runs if r["track"] == track and
+                           r["karts"] == karts])
+            s.update({"track": track, "karts": karts})
+            summary.append(s)
+
+    with open(args.output, "w") as f:
+        json.dump({"laps": args.laps, "difficulty": args.difficulty,
+                   "summary": summary, "races": runs}, f, indent=1)
+    failed = sum(1 for r in runs if "error" in r)
+    print("%d races, %d failed, report written to %s" %
+          (len(runs), failed, args.output))
+    return 1 if failed else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
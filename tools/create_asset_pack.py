@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+#
+#  SuperTuxKart - a fun racing game with go-kart
+#  Copyright (C) 2026 SuperTuxKart-Team
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 3
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software
+#  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+# This script creates an asset pack (assets.stkpack) for kart or track
+# directories. When a kart or track is loaded, STK memory maps the pack of its
+# directory and reads models, textures and xml files from it instead of
+# opening each file separately. Files which are not in the pack are still
+# read from the directory, so the original files must be kept. A pack is
+# ignored if the directory is modified afterwards (files added, removed or
+# replaced; in artist debug mode also any packed file edited in place), so it
+# must be created again after editing the kart or track.
+#
+# Usage: create_asset_pack.py [--extensions=spm,png,...] DIR [DIR ...]
+#
+# Pack format (all values little endian):
+#   "STKPACK1", u32 version, u32 file count, u32 index size, u32 alignment
+#   index: for each file u32 offset, u32 size, u16 name length, name
+#   data: the uncompressed files, each aligned to the alignment
+
+import os
+import struct
+import sys
+
+PACK_NAME = "assets.stkpack"
+MAGIC = b"STKPACK1"
+VERSION = 1
+ALIGNMENT = 16
+DEFAULT_EXTENSIONS = ["b3d", "spm", "xml", "png", "jpg", "jpeg", "svg"]
+
+# -----------------------------------------------------------------------------
+def findFiles(directory, extensions):
+    files = []
+    for root, dirs, names in os.walk(directory):
+        dirs.sort()
+        for name in sorted(names):
+            if name == PACK_NAME:
+                continue
+            ext = os.path.splitext(name)[1][1:].lower()
+            if ext not in extensions:
+                continue
+            full_path = os.path.join(root, name)
+            files.append(os.path.relpath(full_path, directory)
+                         .replace(os.sep, "/"))
+    return files
+
+# -----------------------------------------------------------------------------
+def align(n):
+    return (n + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+# -----------------------------------------------------------------------------
+def createPack(directory, extensions):
+    files = findFiles(directory, extensions)
+    if not files:
+        print("%s: no files to pack." % directory)
+        return
+
+    names = [f.encode("utf-8") for f in files]
+    sizes = [os.path.getsize(os.path.join(directory, f)) for f in files]
+    index_size = sum(10 + len(n) for n in names)
+
+    offset = align(24 + index_size)
+    offsets = []
+    for size in sizes:
+        offsets.append(offset)
+        offset = align(offset + size)
+    if offset > 0xffffffff:
+        print("%s: too much data for one pack, skipped." % directory)
+        return
+
+    pack_name = os.path.join(directory, PACK_NAME)
+    with open(pack_name + ".tmp", "wb") as pack:
+        pack.write(MAGIC)
+        pack.write(struct.pack("<IIII", VERSION, len(files), index_size,
+                               ALIGNMENT))
+        for name, size, offset in zip(names, sizes, offsets):
+            pack.write(struct.pack("<IIH", offset, size, len(name)))
+            pack.write(name)
+        for f, offset in zip(files, offsets):
+            pack.write(b"\0" * (offset - pack.tell()))
+            with open(os.path.join(directory, f), "rb") as data:
+                pack.write(data.read())
+    os.replace(pack_name + ".tmp", pack_name)
+    # Renaming the pack changes the modification time of the directory, so
+    # touch the pack to make it at least as new as its directory again
+    os.utime(pack_name)
+    print("%s: packed %d files, %d bytes." % (pack_name, len(files),
+                                              os.path.getsize(pack_name)))
+
+# -----------------------------------------------------------------------------
+if __name__ == "__main__":
+    extensions = DEFAULT_EXTENSIONS
+    directories = []
+    for arg in sys.argv[1:]:
+        if arg.startswith("--extensions="):
+            extensions = [e.strip().lower()
+                          for e in arg[len("--extensions="):].split(",")]
+        else:
+            directories.append(arg)
+
+    if not directories:
+        print("Usage: %s [--extensions=%s] DIR [DIR ...]"
+              % (sys.argv[0], ",".join(DEFAULT_EXTENSIONS)))
+        sys.exit(1)
+
+    for d in directories:
+        createPack(d, extensions)